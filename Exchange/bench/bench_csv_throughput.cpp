@@ -0,0 +1,88 @@
+// Throughput over a whole buffer of csv messages, like a replayed order file.
+// Delimiter scan alone and full parsing, per SIMD level, against splitting the lines one by one.
+//
+//   make bench            (or build/bin/bench_csv_throughput [messages])
+
+#include "EventParser.h"
+
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+namespace Exchange {
+
+constexpr std::array<std::string_view, 6> MESSAGES {
+  "D,user123,1001,AAPL,100,BUY,LIMIT,150.25",
+  "D,user456,1002,MSFT,250,SELL,LIMIT,412.10",
+  "D,user123,1003,NVDA,10,BUY,MARKET",
+  "F,user456,1004,AAPL,7",
+  "V,user789,1005,GOOGL",
+  "W,user789,1006,AMZN,5",
+};
+
+void report(const char* name, std::string_view level, std::size_t bytes, std::size_t messages,
+            std::chrono::steady_clock::duration elapsed, std::size_t checksum) {
+  const double seconds = std::chrono::duration<double>(elapsed).count();
+  std::printf("%-22s %-7.*s %9.1f MB/s %8.2f M msgs/s (checksum %zu)\n", name,
+              static_cast<int>(level.size()), level.data(),
+              static_cast<double>(bytes) / seconds / 1e6, static_cast<double>(messages) / seconds / 1e6, checksum);
+}
+
+template <class F>
+void time(const char* name, std::string_view level, const std::string& buffer, std::size_t messages, F&& f) {
+  f();   // warm up
+  const auto start = std::chrono::steady_clock::now();
+  const auto checksum = f();
+  report(name, level, buffer.size(), messages, std::chrono::steady_clock::now() - start, checksum);
+}
+
+} // namespace Exchange
+
+int main(int argc, char** argv) {
+  using namespace Exchange;
+  const std::size_t messages = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 200000;
+
+  std::string buffer;
+  for (std::size_t i = 0; i < messages; ++i) {
+    buffer += MESSAGES[i % MESSAGES.size()];
+    buffer += '\n';
+  }
+
+  const FastCsvEventParser fast;
+  for (auto level : {SimdLevel::Scalar, SimdLevel::Sse42, SimdLevel::Avx2}) {
+    if (!isSupported(level)) {
+      continue;
+    }
+    time("scan", toString(level), buffer, messages, [&] {
+      DelimiterScanner scanner {buffer, level};
+      std::size_t count {0};
+      while (scanner.next() != buffer.size()) {
+        ++count;
+      }
+      return count;
+    });
+    time("parseBuffer", toString(level), buffer, messages, [&] {
+      std::size_t checksum {0};
+      fast.parseBuffer(buffer, [&](Event&& event) { checksum += event.data_.index(); }, level);
+      return checksum;
+    });
+  }
+
+  // one message at a time, lines found with find('\n')
+  auto lineByLine = [&](const EventParser& parser) {
+    std::size_t checksum {0};
+    std::string_view rest {buffer};
+    while (!rest.empty()) {
+      const auto end = rest.find('\n');
+      checksum += parser.parse(rest.substr(0, end)).data_.index();
+      rest.remove_prefix(end == std::string_view::npos ? rest.size() : end + 1);
+    }
+    return checksum;
+  };
+  time("FastCsvEventParser", "lines", buffer, messages, [&] { return lineByLine(fast); });
+  const CsvEventParser csv;
+  time("CsvEventParser", "lines", buffer, messages, [&] { return lineByLine(csv); });
+  return 0;
+}
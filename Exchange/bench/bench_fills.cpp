@@ -0,0 +1,108 @@
+// Cost of reporting fills out of a sweep: one aggressive order taking out `depth` resting orders.
+// Reports ns per fill and heap allocations per sweep, for both book implementations:
+//   fresh vector: the fills pushed into a new vector per aggressive order, what the books built before the FillBuffer
+//   fill buffer:  the book's span over its FillBuffer, as is
+// (a sweep longer than the buffer reaches the sink in pieces, so the baseline overcounts allocations a bit at depth 512)
+//
+//   make bench            (or build/bin/bench_fills [rounds])
+
+#include "OrderBook.h"
+#include "UserRegistry.h"
+#include "LadderOrderBook.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <vector>
+
+namespace {
+  std::size_t allocations = 0;
+}
+
+void* operator new(std::size_t size) {
+  ++allocations;
+  if (void* p = std::malloc(size ? size : 1)) {
+    return p;
+  }
+  throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+namespace Exchange {
+
+// swallows everything, just counts the fills
+struct CountingSink {
+  template <class Fills>
+  bool submitFills(Fills&& fills) { count += std::size(fills); return true; }
+  bool submitAcceptedOrder(OrderAcceptedReport&&) { return true; }
+  bool submitCanceledOrder(OrderCanceledReport&&) { return true; }
+  bool submitTopOfBook(TopOfBookReport&&) { return true; }
+  bool submitDepth(DepthReport&&) { return true; }
+
+  std::size_t count {0};
+};
+
+// the baseline: same sink, but every report goes through a collection grown one fill at a time and moved out
+struct VectorSink : CountingSink {
+  bool submitFills(ExecutionReportView fills) {
+    std::vector<ExecutionReport> collection;
+    for (const auto& report : fills) {
+      collection.push_back(report);
+    }
+    last = std::move(collection);
+    count += last.size();
+    return true;
+  }
+
+  std::vector<ExecutionReport> last;
+};
+
+template <class Book>
+void run(const char* name, Book& book, std::size_t depth, std::size_t rounds) {
+  const auto price = toPrice(150.00, TWO_DIGITS_PRICE_SPEC);
+  OrderId id = 0;
+
+  std::chrono::nanoseconds elapsed {0};
+  std::size_t sweepAllocations = 0;
+  for (std::size_t round = 0; round < rounds; ++round) {
+    for (std::size_t i = 0; i < depth; ++i) {
+      book.submitNewOrder(NewOrderEvent("maker"_uid, ++id, "AAPL"_sym, 10, Side::Sell, Type::Limit, price));
+    }
+    const NewOrderEvent taker("taker"_uid, ++id, "AAPL"_sym, static_cast<Quantity>(depth * 10), Side::Buy, Type::Limit, price);
+
+    const auto before = allocations;
+    const auto start = std::chrono::steady_clock::now();
+    book.submitNewOrder(taker);
+    elapsed += std::chrono::steady_clock::now() - start;
+    sweepAllocations += allocations - before;
+  }
+
+  const double fills = static_cast<double>(depth * rounds);
+  std::printf("%-16s depth %5zu: %8.1f ns/fill, %6.2f allocs/sweep\n", name, depth,
+              static_cast<double>(elapsed.count()) / fills, static_cast<double>(sweepAllocations) / static_cast<double>(rounds));
+}
+
+} // namespace Exchange
+
+int main(int argc, char** argv) {
+  using namespace Exchange;
+  const std::size_t rounds = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 2000;
+
+  for (std::size_t depth : {1, 8, 64, 512}) {
+    OrderBook<VectorSink> baseline(Symbol{"AAPL"}, std::make_unique<VectorSink>());
+    run("OrderBook vector", baseline, depth, rounds);
+    OrderBook<CountingSink> book(Symbol{"AAPL"}, std::make_unique<CountingSink>());
+    run("OrderBook buffer", book, depth, rounds);
+  }
+  for (std::size_t depth : {1, 8, 64, 512}) {
+    const auto reference = toPrice(150.00, TWO_DIGITS_PRICE_SPEC);
+    LadderOrderBook<VectorSink> baseline(Symbol{"AAPL"}, std::make_unique<VectorSink>(), reference);
+    run("Ladder vector", baseline, depth, rounds);
+    LadderOrderBook<CountingSink> book(Symbol{"AAPL"}, std::make_unique<CountingSink>(), reference);
+    run("Ladder buffer", book, depth, rounds);
+  }
+  return 0;
+}
@@ -0,0 +1,152 @@
+// Cost of turning a datagram into an Event: CsvEventParser vs FastCsvEventParser vs BinaryEventParser vs FixEventParser on the same mix of messages.
+// Reports ns per message and heap allocations per message (users are interned before timing).
+// All of them decode side / type / event type through the same toSide / toType / toEventType, so the gaps here are
+// the parsers alone; the token decoding has its own before/after in bench_tokens.
+// Then a flood of bad messages, rejected through parse() and a catch vs tryParse().
+//
+//   make bench            (or build/bin/bench_parser [rounds])
+
+#include "EventParser.h"
+
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace {
+  std::size_t allocations = 0;
+}
+
+void* operator new(std::size_t size) {
+  ++allocations;
+  if (void* p = std::malloc(size ? size : 1)) {
+    return p;
+  }
+  throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+namespace Exchange {
+
+constexpr std::array<std::string_view, 6> MESSAGES {
+  "D,user123,1001,AAPL,100,BUY,LIMIT,150.25",
+  "D,user456,1002,MSFT,250,SELL,LIMIT,412.10",
+  "D,user123,1003,NVDA,10,BUY,MARKET",
+  "F,user456,1004,AAPL,7",
+  "V,user789,1005,GOOGL",
+  "W,user789,1006,AMZN,5",
+};
+
+// the same messages in the binary wire format
+std::vector<std::string> binaryMessages() {
+  std::array<char, 64> buffer {};
+  Binary::Encoder encoder {buffer};
+  std::vector<std::string> messages;
+  auto add = [&](bool) {
+    messages.emplace_back(encoder.data());
+    encoder.clear();
+  };
+  add(encoder.newOrder("user123", 1001, "AAPL", 100, Side::Buy, Type::Limit, Price{15025}));
+  add(encoder.newOrder("user456", 1002, "MSFT", 250, Side::Sell, Type::Limit, Price{41210}));
+  add(encoder.newOrder("user123", 1003, "NVDA", 10, Side::Buy, Type::Market));
+  add(encoder.cancelOrder("user456", 1004, "AAPL", 7));
+  add(encoder.topOfBook("user789", 1005, "GOOGL"));
+  add(encoder.depth("user789", 1006, "AMZN", 5));
+  return messages;
+}
+
+// and as FIX, with the session tags a real sender would put in
+std::vector<std::string> fixMessages() {
+  return {
+    FixEventParser::frame("35=D\x01" "49=user123\x01" "56=EXCH\x01" "34=1\x01" "52=20250101-12:00:00.000\x01" "11=1001\x01" "55=AAPL\x01" "54=1\x01" "38=100\x01" "40=2\x01" "44=150.25\x01" "59=0\x01"),
+    FixEventParser::frame("35=D\x01" "49=user456\x01" "56=EXCH\x01" "34=2\x01" "52=20250101-12:00:00.000\x01" "11=1002\x01" "55=MSFT\x01" "54=2\x01" "38=250\x01" "40=2\x01" "44=412.10\x01" "59=0\x01"),
+    FixEventParser::frame("35=D\x01" "49=user123\x01" "56=EXCH\x01" "34=3\x01" "52=20250101-12:00:00.000\x01" "11=1003\x01" "55=NVDA\x01" "54=1\x01" "38=10\x01" "40=1\x01"),
+    FixEventParser::frame("35=F\x01" "49=user456\x01" "56=EXCH\x01" "34=4\x01" "52=20250101-12:00:00.000\x01" "11=1004\x01" "41=1002\x01" "37=7\x01" "55=AAPL\x01" "54=1\x01"),
+    FixEventParser::frame("35=V\x01" "49=user789\x01" "56=EXCH\x01" "34=5\x01" "52=20250101-12:00:00.000\x01" "262=1005\x01" "263=0\x01" "264=1\x01" "146=1\x01" "55=GOOGL\x01"),
+    FixEventParser::frame("35=V\x01" "49=user789\x01" "56=EXCH\x01" "34=6\x01" "52=20250101-12:00:00.000\x01" "262=1006\x01" "263=0\x01" "264=5\x01" "146=1\x01" "55=AMZN\x01"),
+  };
+}
+
+template <class Messages>
+void run(const char* name, const EventParser& parser, const Messages& messages, std::size_t rounds) {
+  // warm up, also interns the users
+  for (std::string_view message : messages) {
+    parser.parse(message);
+  }
+
+  std::size_t checksum {0};
+  const auto before = allocations;
+  const auto start = std::chrono::steady_clock::now();
+  for (std::size_t round = 0; round < rounds; ++round) {
+    for (std::string_view message : messages) {
+      checksum += parser.parse(message).data_.index();
+    }
+  }
+  const auto elapsed = std::chrono::steady_clock::now() - start;
+  const auto used = allocations - before;
+
+  const double parsed = static_cast<double>(rounds * std::size(messages));
+  std::printf("%-20s %8.1f ns/msg, %6.2f allocs/msg (checksum %zu)\n", name,
+              static_cast<double>(std::chrono::nanoseconds(elapsed).count()) / parsed,
+              static_cast<double>(used) / parsed, checksum);
+}
+
+constexpr std::array<std::string_view, 4> BAD_MESSAGES {
+  "D,user123,1001,AAPL,100,HOLD,LIMIT,150.25",
+  "D,user456,abc,MSFT,250,SELL,LIMIT,412.10",
+  "X,user123,1003,NVDA,10,BUY,MARKET",
+  "D,user123,1004,AAPL,100,BUY,LIMIT,150.255",
+};
+
+void runRejects(const char* name, const EventParser& parser, bool throwing, std::size_t rounds) {
+  std::size_t rejected {0};
+  const auto before = allocations;
+  const auto start = std::chrono::steady_clock::now();
+  for (std::size_t round = 0; round < rounds; ++round) {
+    for (auto message : BAD_MESSAGES) {
+      if (throwing) {
+        try {
+          parser.parse(message);
+        } catch (const std::exception&) {
+          ++rejected;
+        }
+      } else {
+        rejected += parser.tryParse(message).has_value() ? 0 : 1;
+      }
+    }
+  }
+  const auto elapsed = std::chrono::steady_clock::now() - start;
+  const auto used = allocations - before;
+
+  const double parsed = static_cast<double>(rounds * BAD_MESSAGES.size());
+  std::printf("%-20s %8.1f ns/reject, %6.2f allocs/reject (rejected %zu)\n", name,
+              static_cast<double>(std::chrono::nanoseconds(elapsed).count()) / parsed,
+              static_cast<double>(used) / parsed, rejected);
+}
+
+} // namespace Exchange
+
+int main(int argc, char** argv) {
+  using namespace Exchange;
+  const std::size_t rounds = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 200000;
+
+  const CsvEventParser csv;
+  run("CsvEventParser", csv, MESSAGES, rounds);
+  const FastCsvEventParser fast;
+  run("FastCsvEventParser", fast, MESSAGES, rounds);
+  const BinaryEventParser binary;
+  run("BinaryEventParser", binary, binaryMessages(), rounds);
+  const FixEventParser fix;
+  run("FixEventParser", fix, fixMessages(), rounds);
+
+  runRejects("parse() + catch", fast, true, rounds);
+  runRejects("tryParse()", fast, false, rounds);
+  return 0;
+}
@@ -0,0 +1,104 @@
+// Decoding the side / type / event type tokens of a message:
+//   upper copy:  the original, trimAndUpperCopy then == against each name
+//   ignore case: trimView + equalsIgnoreCase chains (what FastCsvEventParser started with)
+//   table:       the perfect hash TokenTables behind toSide / toType / toEventType
+//
+//   make bench            (or build/bin/bench_tokens [rounds])
+
+#include "CommonUtils.h"
+#include "Event.h"
+#include "OrderUtils.h"
+
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string_view>
+
+namespace Exchange {
+
+namespace {
+  Side upperCopySide(std::string_view side) {
+    const auto token = trimAndUpperCopy(side);
+    if (token == "BUY" || token == "1") return Side::Buy;
+    if (token == "SELL" || token == "2") return Side::Sell;
+    return Side::Invalid;
+  }
+
+  Type upperCopyType(std::string_view type) {
+    const auto token = trimAndUpperCopy(type);
+    if (token == "MARKET" || token == "1") return Type::Market;
+    if (token == "LIMIT" || token == "2") return Type::Limit;
+    return Type::Invalid;
+  }
+
+  EventType upperCopyEventType(std::string_view eventType) {
+    const auto token = trimAndUpperCopy(eventType);
+    if (token == "D") return EventType::NewOrder;
+    if (token == "F") return EventType::CancelOrder;
+    if (token == "V") return EventType::TopOfBook;
+    if (token == "W") return EventType::Depth;
+    if (token == "Q" || token == "QUIT") return EventType::Quit;
+    return EventType::Invalid;
+  }
+
+  Side ignoreCaseSide(std::string_view side) {
+    const auto token = trimView(side);
+    if (equalsIgnoreCase(token, "BUY") || token == "1") return Side::Buy;
+    if (equalsIgnoreCase(token, "SELL") || token == "2") return Side::Sell;
+    return Side::Invalid;
+  }
+
+  Type ignoreCaseType(std::string_view type) {
+    const auto token = trimView(type);
+    if (equalsIgnoreCase(token, "MARKET") || token == "1") return Type::Market;
+    if (equalsIgnoreCase(token, "LIMIT") || token == "2") return Type::Limit;
+    return Type::Invalid;
+  }
+
+  EventType ignoreCaseEventType(std::string_view eventType) {
+    const auto token = trimView(eventType);
+    if (equalsIgnoreCase(token, "D")) return EventType::NewOrder;
+    if (equalsIgnoreCase(token, "F")) return EventType::CancelOrder;
+    if (equalsIgnoreCase(token, "V")) return EventType::TopOfBook;
+    if (equalsIgnoreCase(token, "W")) return EventType::Depth;
+    if (equalsIgnoreCase(token, "Q") || equalsIgnoreCase(token, "QUIT")) return EventType::Quit;
+    return EventType::Invalid;
+  }
+
+  // what a message mix looks like, a few misses in there too
+  constexpr std::array<std::string_view, 8> SIDES {"BUY", "SELL", "buy", "1", "2", "Sell", "HOLD", "BUY"};
+  constexpr std::array<std::string_view, 8> TYPES {"LIMIT", "MARKET", "limit", "2", "1", "LIMIT", "STOP", "Market"};
+  constexpr std::array<std::string_view, 8> EVENT_TYPES {"D", "D", "F", "V", "d", "W", "X", "QUIT"};
+
+  template <class DecodeSide, class DecodeType, class DecodeEventType>
+  void run(const char* name, DecodeSide side, DecodeType type, DecodeEventType eventType, std::size_t rounds) {
+    std::size_t checksum {0};
+    const auto start = std::chrono::steady_clock::now();
+    for (std::size_t round = 0; round < rounds; ++round) {
+      for (std::size_t i = 0; i < SIDES.size(); ++i) {
+        // keep the compiler from hoisting the calls out of the loop
+        const auto sideToken = SIDES[(i + round) % SIDES.size()];
+        checksum += static_cast<std::size_t>(side(sideToken));
+        checksum += static_cast<std::size_t>(type(TYPES[i]));
+        checksum += static_cast<std::size_t>(eventType(EVENT_TYPES[i]));
+      }
+    }
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    const double tokens = static_cast<double>(rounds * SIDES.size() * 3);
+    std::printf("%-12s %6.1f ns/token (checksum %zu)\n", name,
+                static_cast<double>(std::chrono::nanoseconds(elapsed).count()) / tokens, checksum);
+  }
+}
+
+} // namespace Exchange
+
+int main(int argc, char** argv) {
+  using namespace Exchange;
+  const std::size_t rounds = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 2000000;
+
+  run("upper copy", upperCopySide, upperCopyType, upperCopyEventType, rounds);
+  run("ignore case", ignoreCaseSide, ignoreCaseType, ignoreCaseEventType, rounds);
+  run("table", toSide, toType, toEventType, rounds);
+  return 0;
+}
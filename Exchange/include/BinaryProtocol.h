@@ -0,0 +1,151 @@
+#ifndef BINARY_PROTOCOL_H
+#define BINARY_PROTOCOL_H
+
+#include <bit>
+#include <cstdint>
+#include <span>
+#include <string_view>
+#include <type_traits>
+
+#include "OrderUtils.h"
+
+// Binary order entry, for senders that don't need to be read by a human.
+//
+// Every message is a fixed size struct, little-endian, no padding the compiler gets to pick:
+// a 4 byte header (total length of the message, header included, and its type) and the body right after it.
+// A datagram carries one or more of them back to back.
+// Strings (user, symbol) are NUL padded, a string that fills its field isn't terminated.
+// Prices are raw ticks in the symbol's PriceSpec, the sender is expected to know it.
+namespace Exchange::Binary {
+
+inline constexpr uint8_t PROTOCOL_VERSION = 1;
+
+enum class MessageType : uint8_t {
+  NewOrder = 1,
+  CancelOrder = 2,
+  TopOfBook = 3,
+  Depth = 4,
+};
+
+// wire values, kept apart from Side/Type so those can change without breaking senders
+enum class WireSide : uint8_t {
+  Buy = 1,
+  Sell = 2,
+};
+
+enum class WireType : uint8_t {
+  Market = 1,
+  Limit = 2,
+};
+
+struct Header {
+  uint16_t length_;
+  MessageType type_;
+  uint8_t version_;
+};
+
+// what every message after the header starts with
+struct OrderFields {
+  int32_t clientOrderId_;
+  char user_[16];
+  char symbol_[8];
+};
+
+struct NewOrderMessage {
+  Header header_;
+  OrderFields order_;
+  int64_t price_;         // ticks, ignored for market orders
+  int32_t quantity_;
+  WireSide side_;
+  WireType type_;
+  uint8_t reserved_[2];
+};
+
+struct CancelOrderMessage {
+  Header header_;
+  OrderFields order_;
+  uint64_t origOrderId_;
+};
+
+struct TopOfBookMessage {
+  Header header_;
+  OrderFields order_;
+};
+
+struct DepthMessage {
+  Header header_;
+  OrderFields order_;
+  uint32_t levels_;       // 0 means MAX_DEPTH_LEVELS
+  uint8_t reserved_[4];
+};
+
+static_assert(sizeof(Header) == 4);
+static_assert(sizeof(NewOrderMessage) == 48);
+static_assert(sizeof(CancelOrderMessage) == 40);
+static_assert(sizeof(TopOfBookMessage) == 32);
+static_assert(sizeof(DepthMessage) == 40);
+static_assert(std::is_trivially_copyable_v<NewOrderMessage> && std::is_trivially_copyable_v<CancelOrderMessage> &&
+              std::is_trivially_copyable_v<TopOfBookMessage> && std::is_trivially_copyable_v<DepthMessage>,
+              "messages are memcpy'd off the wire");
+
+// host <-> wire, a no-op everywhere we actually run
+template <class T>
+requires std::is_integral_v<T>
+constexpr T littleEndian(T value) noexcept {
+  if constexpr (std::endian::native == std::endian::big && sizeof(T) > 1) {
+    return std::byteswap(value);
+  } else {
+    return value;
+  }
+}
+
+// the fixed size a message of this type has on the wire, 0 for an unknown type
+constexpr std::size_t messageSize(MessageType type) noexcept {
+  switch (type) {
+    case MessageType::NewOrder:    return sizeof(NewOrderMessage);
+    case MessageType::CancelOrder: return sizeof(CancelOrderMessage);
+    case MessageType::TopOfBook:   return sizeof(TopOfBookMessage);
+    case MessageType::Depth:       return sizeof(DepthMessage);
+  }
+  return 0;
+}
+
+// a NUL padded field as a view, stops at the first NUL or the end of the field
+template <std::size_t N>
+std::string_view fieldView(const char (&field)[N]) noexcept {
+  std::size_t size = 0;
+  while (size < N && field[size] != '\0') {
+    ++size;
+  }
+  return {field, size};
+}
+
+// Client side: appends messages to a caller owned buffer, one datagram's worth.
+// Never allocates, the append calls return false (and write nothing) when the message doesn't fit.
+// User names and symbols that don't fit their field throw std::invalid_argument.
+class Encoder {
+public:
+  explicit Encoder(std::span<char> buffer) noexcept : buffer_(buffer) {}
+
+  bool newOrder(std::string_view user, OrderId clientOrderId, std::string_view symbol,
+                Quantity quantity, Side side, Type type, Price price = INVALID_PRICE);
+  bool cancelOrder(std::string_view user, OrderId clientOrderId, std::string_view symbol, ExchangeOrderId origOrderId);
+  bool topOfBook(std::string_view user, OrderId clientOrderId, std::string_view symbol);
+  bool depth(std::string_view user, OrderId clientOrderId, std::string_view symbol, uint32_t levels = MAX_DEPTH_LEVELS);
+
+  // what's been written so far, ready to send
+  std::string_view data() const noexcept { return {buffer_.data(), size_}; }
+  std::size_t size() const noexcept { return size_; }
+  void clear() noexcept { size_ = 0; }
+
+private:
+  template <class Message>
+  bool append(const Message& message);
+
+  std::span<char> buffer_;
+  std::size_t size_ {0};
+};
+
+} // namespace Exchange::Binary
+
+#endif // BINARY_PROTOCOL_H
@@ -0,0 +1,82 @@
+#ifndef BOOK_FEED_H
+#define BOOK_FEED_H
+
+#include <atomic>
+#include <concepts>
+#include <cstdint>
+#include <type_traits>
+
+#include <boost/lockfree/spsc_queue.hpp>
+
+#include "OrderUtils.h"
+
+namespace Exchange {
+
+// Market-by-order (L3) delta, one per book mutation.
+//   Add:     order rests on the book with quantity_ open
+//   Execute: quantity_ of the resting order traded at price_, an order that gets to 0 open is gone
+//   Delete:  order canceled, quantity_ is what was still open
+// There's no amend in the book, so no Modify either: an order only ever shrinks through Execute.
+struct BookDelta {
+  enum class Action : uint8_t {
+    Add,
+    Execute,
+    Delete,
+  };
+
+  bool operator==(const BookDelta&) const = default;
+
+  uint64_t sequenceNumber_ {0};         // per symbol, starts at 1, no gaps unless the feed dropped something
+  ExchangeOrderId orderId_ {INVALID_EXCHANGE_ORDER_ID};
+  Price price_ {INVALID_PRICE};
+  Symbol symbol_ {INVALID_SYMBOL};
+  Quantity quantity_ {0};
+  Side side_ {Side::Invalid};
+  Action action_ {Action::Add};
+};
+
+static_assert(std::is_trivially_copyable_v<BookDelta>, "BookDelta goes through lock-free queues");
+
+template <class Feed>
+concept BookFeedConcept = requires(Feed feed, const BookDelta& delta) {
+  { feed.submitDelta(delta) } -> std::same_as<bool>;
+};
+
+// default for books nobody subscribes to, the book doesn't even build the deltas
+struct NoBookFeed {
+  bool submitDelta(const BookDelta&) { return true; }
+};
+
+// Deltas of one book, from the book's shard thread to a single consumer that keeps its own copy of the book.
+// Nothing goes back through the order entry path, the consumer just polls.
+class BookFeed {
+public:
+  static constexpr std::size_t DEFAULT_CAPACITY = 1 << 16;
+
+  explicit BookFeed(std::size_t capacity = DEFAULT_CAPACITY) : queue_(capacity) {}
+
+  // producer side, false (and counted) when the consumer fell behind, it'll see the gap in the sequence numbers
+  bool submitDelta(const BookDelta& delta) {
+    if (queue_.push(delta)) {
+      return true;
+    }
+    dropped_.fetch_add(1, std::memory_order_relaxed);
+    return false;
+  }
+
+  // consumer side, hands every queued delta to f, returns how many
+  template <class F>
+  std::size_t poll(F&& f) {
+    return queue_.consume_all(std::forward<F>(f));
+  }
+
+  uint64_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+
+private:
+  boost::lockfree::spsc_queue<BookDelta> queue_;
+  std::atomic<uint64_t> dropped_ {0};
+};
+
+} // namespace Exchange
+
+#endif // BOOK_FEED_H
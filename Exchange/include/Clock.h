@@ -0,0 +1,92 @@
+#ifndef CLOCK_H
+#define CLOCK_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(__i386__)
+#  include <x86intrin.h>
+#endif
+
+#include "OrderUtils.h"
+
+namespace Exchange {
+
+// steady_clock time off the cpu's timestamp counter: one rdtsc and a multiply instead of a clock_gettime.
+// Calibrated against steady_clock the first time it's used (a 10ms busy wait), call calibrate() up front to keep that
+// off the first stamped message,
+// falls back to steady_clock::now() on cpus without an invariant tsc.
+// Good for stamping and measuring, it drifts from steady_clock slowly so don't mix the two for long intervals.
+class TscClock {
+public:
+  static Timestamp now() noexcept {
+    const auto& calibration = calibrated();
+    if (!calibration.usable_) {
+      return std::chrono::steady_clock::now();
+    }
+    const auto elapsed = static_cast<double>(ticks() - calibration.baseTicks_) * calibration.nsPerTick_;
+    return calibration.base_ + std::chrono::nanoseconds(static_cast<int64_t>(elapsed));
+  }
+
+  // raw counter, 0 where there's none
+  static uint64_t ticks() noexcept {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return 0;
+#endif
+  }
+
+  // false when now() is just steady_clock::now()
+  static bool usesTsc() noexcept { return calibrated().usable_; }
+
+  // does the calibration now if it hasn't happened yet
+  static void calibrate() noexcept { calibrated(); }
+
+private:
+  struct Calibration {
+    bool usable_ {false};
+    uint64_t baseTicks_ {0};
+    Timestamp base_ {};
+    double nsPerTick_ {0.0};
+  };
+
+  static Calibration measure();
+
+  static const Calibration& calibrated() noexcept {
+    static const Calibration calibration = measure();
+    return calibration;
+  }
+};
+
+// Time as of the last update(), for code that reads the time a lot more often than it needs it to move.
+// One thread updates (e.g. once per batch), any number read.
+// Copies take the time as of the copy, so a book holding one stays movable.
+class CoarseClock {
+public:
+  CoarseClock() = default;
+  CoarseClock(const CoarseClock& other) noexcept : now_(other.now_.load(std::memory_order_relaxed)) {}
+  CoarseClock& operator=(const CoarseClock& other) noexcept {
+    now_.store(other.now_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    return *this;
+  }
+
+  Timestamp now() const noexcept {
+    return Timestamp{Timestamp::duration{now_.load(std::memory_order_relaxed)}};
+  }
+
+  void update(Timestamp now = TscClock::now()) noexcept {
+    now_.store(now.time_since_epoch().count(), std::memory_order_relaxed);
+  }
+
+private:
+  std::atomic<Timestamp::rep> now_ {TscClock::now().time_since_epoch().count()};
+};
+
+// what the pipeline stamps events with
+using Clock = TscClock;
+
+} // namespace Exchange
+
+#endif // CLOCK_H
@@ -9,6 +9,11 @@ namespace Exchange {
 std::string trimCopy(std::string_view sv, std::string_view separators = " \t\r\n");
 std::string trimAndUpperCopy(std::string_view sv, std::string_view separators = " \t\r\n");
 
+// same trim without the copy, a view into sv
+std::string_view trimView(std::string_view sv, std::string_view separators = " \t\r\n");
+// ascii only
+bool equalsIgnoreCase(std::string_view a, std::string_view b);
+
 } // namespace Exchange
 
 #endif // COMMON_UTILS_H 
\ No newline at end of file
@@ -0,0 +1,85 @@
+#ifndef DELIMITER_SCAN_H
+#define DELIMITER_SCAN_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace Exchange {
+
+// Finding the ',' and '\n' of csv input a block at a time instead of a char at a time.
+// A kernel turns 64 bytes into a bitmask (bit i set where block[i] is a delimiter),
+// 16 bytes per step with SSE4.2, 32 with AVX2, the best one the cpu has is picked at runtime.
+
+enum class SimdLevel {
+  Scalar,
+  Sse42,
+  Avx2,
+};
+
+inline constexpr std::size_t DELIMITER_BLOCK_SIZE = 64;
+
+using DelimiterMaskFn = uint64_t (*)(const char* block) noexcept;
+
+// best the cpu supports, checked once
+SimdLevel bestSimdLevel() noexcept;
+bool isSupported(SimdLevel level) noexcept;
+// the scalar kernel if the cpu doesn't support level
+DelimiterMaskFn delimiterMaskFn(SimdLevel level = bestSimdLevel()) noexcept;
+std::string_view toString(SimdLevel level) noexcept;
+
+// one line of a buffer and where its fields end, as found by DelimiterScanner
+struct SplitLine {
+  static constexpr std::size_t MAX_FIELDS = 16;   // anything after that ends up in the last field
+
+  std::size_t size() const noexcept { return fields_; }
+
+  std::string_view field(std::size_t i) const noexcept {
+    const std::size_t begin = i == 0 ? 0 : ends_[i - 1] + 1;
+    return line_.substr(begin, ends_[i] - begin);
+  }
+
+  std::string_view line_;
+  std::array<uint32_t, MAX_FIELDS> ends_ {};   // relative to line_, so field i is [ends_[i - 1] + 1, ends_[i])
+  std::size_t fields_ {0};
+};
+
+// Walks the delimiters of a buffer in order, one kernel call per 64 bytes.
+// Doesn't copy the buffer (except the last partial block) and doesn't allocate.
+class DelimiterScanner {
+public:
+  explicit DelimiterScanner(std::string_view buffer, SimdLevel level = bestSimdLevel()) noexcept
+    : buffer_(buffer), maskFn_(delimiterMaskFn(level)) {}
+
+  // position of the next ',' or '\n', buffer.size() once there are none left
+  std::size_t next() noexcept {
+    while (mask_ == 0) {
+      if (nextBlock_ >= buffer_.size()) {
+        return buffer_.size();
+      }
+      loadBlock();
+    }
+    const auto position = blockStart_ + static_cast<std::size_t>(__builtin_ctzll(mask_));
+    mask_ &= mask_ - 1;
+    return position;
+  }
+
+  // the next '\n' separated line, false at the end of the buffer
+  // (a last line without the '\n' still counts, '\r' is left to the field trimming)
+  bool nextLine(SplitLine& line) noexcept;
+
+private:
+  void loadBlock() noexcept;
+
+  std::string_view buffer_;
+  DelimiterMaskFn maskFn_;
+  std::size_t blockStart_ {0};
+  std::size_t nextBlock_ {0};
+  uint64_t mask_ {0};
+  std::size_t lineStart_ {0};
+};
+
+} // namespace Exchange
+
+#endif // DELIMITER_SCAN_H
@@ -11,6 +11,7 @@ enum class EventType {
     NewOrder,
     CancelOrder,
     TopOfBook,
+    Depth,
 
     Quit,
 
@@ -41,17 +42,25 @@ class OrderEvent {
     Symbol symbol() const {
       return symbol_;
     }
+    SymbolId symbolId() const {
+      return symbolId_;
+    }
 
     Timestamp timestamp() const noexcept {
       return timestamp_;
     }
 
+    bool operator==(const OrderEvent&) const = default;
+
   public:
     UserId userId_ {INVALID_USER_ID};
+    // resolved from symbol_ by the parser, INVALID_SYMBOL_ID if nobody did
+    SymbolId symbolId_ {INVALID_SYMBOL_ID};
     OrderId clientOrderId_ {};
     Symbol symbol_ {};
 
-    Timestamp timestamp_ {std::chrono::steady_clock::now()};
+    // stamped at ingress (Exchange::processEvent), not here, so building an event never reads the clock
+    Timestamp timestamp_ {};
 };
 
 class NewOrderEvent : public OrderEvent<NewOrderEvent> {
@@ -76,6 +85,8 @@ class NewOrderEvent : public OrderEvent<NewOrderEvent> {
       return price_;
     }
 
+    bool operator==(const NewOrderEvent&) const = default;
+
   public:
       Quantity quantity_ {INVALID_QUANTITY};
       Side side_ {Side::Invalid};
@@ -85,18 +96,21 @@ class NewOrderEvent : public OrderEvent<NewOrderEvent> {
 
 class CancelOrderEvent : public OrderEvent<CancelOrderEvent> {
   public:
-    CancelOrderEvent(UserId userId, OrderId clientOrderId, Symbol symbol, OrderId origOrderId) noexcept;
+    CancelOrderEvent(UserId userId, OrderId clientOrderId, Symbol symbol, ExchangeOrderId origOrderId) noexcept;
 
     EventType eventType() const noexcept {
       return EventType::CancelOrder;
     }
 
-    OrderId origOrderId() const {
+    // exchange id of the order to cancel (from the OrderAcceptedReport)
+    ExchangeOrderId origOrderId() const {
       return origOrderId_;
     }
 
+    bool operator==(const CancelOrderEvent&) const = default;
+
   public:
-    OrderId origOrderId_ {};
+    ExchangeOrderId origOrderId_ {};
 };
 
 class TopOfBookEvent : public OrderEvent<TopOfBookEvent> {
@@ -107,6 +121,27 @@ class TopOfBookEvent : public OrderEvent<TopOfBookEvent> {
       return EventType::TopOfBook;
     }
 
+    bool operator==(const TopOfBookEvent&) const = default;
+
+};
+
+class DepthEvent : public OrderEvent<DepthEvent> {
+  public:
+    DepthEvent(UserId userId, OrderId clientOrderId, Symbol symbol, uint32_t levels = MAX_DEPTH_LEVELS) noexcept;
+
+    EventType eventType() const noexcept {
+      return EventType::Depth;
+    }
+
+    // levels per side, capped at MAX_DEPTH_LEVELS
+    uint32_t levels() const {
+      return levels_;
+    }
+
+    bool operator==(const DepthEvent&) const = default;
+
+  public:
+    uint32_t levels_ {MAX_DEPTH_LEVELS};
 };
 
 class QuitEvent {
@@ -115,10 +150,11 @@ class QuitEvent {
       return EventType::Quit;
     }
 
+    bool operator==(const QuitEvent&) const = default;
 };
 
 
-using EventVariant = std::variant<std::monostate, NewOrderEvent, CancelOrderEvent, TopOfBookEvent, QuitEvent>;
+using EventVariant = std::variant<std::monostate, NewOrderEvent, CancelOrderEvent, TopOfBookEvent, DepthEvent, QuitEvent>;
 
 template <class T>
 concept HasSymbol = requires (const T& event) {
@@ -139,6 +175,8 @@ struct Event {
   
   Event() = default;
 
+  bool operator==(const Event&) const = default;
+
       Symbol symbol() const {
     auto visitor = [](auto&& event) {
       using T = std::decay_t<decltype(event)>;
@@ -155,11 +193,47 @@ struct Event {
     return std::visit(visitor, data_);
   }
 
+  SymbolId symbolId() const {
+    return std::visit([](auto&& event) {
+      if constexpr (HasSymbol<std::decay_t<decltype(event)>>) {
+        return event.symbolId();
+      } else {
+        return INVALID_SYMBOL_ID;
+      }
+    }, data_);
+  }
+
+  void setTimestamp(Timestamp timestamp) {
+    std::visit([timestamp](auto& event) {
+      if constexpr (HasSymbol<std::decay_t<decltype(event)>>) {
+        event.timestamp_ = timestamp;
+      }
+    }, data_);
+  }
+
+  void setUserId(UserId userId) {
+    std::visit([userId](auto& event) {
+      if constexpr (HasSymbol<std::decay_t<decltype(event)>>) {
+        event.userId_ = userId;
+      }
+    }, data_);
+  }
+
+  void setSymbolId(SymbolId symbolId) {
+    std::visit([symbolId](auto& event) {
+      if constexpr (HasSymbol<std::decay_t<decltype(event)>>) {
+        event.symbolId_ = symbolId;
+      }
+    }, data_);
+  }
+
       // Symbol symbol_ {INVALID_SYMBOL};
   EventVariant data_ {};
 };
 
 static_assert(std::is_trivially_copyable_v<Event>, "Event must be trivially copyable so we can use boost lockfree queues");
+// every queue slot is an Event, user ids are interned handles so this stays within one cache line
+static_assert(sizeof(Event) <= 64, "Event should fit in a cache line");
 
 EventType toEventType(std::string_view eventType);
 std::string toString(EventType eventType);
@@ -1,11 +1,19 @@
 #ifndef EVENT_PARSER_H
 #define EVENT_PARSER_H
 
+#include <array>
+#include <atomic>
+#include <expected>
 #include <string>
 #include <memory>
+#include <span>
+#include "BinaryProtocol.h"
 #include "Event.h"
 #include "OrderUtils.h"
 #include "CommonUtils.h"
+#include "DelimiterScan.h"
+#include "SymbolRegistry.h"
+#include "UserRegistry.h"
 
 #ifdef UNIT_TESTS
 #  include <gtest/gtest_prod.h>
@@ -17,18 +25,96 @@
 
 namespace Exchange {
 
+// why a message got rejected, what tryParse() returns instead of throwing
+enum class ParseError : uint8_t {
+  Malformed,            // nothing more specific, e.g. a parser that still throws
+  UnknownEventType,
+  MissingField,
+  InvalidNumber,
+  InvalidSide,
+  InvalidType,
+  InvalidPrice,
+  InvalidDepth,
+  InvalidLength,        // binary/FIX: shorter than a header, or not the length the header says
+  UnsupportedVersion,
+  BadCheckSum,
+  UnexpectedField,      // FIX: header tags out of place or repeated, more than one symbol
+  TooManyUsers,         // a new user name and the UserRegistry is full
+};
+
+inline constexpr std::size_t PARSE_ERROR_COUNT = static_cast<std::size_t>(ParseError::TooManyUsers) + 1;
+
+std::string_view toString(ParseError error) noexcept;
+
+using ParseResult = std::expected<Event, ParseError>;
+
 class EventParser {
 public:
+  struct BatchResult {
+    void reject(ParseError error) noexcept {
+      ++rejected_;
+      ++errors_[static_cast<std::size_t>(error)];
+    }
+
+    std::size_t events_ {0};     // parsed, written to the front of out
+    std::size_t rejected_ {0};   // lines that didn't parse, skipped
+    std::size_t consumed_ {0};   // bytes of the payload used up, less than all of it if out filled up
+    std::array<uint32_t, PARSE_ERROR_COUNT> errors_ {};   // rejected_ by reason
+  };
 
   virtual ~EventParser() = default;
 
   virtual EventType getEventType(std::string_view event) const = 0;
+  // throws on anything it can't parse
   virtual Event parse(std::string_view event) const = 0;
+  // Same without exceptions, the event type is decoded once and a bad message costs no unwind or allocation.
+  // The default one wraps parse(), every exception is a ParseError::Malformed.
+  virtual ParseResult tryParse(std::string_view event) const;
+
+  // A payload of '\n' separated messages (one datagram can carry a burst of them) parsed into out.
+  // Blank lines are skipped, call again with the rest of the payload if out filled up.
+  // The default one splits the lines itself and tryParse()s them one by one.
+  virtual BatchResult parseBatch(std::string_view payload, std::span<Event> out) const;
+};
+
+// Messages rejected at ingress, by reason. Bumped by the thread that parses, read from anywhere.
+class RejectCounters {
+public:
+  void add(const EventParser::BatchResult& result) noexcept {
+    if (result.rejected_ == 0) {
+      return;
+    }
+    for (std::size_t i = 0; i < PARSE_ERROR_COUNT; ++i) {
+      if (result.errors_[i] != 0) {
+        counts_[i].fetch_add(result.errors_[i], std::memory_order_relaxed);
+      }
+    }
+  }
+
+  uint64_t count(ParseError error) const noexcept {
+    return counts_[static_cast<std::size_t>(error)].load(std::memory_order_relaxed);
+  }
+
+  uint64_t total() const noexcept {
+    uint64_t total {0};
+    for (const auto& count : counts_) {
+      total += count.load(std::memory_order_relaxed);
+    }
+    return total;
+  }
+
+private:
+  std::array<std::atomic<uint64_t>, PARSE_ERROR_COUNT> counts_ {};
 };
 
 
 class CsvEventParser : public EventParser {
 public:
+    // user names are interned into users, events only carry the handle
+    // symbols are resolved against symbols, events carry both the Symbol and its SymbolId
+    explicit CsvEventParser(UserRegistry& users = UserRegistry::global(),
+                            const SymbolRegistry& symbols = SymbolRegistry::global())
+      : users_(&users), symbols_(&symbols) {}
 
     EventType getEventType(std::string_view event) const override; 
     // parses a csv in the format:[D, UserID, ClinetOrderId, Symbol, Quantity, Side, Type, [Price]]
@@ -40,6 +126,20 @@ public:
       good place to play around with ranges and whatnot so ...  
   */
   private:
+    // throws once the registry is full, like the rest of the csv parser does
+    UserId internUser(std::string_view user) const {
+      const auto userId = users_->intern(user);
+      if (userId == INVALID_USER_ID) {
+        throw std::runtime_error("Too many users: " + std::string(user));
+      }
+      return userId;
+    }
+
+    // the only place the symbol gets looked up, routing downstream goes by the id
+    static Event withSymbolId(Event event, SymbolId symbolId) {
+      event.setSymbolId(symbolId);
+      return event;
+    }
 
     template <class It, class Sentinel>
     requires std::input_iterator<It> &&
@@ -53,7 +153,8 @@ public:
       if (++it == last) {
         throw std::runtime_error("Not enough tokens in event: Only parsed up to the Order type: ");
       }
-      auto userId = UserId(trimCopy(*it));
+      // interned once the whole message has parsed, a rejected one mustn't grow the registry
+      auto user = trimCopy(*it);
       if (++it == last) {
         throw std::runtime_error("Not enough tokens in event: Only parsed up to the UserID: ");
       }
@@ -62,6 +163,7 @@ public:
         throw std::runtime_error("Not enough tokens in event: Only parsed up to the ClientOrderId: ");
       }
       auto symbol = Symbol(trimCopy(*it));
+      auto symbolId = symbols_->find(symbol);
       if (++it == last) {
         throw std::runtime_error("Not enough tokens in event: Only parsed up to the Symbol: ");
       }
@@ -85,10 +187,10 @@ public:
         if (++it == last) {
           throw std::runtime_error("Not enough tokens in event: Price missing for Limit order: ");
         }
-        price = toPrice(std::stod(trimCopy(*it)), TWO_DIGITS_PRICE_SPEC);
+        price = parsePrice(trimCopy(*it), symbols_->priceSpec(symbolId));
       }
 
-      return Event{std::in_place_type<NewOrderEvent>, userId, clientOrderId, symbol, quantity, side, type, price};
+      return withSymbolId(Event{std::in_place_type<NewOrderEvent>, internUser(user), clientOrderId, symbol, quantity, side, type, price}, symbolId);
     }
 
     Event
@@ -115,7 +217,7 @@ public:
       if (++it == last) {
         throw std::runtime_error("Not enough tokens in event: Only parsed up to the Order type");
       }
-      auto userId = UserId(trimCopy(*it));
+      auto user = trimCopy(*it);
       if (++it == last) {
         throw std::runtime_error("Not enough tokens in event: Only parsed up to the UserID");
       }
@@ -127,9 +229,9 @@ public:
       if (++it == last) {
         throw std::runtime_error("Not enough tokens in event: Only parsed up to the Symbol");
       }
-      auto origOrderId = std::stoi(trimCopy(*it));
+      ExchangeOrderId origOrderId = std::stoull(trimCopy(*it));
 
-      return Event{std::in_place_type<CancelOrderEvent>, userId, clientOrderId, symbol, origOrderId};
+      return withSymbolId(Event{std::in_place_type<CancelOrderEvent>, internUser(user), clientOrderId, symbol, origOrderId}, symbols_->find(symbol));
     }
 
     template<std::ranges::input_range Range>
@@ -154,7 +256,7 @@ public:
       if (++it == last) {
         throw std::runtime_error("Not enough tokens in event: Only parsed up to the Order type");
       }
-      auto userId = UserId(trimCopy(*it));
+      auto user = trimCopy(*it);
       if (++it == last) {
         throw std::runtime_error("Not enough tokens in event: Only parsed up to the UserID");
       }
@@ -164,7 +266,7 @@ public:
       }
       auto symbol = Symbol(trimCopy(*it));
       
-      return Event{std::in_place_type<TopOfBookEvent>, userId, clientOrderId, symbol};
+      return withSymbolId(Event{std::in_place_type<TopOfBookEvent>, internUser(user), clientOrderId, symbol}, symbols_->find(symbol));
     }
 
     template<std::ranges::input_range Range>
@@ -178,6 +280,50 @@ public:
       return createTopOfBookEvent(il.begin(), il.end());
     }
 
+    // W, UserID, ClientOrderId, Symbol, [Levels]
+    template <class It, class Sentinel>
+    requires std::input_iterator<It> &&
+            std::sentinel_for<Sentinel, It> &&
+            std::convertible_to<std::iter_reference_t<It>, std::string_view>
+    Event createDepthEvent(It it, Sentinel last) const {
+      if (toEventType(*it) != EventType::Depth) {
+        throw std::runtime_error("Invalid event type: " + std::string(*it));
+      }
+      if (++it == last) {
+        throw std::runtime_error("Not enough tokens in event: Only parsed up to the Order type");
+      }
+      auto user = trimCopy(*it);
+      if (++it == last) {
+        throw std::runtime_error("Not enough tokens in event: Only parsed up to the UserID");
+      }
+      auto clientOrderId = std::stoi(trimCopy(*it));
+      if (++it == last) {
+        throw std::runtime_error("Not enough tokens in event: Only parsed up to the ClientOrderId");
+      }
+      auto symbol = Symbol(trimCopy(*it));
+      uint32_t levels = MAX_DEPTH_LEVELS;
+      if (++it != last) {
+        auto requested = std::stoi(trimCopy(*it));
+        if (requested <= 0) {
+          throw std::runtime_error("Invalid number of depth levels: " + std::string(*it));
+        }
+        levels = static_cast<uint32_t>(requested);
+      }
+
+      return withSymbolId(Event{std::in_place_type<DepthEvent>, internUser(user), clientOrderId, symbol, levels}, symbols_->find(symbol));
+    }
+
+    template<std::ranges::input_range Range>
+    requires std::same_as<std::ranges::range_value_t<Range>, std::string>
+    Event createDepthEvent(Range&& r) const {
+      return createDepthEvent(std::ranges::begin(r), std::ranges::end(r));
+    }
+
+    Event
+    createDepthEvent(std::initializer_list<std::string_view> il) const {
+      return createDepthEvent(il.begin(), il.end());
+    }
+
     template <class It, class Sentinel>
     requires std::input_iterator<It> &&
             std::sentinel_for<Sentinel, It> &&
@@ -202,6 +348,8 @@ public:
     }
 
 
+    UserRegistry* users_;
+    const SymbolRegistry* symbols_;
 
 #ifdef UNIT_TESTS
 
@@ -214,6 +362,127 @@ public:
 
 };
 
+// Same format and same Events as CsvEventParser, without the allocations:
+// one pass over the line, every field is a trimmed string_view into it and numbers go through from_chars.
+// tryParse() never throws or allocates (but the first time it sees a user), parse() throws what it returns.
+// Quoted fields are unquoted, but escapes inside them aren't supported (nothing we parse needs them).
+class FastCsvEventParser : public EventParser {
+public:
+    explicit FastCsvEventParser(UserRegistry& users = UserRegistry::global(),
+                                const SymbolRegistry& symbols = SymbolRegistry::global())
+      : users_(&users), symbols_(&symbols) {}
+
+    EventType getEventType(std::string_view event) const override;
+    Event parse(std::string_view event) const override;
+    ParseResult tryParse(std::string_view event) const override;
+    // a line DelimiterScanner split already
+    Event parse(const SplitLine& line) const;
+    ParseResult tryParse(const SplitLine& line) const;
+    // same as the default, with the lines split by the DelimiterScanner
+    BatchResult parseBatch(std::string_view payload, std::span<Event> out) const override;
+
+    // A whole buffer of '\n' separated messages (replayed order files, multi-line payloads),
+    // split with the SIMD DelimiterScanner and handed to onEvent(Event&&) one by one.
+    // Lines that don't parse are skipped and counted, blank ones are ignored.
+    template <class OnEvent>
+    BatchResult parseBuffer(std::string_view buffer, OnEvent&& onEvent, SimdLevel level = bestSimdLevel()) const {
+      BatchResult result;
+      DelimiterScanner scanner {buffer, level};
+      SplitLine line;
+      while (scanner.nextLine(line)) {
+        if (trimView(line.line_).empty()) {
+          continue;
+        }
+        if (auto event = tryParse(line)) {
+          onEvent(std::move(*event));
+          ++result.events_;
+        } else {
+          result.reject(event.error());
+        }
+      }
+      result.consumed_ = buffer.size();
+      return result;
+    }
+
+private:
+    template <class Fields>
+    ParseResult parseFields(Fields& fields) const;
+
+    UserRegistry* users_;
+    const SymbolRegistry* symbols_;
+};
+
+// Decodes the fixed layout messages of BinaryProtocol.h, each one is a memcpy and a few range checks.
+// parse() takes exactly one message, parseBatch() a datagram of them back to back.
+// A plain "QUIT" datagram (what the listener and the signal handler send) is a QuitEvent here too.
+class BinaryEventParser : public EventParser {
+public:
+    explicit BinaryEventParser(UserRegistry& users = UserRegistry::global(),
+                               const SymbolRegistry& symbols = SymbolRegistry::global())
+      : users_(&users), symbols_(&symbols) {}
+
+    EventType getEventType(std::string_view event) const override;
+    Event parse(std::string_view event) const override;
+    ParseResult tryParse(std::string_view event) const override;
+    BatchResult parseBatch(std::string_view payload, std::span<Event> out) const override;
+
+private:
+    UserRegistry* users_;
+    const SymbolRegistry* symbols_;
+};
+
+// FIX 4.2/4.4 tag=value, the subset that maps onto our events:
+//   35=D NewOrderSingle      49 (user), 11, 55, 38, 54, 40, [44]
+//   35=F OrderCancelRequest  49, 11, 55, 37 (the exchange order id, from the OrderAcceptedReport)
+//   35=V MarketDataRequest   49, 262 (numeric, used as the client order id), 55, [264]
+//        264=1 (or missing) is a TopOfBookEvent, 264=0 full depth, 264=N N levels
+// Tags are scanned in place and dispatched as integers, tryParse() doesn't copy, throw or allocate
+// (but the first sight of a user).
+// 8 (FIX.4.2 or FIX.4.4), 9 and 35 have to come first and 10 last, BodyLength and CheckSum are checked.
+// Other tags (session ones, repeating groups we don't use) are skipped.
+// The delimiter is SOH, '|' works too for logs and hand typed messages (the checksum is over what's actually sent).
+// A plain "QUIT" datagram is a QuitEvent, as in the other parsers.
+class FixEventParser : public EventParser {
+public:
+    static constexpr char SOH = '\x01';
+
+    explicit FixEventParser(UserRegistry& users = UserRegistry::global(),
+                            const SymbolRegistry& symbols = SymbolRegistry::global(),
+                            char delimiter = SOH)
+      : users_(&users), symbols_(&symbols), delimiter_(delimiter) {}
+
+    EventType getEventType(std::string_view event) const override;
+    Event parse(std::string_view event) const override;
+    ParseResult tryParse(std::string_view event) const override;
+    // messages back to back (anything between them that's whitespace is skipped), framed by their BodyLength
+    BatchResult parseBatch(std::string_view payload, std::span<Event> out) const override;
+
+    // Client side helper: wraps body (35 onwards, every field followed by the delimiter) into a full message,
+    // 8/9 in front and 10 at the end. Allocates, it's meant for senders and tests.
+    static std::string frame(std::string_view body, std::string_view beginString = "FIX.4.4", char delimiter = SOH);
+
+private:
+    // bytes of the message at the front of payload, 0 if it can't be framed
+    std::size_t messageLength(std::string_view payload) const;
+
+    UserRegistry* users_;
+    const SymbolRegistry* symbols_;
+    char delimiter_;
+};
+
+// which parser the exchange runs with, csv is for humans and scripts
+enum class WireFormat {
+  Csv,
+  Binary,
+  Fix,
+};
+
+// "csv", "binary" or "fix", throws std::invalid_argument otherwise
+WireFormat toWireFormat(std::string_view format);
+std::unique_ptr<EventParser> makeEventParser(WireFormat format,
+                                             UserRegistry& users = UserRegistry::global(),
+                                             const SymbolRegistry& symbols = SymbolRegistry::global());
+
 } // namespace Exchange
 
 #endif // EVENT_PARSER_H 
\ No newline at end of file
@@ -4,6 +4,8 @@
 #include <string>
 #include <functional>
 #include <memory>
+#include <span>
+#include <string_view>
 
 class SubscriptionHandle {
 public:
@@ -12,21 +14,46 @@ public:
 
 class EventQueue {
 public:
+  // Views point into the queue's receive buffer, good for the duration of the call only. Copy what has to outlive it.
+  using ViewCallback = std::function<void(std::string_view)>;
+  // everything one receive got, in arrival order
+  using MessageBatch = std::span<const std::string_view>;
+  using BatchCallback = std::function<void(MessageBatch)>;
+  // a copy of each message, for subscribers that want to keep it
   using MessageCallback = std::function<void(const std::string&)>; // (message)
 
   virtual ~EventQueue() = 0;
 
-  virtual std::unique_ptr<SubscriptionHandle> subscribe(MessageCallback callback) = 0;
+  // Messages as they come in batches. Queues that don't receive in batches hand over batches of one.
+  [[nodiscard]] virtual std::unique_ptr<SubscriptionHandle> subscribeBatch(BatchCallback callback) = 0;
 
+  [[nodiscard]] std::unique_ptr<SubscriptionHandle> subscribeView(ViewCallback callback) {
+    return subscribeBatch([callback = std::move(callback)](MessageBatch messages) {
+      for (auto message : messages) {
+        callback(message);
+      }
+    });
+  }
+
+  [[nodiscard]] std::unique_ptr<SubscriptionHandle> subscribe(MessageCallback callback) {
+    return subscribeView([callback = std::move(callback)](std::string_view message) {
+      callback(std::string(message));
+    });
+  }
+
+  // takes a view when f can, a std::string copy otherwise
   template<class F, class... Args >
-  // requires std::is_invocable_v<F&, Args..., const std::string&>
-  requires std::invocable<F&, Args..., const std::string&>
+  requires std::invocable<F&, Args..., std::string_view> || std::invocable<F&, Args..., const std::string&>
   [[nodiscard]] std::unique_ptr<SubscriptionHandle>  subscribeWith(F&& f, Args&&... args) {
-    MessageCallback cb = [g = std::forward<F>(f),
-                          ...b = std::forward<Args>(args)](const std::string& msg) mutable {
-      std::invoke(g, b..., msg);
-    };
-    return subscribe(std::move(cb));
+    if constexpr (std::invocable<F&, Args..., std::string_view>) {
+      return subscribeView([g = std::forward<F>(f), ...b = std::forward<Args>(args)](std::string_view msg) mutable {
+        std::invoke(g, b..., msg);
+      });
+    } else {
+      return subscribe([g = std::forward<F>(f), ...b = std::forward<Args>(args)](const std::string& msg) mutable {
+        std::invoke(g, b..., msg);
+      });
+    }
   }
 
   [[nodiscard]] std::unique_ptr<SubscriptionHandle>  subscribe_with(MessageCallback callback) {
@@ -1,12 +1,15 @@
 #ifndef EXCHANGE_H
 #define EXCHANGE_H
 
+#include <array>
+#include <memory>
 #include <string>
 #include <thread>
 #include <mutex>
 #include <condition_variable>
 
 #include "EventQueue.h"
+#include "Event.h"
 #include "EventParser.h"
 #include "OrderBookManager.h"
 
@@ -15,23 +18,38 @@ namespace Exchange {
 
 class Exchange {
 public:
-    Exchange(EventQueue& eventQueue, EventParser& eventParser, OrderBookManager& orderBookManager);
+    Exchange(EventQueue& eventQueue, EventParser& eventParser, IOrderBookManager& orderBookManager);
+    // runs with its own parser for the configured wire format
+    Exchange(EventQueue& eventQueue, WireFormat wireFormat, IOrderBookManager& orderBookManager);
     ~Exchange();
 
     void start();
 
+    // what the parser turned away so far, by reason
+    const RejectCounters& rejects() const { return rejects_; }
+
 
 private:
-    void processEvent(const std::string& event);
+    // whatever the queue received in one go, stops at the first quit
+    void processBatch(EventQueue::MessageBatch messages);
+    // one datagram, which can carry several '\n' separated messages, false once it had a quit
+    bool processEvent(std::string_view payload, Timestamp received);
 
     void requestStop();
     void handleStop();
 
   private:
 
-    OrderBookManager& orderBookManager_;
+    // parsed events of the datagram being processed, handed to the book manager together
+    static constexpr std::size_t MAX_BATCH_EVENTS = 64;
+    std::array<Event, MAX_BATCH_EVENTS> batch_ {};
+    RejectCounters rejects_;
+
+    IOrderBookManager& orderBookManager_;
 
 
+    // set when the exchange picked the parser itself, eventParser_ points at it
+    std::unique_ptr<EventParser> ownedEventParser_;
     EventParser& eventParser_;
     EventQueue& eventQueue_;
     std::unique_ptr<SubscriptionHandle> eventQueueSubscription_;
@@ -0,0 +1,569 @@
+#ifndef LADDER_ORDER_BOOK_H
+#define LADDER_ORDER_BOOK_H
+
+#include "OrderBook.h"
+#include "NodePool.h"
+#include "OrderIdMap.h"
+
+#include <vector>
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <iostream>
+
+namespace Exchange {
+
+// Price-level ladder book.
+// Every price level is a FIFO queue of resting orders (intrusive doubly linked list),
+// levels live in a flat array indexed by the tick offset from a per-symbol reference price.
+// Best bid/ask are cached indices, so finding the top is O(1), and adding/removing an order at a level is O(1).
+// The band starts around a per-symbol reference price (SymbolRegistry::referencePrice), prices outside it move
+// and/or grow the band (rare, amortized); only a price more than MAX_NUM_LEVELS ticks away from the resting
+// orders is turned away, with a Price_Out_Of_Range cancel for whatever of it didn't fill.
+template <ReportSinkConcept ReportSink>
+class LadderOrderBook final : public IOrderBook {
+public:
+    static constexpr std::size_t DEFAULT_NUM_LEVELS = 4096;
+    // hard cap on the ladder size, a limit price this far from the resting orders is rejected
+    static constexpr std::size_t MAX_NUM_LEVELS = 1 << 20;
+
+    using ReportSinkType = ReportSink;
+
+    // the band starts centered on referencePrice
+    LadderOrderBook(Symbol symbol, std::unique_ptr<ReportSink> reportSink, Price referencePrice,
+                    std::size_t numLevels = DEFAULT_NUM_LEVELS, NodePoolConfig poolConfig = {});
+    ~LadderOrderBook();
+
+    LadderOrderBook(const LadderOrderBook&) = delete;
+    LadderOrderBook& operator=(const LadderOrderBook&) = delete;
+    // the nodes stay put in the pool, which moves along with its unique_ptr, so the level and id map pointers
+    // stay good; the moved from book is left with no orders for its destructor to free
+    LadderOrderBook(LadderOrderBook&&) noexcept = default;
+
+    bool submitNewOrder(const NewOrderEvent& event) override;
+    bool submitCancelOrder(const CancelOrderEvent& event) override;
+    void submitTopOfBook(const TopOfBookEvent& event) override;
+    void submitDepth(const DepthEvent& event) override;
+    std::size_t submitBatch(std::span<const Event> events) override;
+
+    const NodePoolStats& nodePoolStats() const { return nodePool_->stats(); }
+
+    // the levels keep their own quantity/order count, so this is just a read of the two best levels
+    TopOfBookReport topOfBook() const { return TopOfBookReport{symbol_, topLevel(bids_), topLevel(asks_)}; }
+
+    // best numLevels (capped at MAX_DEPTH_LEVELS) levels per side, steps over the ladder from the best level,
+    // skipping the empty ones, never looks at the orders
+    DepthReport depth(std::size_t numLevels = MAX_DEPTH_LEVELS) const;
+
+    // send a TopOfBookReport on its own whenever the best bid or ask level changes
+    void setPublishTopOfBook(bool enabled) { publishTopOfBook_ = enabled; publishedTop_ = topOfBook(); }
+
+private:
+  static constexpr std::ptrdiff_t NO_LEVEL = -1;
+
+  // hot part of the order + the level's queue links, price and side are implied by the level it's on
+  struct Node {
+    RestingOrder order;
+    Node* prev {nullptr};
+    Node* next {nullptr};
+  };
+  static_assert(sizeof(Node) <= 32, "LadderOrderBook::Node is on the matching path, keep it within 32 bytes");
+
+  struct Level {
+    bool empty() const { return head == nullptr; }
+
+    Node* head {nullptr};
+    Node* tail {nullptr};
+    Quantity quantity {0};
+    uint32_t orderCount {0};
+  };
+
+  // one side of the ladder, levels_ is shared, this only tracks where the side lives in it
+  struct SideState {
+    std::ptrdiff_t best {NO_LEVEL};
+    // furthest level from the best we've ever used since the side was last empty, bounds the rescans
+    std::ptrdiff_t worst {NO_LEVEL};
+    std::size_t orderCount {0};
+  };
+
+  Symbol symbol_;
+  std::unique_ptr<ReportSink> reportSink_;
+
+  std::unique_ptr<NodePool> nodePool_;
+
+  int64_t baseTicks_ {0};        // price of levels_[0]
+  std::vector<Level> levels_;
+
+  SideState bids_;
+  SideState asks_;
+
+  // exchange order id -> node + the order's cold details, cancels are a single index
+  OrderIdMap<Node, OrderDetails> orders_;
+
+  // the levels are FIFO already, this just stamps the orders the same way OrderBook does
+  SequenceNumber sequenceNumber_ {0};
+
+  FillBuffer fills_;
+  bool inBatch_ {false};
+  // the match point stamp of the fills, moved once per batch (or per order outside one), not per fill
+  CoarseClock matchClock_;
+
+  bool publishTopOfBook_ {false};
+  TopOfBookReport publishedTop_ {};
+
+  SequenceNumber nextSequenceNumber() { return sequenceNumber_++; }
+
+  std::ptrdiff_t levelIndex(Price price);
+  Price levelPrice(std::ptrdiff_t idx) const { return Price{baseTicks_ + idx}; }
+  bool growTo(Price price);
+
+  // true if 'a' is a better price than 'b' for the given side
+  static bool isBetter(Side side, std::ptrdiff_t a, std::ptrdiff_t b) { return side == Side::Buy ? a > b : a < b; }
+  SideState& sideState(Side side) { return side == Side::Buy ? bids_ : asks_; }
+  PriceLevel topLevel(const SideState& side) const;
+  uint32_t copyLevels(const SideState& side, std::ptrdiff_t step, std::size_t numLevels, std::span<PriceLevel> out) const;
+  void publishTopOfBookIfChanged();
+
+  Node* createNode(const NewOrderEvent& event, ExchangeOrderId exchangeOrderId, Quantity filledQuantity);
+  void destroyNode(Node* node) noexcept;
+
+  bool addOrder(const NewOrderEvent& event, Quantity filledQuantity);
+  void removeOrder(Node* node, Side side, std::ptrdiff_t idx);
+  void advanceBest(Side side);
+
+  bool handleNewOrder(const NewOrderEvent& event, SideState& oppositeSide, auto cmpFunc);
+  bool handleAggressiveOrder(const NewOrderEvent& event, SideState& oppositeSide, auto cmpFunc);
+
+  bool dispatch(const Event& event);
+
+  void recordFill(OrderId restingOrderId, OrderId aggressiveOrderId, Quantity filled, Price price);
+  void reportFills();
+  void reportOrderAccepted(const RestingOrder& order, Price price);
+  void reportNewOrderCanceled(const NewOrderEvent& event, Quantity filledQuantity,
+                              CancelReason reason = CancelReason::Fill_And_Kill);
+  void reportOrderCanceled(const RestingOrder& order);
+};
+
+template <ReportSinkConcept ReportSink>
+LadderOrderBook<ReportSink>::LadderOrderBook(Symbol symbol, std::unique_ptr<ReportSink> reportSink, Price referencePrice,
+                                             std::size_t numLevels, NodePoolConfig poolConfig)
+  : symbol_(symbol), reportSink_(std::move(reportSink)), nodePool_(std::make_unique<NodePool>(sizeof(Node), poolConfig)),
+    levels_(std::max<std::size_t>(numLevels, 2)) {
+  // center the band on the reference price, but never go below 0
+  baseTicks_ = std::max<int64_t>(0, referencePrice.ticks - static_cast<int64_t>(levels_.size() / 2));
+}
+
+template <ReportSinkConcept ReportSink>
+LadderOrderBook<ReportSink>::~LadderOrderBook() {
+  orders_.forEach([this](Node* node) { destroyNode(node); });
+}
+
+template <ReportSinkConcept ReportSink>
+bool LadderOrderBook<ReportSink>::submitNewOrder(const NewOrderEvent& event) {
+  // nothing to match or rest, and a negative open quantity would poison the level totals
+  if (event.quantity() <= 0) {
+    return false;
+  }
+
+  // buy crosses asks: market always crosses; otherwise limit >= best ask
+  auto crossesBuy = [](const NewOrderEvent& ev, Price bestAsk) noexcept {
+    return ev.type() == Type::Market || ev.price() >= bestAsk;
+  };
+
+  // sell crosses bids: market always crosses; otherwise limit <= best bid
+  auto crossesSell = [](const NewOrderEvent& ev, Price bestBid) noexcept {
+    return ev.type() == Type::Market || ev.price() <= bestBid;
+  };
+  if (event.side() == Side::Buy) {
+    const bool result = handleNewOrder(event, asks_, crossesBuy);
+    publishTopOfBookIfChanged();
+    return result;
+  } else if (event.side() == Side::Sell) {
+    const bool result = handleNewOrder(event, bids_, crossesSell);
+    publishTopOfBookIfChanged();
+    return result;
+  } else {
+    std::cout << "LadderOrderBook::submitNewOrder: Invalid side" << std::endl;
+    return false;
+  }
+}
+
+template <ReportSinkConcept ReportSink>
+bool LadderOrderBook<ReportSink>::submitCancelOrder(const CancelOrderEvent& event) {
+  Node* node = orders_.find(event.origOrderId());
+  if (!node) {
+    return false;
+  }
+
+  // where the node lives is in the cold details
+  const OrderDetails& details = orders_.cold(event.origOrderId());
+  const Side side = details.side_;
+  const auto idx = static_cast<std::ptrdiff_t>(details.price_.ticks - baseTicks_);
+
+  const RestingOrder snapshot = node->order;
+  removeOrder(node, side, idx);
+  reportOrderCanceled(snapshot);
+  publishTopOfBookIfChanged();
+  return true;
+}
+
+template <ReportSinkConcept ReportSink>
+void LadderOrderBook<ReportSink>::submitTopOfBook(const TopOfBookEvent&) {
+  reportFills();
+  reportSink_->submitTopOfBook(topOfBook());
+}
+
+template <ReportSinkConcept ReportSink>
+void LadderOrderBook<ReportSink>::submitDepth(const DepthEvent& event) {
+  reportFills();
+  reportSink_->submitDepth(depth(event.levels()));
+}
+
+template <ReportSinkConcept ReportSink>
+DepthReport LadderOrderBook<ReportSink>::depth(std::size_t numLevels) const {
+  DepthReport report;
+  report.symbol_ = symbol_;
+  report.bidCount_ = copyLevels(bids_, -1, numLevels, report.bids_);
+  report.askCount_ = copyLevels(asks_, 1, numLevels, report.asks_);
+  return report;
+}
+
+template <ReportSinkConcept ReportSink>
+uint32_t LadderOrderBook<ReportSink>::copyLevels(const SideState& side, std::ptrdiff_t step, std::size_t numLevels,
+                                                 std::span<PriceLevel> out) const {
+  numLevels = std::min(numLevels, out.size());
+  uint32_t count = 0;
+  if (side.best == NO_LEVEL) {
+    return count;
+  }
+  for (auto idx = side.best; count < numLevels; idx += step) {
+    const Level& level = levels_[idx];
+    if (!level.empty()) {
+      out[count++] = PriceLevel{levelPrice(idx), level.quantity, level.orderCount};
+    }
+    if (idx == side.worst) {
+      break;
+    }
+  }
+  return count;
+}
+
+template <ReportSinkConcept ReportSink>
+PriceLevel LadderOrderBook<ReportSink>::topLevel(const SideState& side) const {
+  if (side.best == NO_LEVEL) {
+    return {};
+  }
+  const Level& level = levels_[side.best];
+  return PriceLevel{levelPrice(side.best), level.quantity, level.orderCount};
+}
+
+template <ReportSinkConcept ReportSink>
+void LadderOrderBook<ReportSink>::publishTopOfBookIfChanged() {
+  if (!publishTopOfBook_) {
+    return;
+  }
+  const auto top = topOfBook();
+  if (top.bid_ == publishedTop_.bid_ && top.ask_ == publishedTop_.ask_) {
+    return;
+  }
+  publishedTop_ = top;
+  reportFills();
+  reportSink_->submitTopOfBook(TopOfBookReport{top});
+}
+
+template <ReportSinkConcept ReportSink>
+std::size_t LadderOrderBook<ReportSink>::submitBatch(std::span<const Event> events) {
+  if constexpr (BatchingReportSink<ReportSink>) {
+    reportSink_->beginBatch();
+  }
+  inBatch_ = true;
+  matchClock_.update();
+
+  std::size_t accepted = 0;
+  for (const auto& event : events) {
+    accepted += dispatch(event);
+  }
+
+  inBatch_ = false;
+  reportFills();
+  if constexpr (BatchingReportSink<ReportSink>) {
+    reportSink_->endBatch();
+  }
+  return accepted;
+}
+
+template <ReportSinkConcept ReportSink>
+bool LadderOrderBook<ReportSink>::dispatch(const Event& event) {
+  return std::visit([this](const auto& ev) {
+    using T = std::decay_t<decltype(ev)>;
+    if constexpr (std::is_same_v<T, NewOrderEvent>) {
+      return LadderOrderBook::submitNewOrder(ev);
+    } else if constexpr (std::is_same_v<T, CancelOrderEvent>) {
+      return LadderOrderBook::submitCancelOrder(ev);
+    } else if constexpr (std::is_same_v<T, TopOfBookEvent>) {
+      LadderOrderBook::submitTopOfBook(ev);
+      return true;
+    } else if constexpr (std::is_same_v<T, DepthEvent>) {
+      LadderOrderBook::submitDepth(ev);
+      return true;
+    } else {
+      return false;
+    }
+  }, event.data_);
+}
+
+template <ReportSinkConcept ReportSink>
+std::ptrdiff_t LadderOrderBook<ReportSink>::levelIndex(Price price) {
+  auto idx = price.ticks - baseTicks_;
+  if (idx < 0 || idx >= static_cast<int64_t>(levels_.size())) {
+    if (!growTo(price)) {
+      return NO_LEVEL;
+    }
+    idx = price.ticks - baseTicks_;
+  }
+  return static_cast<std::ptrdiff_t>(idx);
+}
+
+template <ReportSinkConcept ReportSink>
+bool LadderOrderBook<ReportSink>::growTo(Price price) {
+  if (price.ticks < 0) {
+    return false;
+  }
+  const auto size = static_cast<int64_t>(levels_.size());
+  if (bids_.best == NO_LEVEL && asks_.best == NO_LEVEL) {
+    // nothing resting, every level is empty already: just move the band over
+    baseTicks_ = std::max<int64_t>(0, price.ticks - size / 2);
+    return true;
+  }
+
+  // the levels that can hold orders (between each side's best and worst) plus the new price all have to fit
+  int64_t low = price.ticks;
+  int64_t high = price.ticks;
+  for (const auto* side : {&bids_, &asks_}) {
+    if (side->best != NO_LEVEL) {
+      low = std::min(low, baseTicks_ + std::min(side->best, side->worst));
+      high = std::max(high, baseTicks_ + std::max(side->best, side->worst));
+    }
+  }
+  const int64_t span = high - low + 1;
+  if (span > static_cast<int64_t>(MAX_NUM_LEVELS)) {
+    return false;
+  }
+
+  // at least double (up to the cap) so repeated out of band prices stay amortized O(1)
+  int64_t newSize = std::min<int64_t>(size * 2, MAX_NUM_LEVELS);
+  while (newSize < span) {
+    newSize *= 2;
+  }
+  newSize = std::min<int64_t>(newSize, MAX_NUM_LEVELS);
+  // the spare room split around the used part, it's as likely to move either way
+  const int64_t newBase = std::max<int64_t>(0, low - (newSize - span) / 2);
+
+  // everything outside [low, high] is empty, only the overlap of the old and new band needs copying
+  std::vector<Level> levels(static_cast<std::size_t>(newSize));
+  const int64_t from = std::max(baseTicks_, newBase);
+  const int64_t to = std::min(baseTicks_ + size, newBase + newSize);
+  if (from < to) {
+    std::copy(levels_.begin() + (from - baseTicks_), levels_.begin() + (to - baseTicks_), levels.begin() + (from - newBase));
+  }
+  const auto offset = static_cast<std::ptrdiff_t>(baseTicks_ - newBase);
+  levels_ = std::move(levels);
+  baseTicks_ = newBase;
+
+  for (auto* side : {&bids_, &asks_}) {
+    if (side->best != NO_LEVEL) {
+      side->best += offset;
+      side->worst += offset;
+    }
+  }
+  return true;
+}
+
+template <ReportSinkConcept ReportSink>
+typename LadderOrderBook<ReportSink>::Node* LadderOrderBook<ReportSink>::createNode(const NewOrderEvent& event, ExchangeOrderId exchangeOrderId, Quantity filledQuantity) {
+  assert(filledQuantity <= event.quantity());
+  return ::new (nodePool_->allocate()) Node{RestingOrder{exchangeOrderId, event.quantity() - filledQuantity, event.clientOrderId()}};
+}
+
+template <ReportSinkConcept ReportSink>
+void LadderOrderBook<ReportSink>::destroyNode(Node* node) noexcept {
+  node->~Node();
+  nodePool_->deallocate(node);
+}
+
+template <ReportSinkConcept ReportSink>
+bool LadderOrderBook<ReportSink>::addOrder(const NewOrderEvent& event, Quantity filledQuantity) {
+  const auto idx = levelIndex(event.price());
+  if (idx == NO_LEVEL) {
+    // the fills (if any) stand, the rest can't rest here
+    reportNewOrderCanceled(event, filledQuantity, CancelReason::Price_Out_Of_Range);
+    return false;
+  }
+
+  const auto id = orders_.nextId();
+  Node* node = createNode(event, id, filledQuantity);
+  orders_.insert(id, node, OrderDetails{event.userId(), event.price(), event.timestamp(), nextSequenceNumber(),
+                                        event.quantity(), event.side(), event.type()});
+
+  Level& level = levels_[idx];
+  node->prev = level.tail;
+  if (level.tail) {
+    level.tail->next = node;
+  } else {
+    level.head = node;
+  }
+  level.tail = node;
+  level.quantity += node->order.openQuantity_;
+  ++level.orderCount;
+
+  auto& side = sideState(event.side());
+  if (side.best == NO_LEVEL) {
+    side.best = side.worst = idx;
+  } else {
+    if (isBetter(event.side(), idx, side.best)) side.best = idx;
+    if (isBetter(event.side(), side.worst, idx)) side.worst = idx;
+  }
+  ++side.orderCount;
+
+  reportOrderAccepted(node->order, event.price());
+  return true;
+}
+
+template <ReportSinkConcept ReportSink>
+void LadderOrderBook<ReportSink>::removeOrder(Node* node, Side side, std::ptrdiff_t idx) {
+  Level& level = levels_[idx];
+
+  (node->prev ? node->prev->next : level.head) = node->next;
+  (node->next ? node->next->prev : level.tail) = node->prev;
+  level.quantity -= node->order.openQuantity_;
+  --level.orderCount;
+
+  orders_.erase(node->order.exchangeOrderId_);
+  destroyNode(node);
+
+  auto& state = sideState(side);
+  --state.orderCount;
+  if (level.empty() && idx == state.best) {
+    advanceBest(side);
+  }
+}
+
+template <ReportSinkConcept ReportSink>
+void LadderOrderBook<ReportSink>::advanceBest(Side side) {
+  auto& state = sideState(side);
+  if (state.orderCount == 0) {
+    state.best = state.worst = NO_LEVEL;
+    return;
+  }
+  const std::ptrdiff_t step = side == Side::Buy ? -1 : 1;
+  while (levels_[state.best].empty()) {
+    assert(state.best != state.worst && "LadderOrderBook: lost track of the resting orders");
+    state.best += step;
+  }
+}
+
+template <ReportSinkConcept ReportSink>
+bool LadderOrderBook<ReportSink>::handleNewOrder(const NewOrderEvent& event, SideState& oppositeSide, auto cmpFunc) {
+  const bool aggressive = oppositeSide.best != NO_LEVEL && cmpFunc(event, levelPrice(oppositeSide.best));
+
+  if (aggressive) {
+    return handleAggressiveOrder(event, oppositeSide, cmpFunc);
+  }
+
+  switch (event.type()) {
+    case Type::Market:
+      // nothing to fill against, it's FILL_AND_KILL
+      assert(oppositeSide.best == NO_LEVEL && "Have opposite side orders but didn't fill a market order, something is wrong!");
+      reportNewOrderCanceled(event, 0);
+      return true;
+    case Type::Limit:
+      return addOrder(event, 0);
+    default:
+      assert(false && "LadderOrderBook::handleNewOrder: Invalid type");
+      break;
+  }
+  return false;
+}
+
+template <ReportSinkConcept ReportSink>
+bool LadderOrderBook<ReportSink>::handleAggressiveOrder(const NewOrderEvent& event, SideState& oppositeSide, auto cmpFunc) {
+  const Side restingSide = event.side() == Side::Buy ? Side::Sell : Side::Buy;
+  Quantity filledQuantity = 0;
+  // outside a batch the order is the batch
+  if (!inBatch_) {
+    matchClock_.update();
+  }
+
+  while (filledQuantity < event.quantity() && oppositeSide.best != NO_LEVEL
+         && cmpFunc(event, levelPrice(oppositeSide.best))) {
+    Level& level = levels_[oppositeSide.best];
+    Node* node = level.head;
+    RestingOrder& order = node->order;
+
+    const Quantity filled = order.fill(event.quantity() - filledQuantity);
+    level.quantity -= filled;
+    filledQuantity += filled;
+
+    recordFill(order.clientOrderId_, event.clientOrderId(), filled, levelPrice(oppositeSide.best));
+
+    if (order.isFilled()) {
+      removeOrder(node, restingSide, oppositeSide.best);
+    }
+  }
+
+  // in a batch the fills pile up until something else gets reported (or the batch ends)
+  if (!inBatch_) {
+    reportFills();
+  }
+
+  if (filledQuantity != event.quantity()) {
+    // no more fills so canceling the rest of the order (FILL&KILL)
+    if (oppositeSide.best == NO_LEVEL) {
+      reportNewOrderCanceled(event, filledQuantity);
+    } else {
+      return addOrder(event, filledQuantity);
+    }
+  }
+  return true;
+}
+
+template <ReportSinkConcept ReportSink>
+void LadderOrderBook<ReportSink>::reportOrderAccepted(const RestingOrder& order, Price price) {
+  reportFills();
+  reportSink_->submitAcceptedOrder(OrderAcceptedReport{symbol_, order.clientOrderId_, order.exchangeOrderId_, order.openQuantity_, price});
+}
+
+template <ReportSinkConcept ReportSink>
+void LadderOrderBook<ReportSink>::reportNewOrderCanceled(const NewOrderEvent& event, Quantity filledQuantity,
+                                                         CancelReason reason) {
+  reportFills();
+  reportSink_->submitCanceledOrder(OrderCanceledReport{symbol_, event.clientOrderId(), event.quantity() - filledQuantity, reason});
+}
+
+template <ReportSinkConcept ReportSink>
+void LadderOrderBook<ReportSink>::reportOrderCanceled(const RestingOrder& order) {
+  reportFills();
+  reportSink_->submitCanceledOrder(OrderCanceledReport{symbol_, order.clientOrderId_, order.openQuantity_, CancelReason::User_Canceled});
+}
+
+template <ReportSinkConcept ReportSink>
+void LadderOrderBook<ReportSink>::recordFill(OrderId restingOrderId, OrderId aggressiveOrderId, Quantity filled, Price price) {
+  if (!fills_.hasRoomFor(2)) {
+    reportFills();
+  }
+  const auto matched = matchClock_.now();
+  fills_.add(symbol_, restingOrderId, aggressiveOrderId, filled, price, matched);
+  fills_.add(symbol_, aggressiveOrderId, restingOrderId, filled, price, matched);
+}
+
+template <ReportSinkConcept ReportSink>
+void LadderOrderBook<ReportSink>::reportFills() {
+  if (!fills_.empty()) {
+    reportSink_->submitFills(fills_.reports());
+    fills_.clear();
+  }
+}
+
+} // namespace Exchange
+
+#endif // LADDER_ORDER_BOOK_H
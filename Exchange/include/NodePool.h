@@ -0,0 +1,123 @@
+#ifndef NODE_POOL_H
+#define NODE_POOL_H
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+namespace Exchange {
+
+struct NodePoolConfig {
+  std::size_t initialCapacity {1024};   // blocks preallocated up front
+  std::size_t blocksPerChunk {4096};    // blocks added every time we run out
+};
+
+struct NodePoolStats {
+  std::size_t live {0};       // blocks currently handed out
+  std::size_t peak {0};       // high watermark of live
+  std::size_t chunks {0};     // chunks allocated from the heap so far
+  std::size_t capacity {0};   // total blocks across all chunks
+};
+
+// Slab allocator for fixed size blocks (book nodes).
+// Blocks are carved out of large chunks and recycled through an intrusive free list,
+// so once the pool is warm allocate/deallocate never touch the global heap.
+// Not thread safe, meant to be owned by a single book (which lives on a single shard thread).
+class NodePool {
+public:
+  explicit NodePool(std::size_t blockSize, NodePoolConfig config = {});
+  ~NodePool() = default;
+
+  NodePool(const NodePool&) = delete;
+  NodePool& operator=(const NodePool&) = delete;
+
+  void* allocate();
+  void deallocate(void* p) noexcept;
+
+  std::size_t blockSize() const noexcept { return blockSize_; }
+  const NodePoolStats& stats() const noexcept { return stats_; }
+
+private:
+  struct FreeBlock {
+    FreeBlock* next;
+  };
+
+  void addChunk(std::size_t blocks);
+
+  std::size_t blockSize_;
+  NodePoolConfig config_;
+  NodePoolStats stats_ {};
+
+  FreeBlock* freeList_ {nullptr};
+  std::vector<std::unique_ptr<std::byte[]>> chunks_;
+};
+
+// A NodePool per block size, so a node based container can use it through PoolAllocator
+// without us having to know the size of its (implementation defined) node type.
+class NodeArena {
+public:
+  explicit NodeArena(NodePoolConfig config = {}) : config_(config) {}
+
+  NodeArena(const NodeArena&) = delete;
+  NodeArena& operator=(const NodeArena&) = delete;
+
+  NodePool& pool(std::size_t blockSize);
+
+  // summed over all the block sizes
+  NodePoolStats stats() const;
+
+private:
+  NodePoolConfig config_;
+  // there's usually exactly one entry here (the container's node), linear search is fine
+  std::vector<std::unique_ptr<NodePool>> pools_;
+};
+
+// std allocator on top of a NodeArena.
+// Single object allocations (container nodes) come from the arena,
+// anything else (e.g. bucket arrays) is rare and goes to the global heap.
+template <class T>
+class PoolAllocator {
+public:
+  using value_type = T;
+  using propagate_on_container_copy_assignment = std::true_type;
+  using propagate_on_container_move_assignment = std::true_type;
+  using propagate_on_container_swap = std::true_type;
+
+  explicit PoolAllocator(NodeArena* arena) noexcept : arena_(arena) {}
+
+  template <class U>
+  PoolAllocator(const PoolAllocator<U>& other) noexcept : arena_(other.arena()) {}
+
+  T* allocate(std::size_t n) {
+    if (usePool(n)) {
+      return static_cast<T*>(arena_->pool(sizeof(T)).allocate());
+    }
+    return std::allocator<T>().allocate(n);
+  }
+
+  void deallocate(T* p, std::size_t n) noexcept {
+    if (usePool(n)) {
+      arena_->pool(sizeof(T)).deallocate(p);
+      return;
+    }
+    std::allocator<T>().deallocate(p, n);
+  }
+
+  NodeArena* arena() const noexcept { return arena_; }
+
+  template <class U>
+  friend bool operator==(const PoolAllocator& a, const PoolAllocator<U>& b) noexcept { return a.arena_ == b.arena(); }
+
+private:
+  static constexpr bool usePool(std::size_t n) noexcept {
+    return n == 1 && alignof(T) <= alignof(std::max_align_t);
+  }
+
+  NodeArena* arena_;
+};
+
+} // namespace Exchange
+
+#endif // NODE_POOL_H
@@ -3,74 +3,50 @@
 
 #include "OrderUtils.h"
 
+#include <algorithm>
+#include <type_traits>
 
-namespace Exchange {
 
-class NewOrderEvent;
+namespace Exchange {
 
-enum class OrderState {
-  New = 0,
-  PartiallyFilled,
-  Filled,
-  Cancelled
+// A resting order is kept in two pieces.
+//
+// RestingOrder is the hot part, the only thing the match and cancel loops read or write.
+// The books keep it inline in their nodes, next to the queue links / sort keys.
+// LadderOrderBook's node (this + two queue links) stays within 32 bytes. OrderBook's element (this + price and
+// sequence number) is 32 bytes too, but multi_index puts its red-black links on top: a 56 byte tree node.
+struct RestingOrder {
+  Quantity fill(Quantity quantity) noexcept {
+    const Quantity filled = std::clamp(quantity, Quantity{0}, openQuantity_);
+    openQuantity_ -= filled;
+    return filled;
+  }
+
+  bool isFilled() const noexcept { return openQuantity_ == 0; }
+
+  ExchangeOrderId exchangeOrderId_ {INVALID_EXCHANGE_ORDER_ID};
+  Quantity openQuantity_ {0};
+  OrderId clientOrderId_ {INVALID_ORDER_ID};
 };
 
-class Order {
-  public:
-    Order() = default;
-    Order (const NewOrderEvent& event, SequenceNumber sequenceNumber) noexcept;
-    Order (const NewOrderEvent& event, SequenceNumber sequenceNumber, Quantity filledQuantity) noexcept;
-
-    bool isValid() const;
-    bool isActive() const;
-
-    OrderState state() const { return state_; }
-
-
-    UserId userId() const { return userId_; }
-    OrderId clientOrderId() const { return clientOrderId_; }
-    Symbol symbol() const { return symbol_; }
-    Side side() const { return side_; }
-    Type type() const { return type_; }
-    Price price() const { return price_; }
-    Timestamp timestamp() const { return timestamp_; }
-    SequenceNumber sequenceNumber() const { return sequenceNumber_; }
-
-    Quantity quantity() const { return quantity_; }
-    Quantity openQuantity() const { return openQuantity_; }
-    Quantity filledQuantity() const { return quantity() - openQuantity(); }
-
-    Quantity fill(Quantity quantity);
-
-    void cancel();
-
-
-  private:
-
-    OrderState state_ {OrderState::New};
-
-
-    UserId userId_ {INVALID_USER_ID};
-    OrderId clientOrderId_ {INVALID_ORDER_ID};
-    Symbol symbol_ {};
-
-
-    Quantity quantity_ {INVALID_QUANTITY};
-    Quantity openQuantity_ {INVALID_QUANTITY};
-    // Quantity cancelledQuantity_ {INVALID_QUANTITY};
-
-
-    Side side_ {Side::Invalid};
-
-    Type type_ {Type::Invalid};
-    Price price_ {INVALID_PRICE};
-
-    Timestamp timestamp_ {std::chrono::steady_clock::now()};
-
-    // Used as a tie-breaker for orders with the same price/timestamp
-    // we don't have persistance (yet) so this is good enough for now
-    SequenceNumber sequenceNumber_ {0};
+static_assert(sizeof(RestingOrder) == 16, "RestingOrder is the hot record, keep it at 16 bytes");
+static_assert(std::is_trivially_copyable_v<RestingOrder>);
+
+// OrderDetails is the cold part, everything else we know about the order.
+// Stored by value in an array parallel to the book's id map and only read for reports and cancels.
+struct OrderDetails {
+  UserId userId_ {INVALID_USER_ID};
+  Price price_ {INVALID_PRICE};
+  // informational only, priority within a price level is the sequence number
+  Timestamp timestamp_ {};
+  // arrival order within the book, handed out by the book itself
+  SequenceNumber sequenceNumber_ {0};
+  Quantity quantity_ {INVALID_QUANTITY};     // as entered, before any fills
+  Side side_ {Side::Invalid};
+  Type type_ {Type::Invalid};
 };
 
+static_assert(std::is_trivially_copyable_v<OrderDetails>, "OrderDetails lives in a flat array, moved around by the id map's probing and rehashing");
+
 } // namespace Exchange
-#endif
\ No newline at end of file
+#endif
@@ -4,13 +4,19 @@
 #include "Event.h"
 #include "Order.h"
 #include "ReportUtils.h"
+#include "NodePool.h"
+#include "OrderIdMap.h"
+#include "BookFeed.h"
+#include "Clock.h"
 #include <boost/multi_index_container.hpp>   // <-- the big one (not just the fwd)
 #include <boost/multi_index/ordered_index.hpp>
-#include <boost/multi_index/hashed_index.hpp>
 #include <boost/multi_index/composite_key.hpp>
 #include <boost/multi_index/mem_fun.hpp>     // for const_mem_fun
 
+#include <algorithm>
 #include <functional>                        // std::less, std::greater
+#include <map>
+#include <span>
 #include <vector>
 #include <iostream>
 
@@ -25,99 +31,203 @@ public:
     virtual bool submitNewOrder(const NewOrderEvent& event) = 0;
     virtual bool submitCancelOrder(const CancelOrderEvent& event) = 0;
     virtual void submitTopOfBook(const TopOfBookEvent& event) = 0;
+    virtual void submitDepth(const DepthEvent& event) = 0;
+
+    // A run of events for this book, matched back to back.
+    // Fills are handed to the sink once for the whole run (as long as they fit the fill buffer),
+    // returns how many of the events were accepted.
+    virtual std::size_t submitBatch(std::span<const Event> events) = 0;
 };
 
 // TODO: Concept for ReportSink
 template<typename ReportSink> 
 concept ReportSinkConcept = requires(ReportSink sink) {
-  { sink.submitFills(std::move(std::vector<ExecutionReport>())) } -> std::same_as<bool>;
+  { sink.submitFills(ExecutionReportView()) } -> std::same_as<bool>;
+  { sink.submitAcceptedOrder(std::move(OrderAcceptedReport())) } -> std::same_as<bool>;
   { sink.submitCanceledOrder(std::move(OrderCanceledReport())) } -> std::same_as<bool>;
   { sink.submitTopOfBook(std::move(TopOfBookReport())) } -> std::same_as<bool>;
+  { sink.submitDepth(std::move(DepthReport())) } -> std::same_as<bool>;
+};
+
+// Optional: a sink that can hold off waking its consumer until a batch is over.
+template<typename ReportSink>
+concept BatchingReportSink = requires(ReportSink sink) {
+  sink.beginBatch();
+  sink.endBatch();
 };
 
-template <ReportSinkConcept ReportSink>
-class OrderBook : public IOrderBook {
+// Feed gets an L3 BookDelta for every change to the resting orders, NoBookFeed (the default) compiles it all away.
+template <ReportSinkConcept ReportSink, BookFeedConcept Feed = NoBookFeed>
+class OrderBook final : public IOrderBook {
 public:
+    using ReportSinkType = ReportSink;
 
     // TODO: Whole order book creation needs a bit of fixing.
-    OrderBook(Symbol symbol, std::unique_ptr<ReportSink> reportSink) : symbol_(symbol), reportSink_(std::move(reportSink)) {}
+    OrderBook(Symbol symbol, std::unique_ptr<ReportSink> reportSink, NodePoolConfig poolConfig = {})
+      : symbol_(symbol), reportSink_(std::move(reportSink)), nodeArena_(std::make_unique<NodeArena>(poolConfig)) {}
+
+    OrderBook(Symbol symbol, std::unique_ptr<ReportSink> reportSink, std::unique_ptr<Feed> feed, NodePoolConfig poolConfig = {})
+      : symbol_(symbol), reportSink_(std::move(reportSink)), feed_(std::move(feed)),
+        nodeArena_(std::make_unique<NodeArena>(poolConfig)) {}
 
 
     bool submitNewOrder(const NewOrderEvent& event) override;
     bool submitCancelOrder(const CancelOrderEvent& event) override;
     void submitTopOfBook(const TopOfBookEvent& event) override;
+    void submitDepth(const DepthEvent& event) override;
+    std::size_t submitBatch(std::span<const Event> events) override;
+
+    // resting order nodes (both sides)
+    NodePoolStats nodePoolStats() const { return nodeArena_->stats(); }
+
+    // best bid/ask as of now, no event needed
+    TopOfBookReport topOfBook() const { return TopOfBookReport{symbol_, bidTop_, askTop_}; }
+
+    // best numLevels (capped at MAX_DEPTH_LEVELS) levels per side, straight from the level totals
+    DepthReport depth(std::size_t numLevels = MAX_DEPTH_LEVELS) const;
+
+    // send a TopOfBookReport on its own whenever the best bid or ask level changes
+    void setPublishTopOfBook(bool enabled) { publishTopOfBook_ = enabled; publishedTop_ = topOfBook(); }
 
 private:
+  static constexpr bool HAS_FEED = !std::is_same_v<Feed, NoBookFeed>;
+
   Symbol symbol_;
   std::unique_ptr<ReportSink> reportSink_;
+  std::unique_ptr<Feed> feed_;
+  uint64_t feedSequenceNumber_ {0};
+
+  // heap allocated so the containers' allocators stay valid if the book is moved
+  // declared before the books, they release their nodes into it on destruction
+  std::unique_ptr<NodeArena> nodeArena_;
+
+  struct by_price_seq {};
 
-  struct by_price_time_seq {};
-  struct by_order_id;           // (userId, clientOrderId) or just clientOrderId
+  // what the containers hold: the sort key and the hot part of the order, the rest is kept in orderIds_
+  struct Entry {
+    Price price() const { return price_; }
+    SequenceNumber sequenceNumber() const { return sequenceNumber_; }
 
-  // asks sorted with lowest price first, then timestamp, then sequence number(as a tie breaker)
+    Price price_;
+    SequenceNumber sequenceNumber_;
+    RestingOrder order_;
+  };
+  // the payload only, the container's node adds 24 bytes of red-black tree links (56 in all)
+  static_assert(sizeof(Entry) <= 32, "OrderBook::Entry is on the matching path, keep it within 32 bytes");
+
+  // asks sorted with lowest price first, then sequence number (arrival order in this book)
   using AskBook = boost::multi_index::multi_index_container<
-    Order,
+    Entry,
     boost::multi_index::indexed_by<
       boost::multi_index::ordered_non_unique<
-        boost::multi_index::tag<by_price_time_seq>,
+        boost::multi_index::tag<by_price_seq>,
         boost::multi_index::composite_key<
-          Order,
-          boost::multi_index::const_mem_fun<Order, Price, &Order::price>,
-          boost::multi_index::const_mem_fun<Order, Timestamp, &Order::timestamp>,
-          boost::multi_index::const_mem_fun<Order, SequenceNumber, &Order::sequenceNumber>
+          Entry,
+          boost::multi_index::const_mem_fun<Entry, Price, &Entry::price>,
+          boost::multi_index::const_mem_fun<Entry, SequenceNumber, &Entry::sequenceNumber>
         >,
         boost::multi_index::composite_key_compare<
-          std::less<Price>, std::less<Timestamp>, std::less<SequenceNumber>
+          std::less<Price>, std::less<SequenceNumber>
         >
-      >,
-      // 2nd index for fast cancelation
-      boost::multi_index::hashed_unique<
-      boost::multi_index::tag<by_order_id>,
-        boost::multi_index::const_mem_fun<Order, OrderId, &Order::clientOrderId>
       >
-    >
+    >,
+    PoolAllocator<Entry>
   >;
 
-  // bids sorted with highest price first, then timestamp, then sequence number(as a tie breaker)
+  // bids sorted with highest price first, then sequence number (arrival order in this book)
   using BidBook = boost::multi_index::multi_index_container<
-    Order,
+    Entry,
     boost::multi_index::indexed_by<
       boost::multi_index::ordered_non_unique<
-        boost::multi_index::tag<by_price_time_seq>,
+        boost::multi_index::tag<by_price_seq>,
         boost::multi_index::composite_key<
-          Order,
-          boost::multi_index::const_mem_fun<Order, Price, &Order::price>,
-          boost::multi_index::const_mem_fun<Order, Timestamp, &Order::timestamp>,
-          boost::multi_index::const_mem_fun<Order, SequenceNumber, &Order::sequenceNumber>
+          Entry,
+          boost::multi_index::const_mem_fun<Entry, Price, &Entry::price>,
+          boost::multi_index::const_mem_fun<Entry, SequenceNumber, &Entry::sequenceNumber>
         >,
         boost::multi_index::composite_key_compare<
-          std::greater<Price>, std::less<Timestamp>, std::less<SequenceNumber>
+          std::greater<Price>, std::less<SequenceNumber>
         >
-      >,
-      boost::multi_index::hashed_unique<
-        boost::multi_index::tag<by_order_id>,
-        boost::multi_index::const_mem_fun<Order, OrderId, &Order::clientOrderId>
       >
-    >
+    >,
+    PoolAllocator<Entry>
   >;
 
-  AskBook askBook_;
-  BidBook bidBook_;
+  AskBook askBook_ {typename AskBook::ctor_args_list(), PoolAllocator<Entry>(nodeArena_.get())};
+  BidBook bidBook_ {typename BidBook::ctor_args_list(), PoolAllocator<Entry>(nodeArena_.get())};
+
+  // price -> totals for every level of a side, kept in step with the books by the insert/match/cancel paths
+  // so depth (and the top of book) never walks the orders
+  struct LevelTotals {
+    Quantity quantity {0};
+    uint32_t orderCount {0};
+  };
+  template <class Compare>
+  using Levels = std::map<Price, LevelTotals, Compare, PoolAllocator<std::pair<const Price, LevelTotals>>>;
+
+  Levels<std::less<Price>> askLevels_ {PoolAllocator<std::pair<const Price, LevelTotals>>(nodeArena_.get())};
+  Levels<std::greater<Price>> bidLevels_ {PoolAllocator<std::pair<const Price, LevelTotals>>(nodeArena_.get())};
+
+  // exchange order id -> resting order (both sides) + its cold details, this is what cancels go through
+  // element addresses are stable in the books, iterator_to gets us back to the node
+  OrderIdMap<const Entry, OrderDetails> orderIds_;
+
+  // time priority, per book so it's only ever touched by the book's shard thread
+  SequenceNumber sequenceNumber_ {0};
+
+  FillBuffer fills_;
+  bool inBatch_ {false};
+  // the match point stamp of the fills, moved once per batch (or per order outside one), not per fill
+  CoarseClock matchClock_;
+
+  // best level of each side, a copy of the first entry of the level totals
+  // refreshed whenever the insert/match/cancel paths touch the top
+  PriceLevel bidTop_ {};
+  PriceLevel askTop_ {};
+
+  bool publishTopOfBook_ {false};
+  TopOfBookReport publishedTop_ {};
+
+  PriceLevel& topOf(Side side) { return side == Side::Buy ? bidTop_ : askTop_; }
+  template <class F>
+  void withLevels(Side side, F&& f) {
+    if (side == Side::Buy) {
+      f(bidLevels_);
+    } else {
+      f(askLevels_);
+    }
+  }
+  void onOrderAdded(Side side, Price price, Quantity openQuantity);
+  void onOrderRemoved(Side side, Price price, Quantity openQuantity);
+  void onFill(Side restingSide, Quantity filled, bool orderFilled);
+  static PriceLevel bestLevel(const auto& levels);
+  static uint32_t copyLevels(const auto& levels, std::size_t numLevels, std::span<PriceLevel> out);
+  void publishTopOfBookIfChanged();
+  void publishDelta(BookDelta::Action action, Side side, const Entry& entry, Quantity quantity);
 
-  uint64_t nextSequenceNumber();
+  SequenceNumber nextSequenceNumber() { return sequenceNumber_++; }
 
   bool isAggressive(const NewOrderEvent& event, auto& container, auto cmpFunc);
   void handleAggressiveOrder(const NewOrderEvent& event, auto& sameSideContainer, auto& opposideSideBook, auto cmpFunc);
   bool handleNewOrder(const NewOrderEvent& event, auto& sameSideBook, auto& oppositeSideBook, auto cmpFunc);
+  bool addOrder(const NewOrderEvent& event, auto& sameSideContainer, Quantity filledQuantity);
 
-  void reportFills(ExecutionReportCollection&& fills);
+  bool dispatch(const Event& event);
+
+  void recordFill(OrderId restingOrderId, OrderId aggressiveOrderId, Quantity filled, Price price);
+  void reportFills();
+  void reportOrderAccepted(const Entry& entry);
   void reportNewOrderCanceled(const NewOrderEvent& event, Quantity filledQuantity);
-  void reportOrderCanceled(const Order& order);
+  void reportOrderCanceled(const RestingOrder& order);
 
 };
 
-template <ReportSinkConcept ReportSink>
-bool OrderBook<ReportSink>::submitNewOrder(const NewOrderEvent& event) {
+template <ReportSinkConcept ReportSink, BookFeedConcept Feed>
+bool OrderBook<ReportSink, Feed>::submitNewOrder(const NewOrderEvent& event) {
+  // nothing to match or rest, and a negative open quantity would poison the level totals
+  if (event.quantity() <= 0) {
+    return false;
+  }
 
   // buy crosses asks: market always crosses; otherwise limit >= best ask
   auto crossesBuy = [](const NewOrderEvent& ev, Price bestAsk) noexcept {
@@ -129,9 +239,13 @@ bool OrderBook<ReportSink>::submitNewOrder(const NewOrderEvent& event) {
     return ev.type() == Type::Market || ev.price() <= bestBid;
   };
   if (event.side() == Side::Buy) {
-    return handleNewOrder(event, bidBook_, askBook_, crossesBuy);
+    const bool result = handleNewOrder(event, bidBook_, askBook_, crossesBuy);
+    publishTopOfBookIfChanged();
+    return result;
   } else if (event.side() == Side::Sell) {
-    return handleNewOrder(event, askBook_, bidBook_, crossesSell);
+    const bool result = handleNewOrder(event, askBook_, bidBook_, crossesSell);
+    publishTopOfBookIfChanged();
+    return result;
   } else {
     std::cout << "OrderBook::submitNewOrder: Invalid side" << std::endl;
     // throw an exception once we are doing exception handling properly
@@ -139,51 +253,104 @@ bool OrderBook<ReportSink>::submitNewOrder(const NewOrderEvent& event) {
   }
 }
 
-template <ReportSinkConcept ReportSink>
-bool OrderBook<ReportSink>::submitCancelOrder(const CancelOrderEvent& event) {
-  auto cancelOrder = [this](auto& book, auto orderId) {
-    auto& container = book.template get<by_order_id>();
-    if (auto it = container.find(orderId); it != container.end()) {
-      Order snapshot = *it;
-      container.erase(it);
-      snapshot.cancel();
-      reportOrderCanceled(snapshot);
-      return true;
-    }
+template <ReportSinkConcept ReportSink, BookFeedConcept Feed>
+bool OrderBook<ReportSink, Feed>::submitCancelOrder(const CancelOrderEvent& event) {
+  const Entry* entry = orderIds_.find(event.origOrderId());
+  if (!entry) {
     return false;
-  };
-  const auto id = event.origOrderId();
-  bool onBid = cancelOrder(bidBook_, id);
-  bool onAsk = !onBid && cancelOrder(askBook_, id);
-  assert(!(onBid && onAsk) && "Order ID present on both sides!");
-  return onBid || onAsk;
+  }
+
+  // the side is the one thing we need from the cold details
+  const Side side = orderIds_.cold(event.origOrderId()).side_;
+  const Entry snapshot = *entry;
+  publishDelta(BookDelta::Action::Delete, side, snapshot, snapshot.order_.openQuantity_);
+  orderIds_.erase(event.origOrderId());
+  if (side == Side::Buy) {
+    bidBook_.erase(bidBook_.iterator_to(*entry));
+  } else {
+    askBook_.erase(askBook_.iterator_to(*entry));
+  }
+  onOrderRemoved(side, snapshot.price_, snapshot.order_.openQuantity_);
+  reportOrderCanceled(snapshot.order_);
+  publishTopOfBookIfChanged();
+  return true;
+}
+
+template <ReportSinkConcept ReportSink, BookFeedConcept Feed>
+void OrderBook<ReportSink, Feed>::submitTopOfBook(const TopOfBookEvent& event) {
+  reportFills();
+  reportSink_->submitTopOfBook(topOfBook());
 }
 
-template <ReportSinkConcept ReportSink>
-void OrderBook<ReportSink>::submitTopOfBook(const TopOfBookEvent& event) {
-  reportSink_->submitTopOfBook(TopOfBookReport{symbol_,
-              bidBook_.empty() ? Order() : *bidBook_.begin(), 
-              askBook_.empty() ? Order() : *askBook_.begin()});
+template <ReportSinkConcept ReportSink, BookFeedConcept Feed>
+void OrderBook<ReportSink, Feed>::submitDepth(const DepthEvent& event) {
+  reportFills();
+  reportSink_->submitDepth(depth(event.levels()));
 }
 
+template <ReportSinkConcept ReportSink, BookFeedConcept Feed>
+DepthReport OrderBook<ReportSink, Feed>::depth(std::size_t numLevels) const {
+  DepthReport report;
+  report.symbol_ = symbol_;
+  report.bidCount_ = copyLevels(bidLevels_, numLevels, report.bids_);
+  report.askCount_ = copyLevels(askLevels_, numLevels, report.asks_);
+  return report;
+}
 
+template <ReportSinkConcept ReportSink, BookFeedConcept Feed>
+std::size_t OrderBook<ReportSink, Feed>::submitBatch(std::span<const Event> events) {
+  if constexpr (BatchingReportSink<ReportSink>) {
+    reportSink_->beginBatch();
+  }
+  inBatch_ = true;
+  matchClock_.update();
+
+  std::size_t accepted = 0;
+  for (const auto& event : events) {
+    accepted += dispatch(event);
+  }
+
+  inBatch_ = false;
+  reportFills();
+  if constexpr (BatchingReportSink<ReportSink>) {
+    reportSink_->endBatch();
+  }
+  return accepted;
+}
 
-template <ReportSinkConcept ReportSink>
-uint64_t OrderBook<ReportSink>::nextSequenceNumber() {
-  static uint64_t sequenceNumber = 0;
-  return sequenceNumber++;
+template <ReportSinkConcept ReportSink, BookFeedConcept Feed>
+bool OrderBook<ReportSink, Feed>::dispatch(const Event& event) {
+  // qualified calls, no need to go through the vtable from in here
+  return std::visit([this](const auto& ev) {
+    using T = std::decay_t<decltype(ev)>;
+    if constexpr (std::is_same_v<T, NewOrderEvent>) {
+      return OrderBook::submitNewOrder(ev);
+    } else if constexpr (std::is_same_v<T, CancelOrderEvent>) {
+      return OrderBook::submitCancelOrder(ev);
+    } else if constexpr (std::is_same_v<T, TopOfBookEvent>) {
+      OrderBook::submitTopOfBook(ev);
+      return true;
+    } else if constexpr (std::is_same_v<T, DepthEvent>) {
+      OrderBook::submitDepth(ev);
+      return true;
+    } else {
+      return false;
+    }
+  }, event.data_);
 }
 
-template <ReportSinkConcept ReportSink>
-bool OrderBook<ReportSink>::isAggressive(const NewOrderEvent& event, auto& container, auto cmpFunc) {
+
+
+template <ReportSinkConcept ReportSink, BookFeedConcept Feed>
+bool OrderBook<ReportSink, Feed>::isAggressive(const NewOrderEvent& event, auto& container, auto cmpFunc) {
   auto best = container.begin();
   return best != container.end() && cmpFunc(event, best->price());
 }
 
-template <ReportSinkConcept ReportSink>
-bool OrderBook<ReportSink>::handleNewOrder(const NewOrderEvent& event, auto& sameSideBook, auto& oppositeSideBook, auto cmpFunc) {
-  auto& sameSideContainer = sameSideBook.template get<by_price_time_seq>();
-  auto& oppositeSideContainer = oppositeSideBook.template get<by_price_time_seq>();
+template <ReportSinkConcept ReportSink, BookFeedConcept Feed>
+bool OrderBook<ReportSink, Feed>::handleNewOrder(const NewOrderEvent& event, auto& sameSideBook, auto& oppositeSideBook, auto cmpFunc) {
+  auto& sameSideContainer = sameSideBook.template get<by_price_seq>();
+  auto& oppositeSideContainer = oppositeSideBook.template get<by_price_seq>();
 
   if (isAggressive(event, oppositeSideContainer, cmpFunc)) { 
     handleAggressiveOrder(event, sameSideContainer, oppositeSideBook, cmpFunc);
@@ -202,7 +369,7 @@ bool OrderBook<ReportSink>::handleNewOrder(const NewOrderEvent& event, auto& sam
         break;
       case Type::Limit:
         {
-          return sameSideContainer.emplace(event, nextSequenceNumber()).second;
+          return addOrder(event, sameSideContainer, 0);
         }
         break;
       default:
@@ -214,58 +381,197 @@ bool OrderBook<ReportSink>::handleNewOrder(const NewOrderEvent& event, auto& sam
   return false;
 }
 
-template <ReportSinkConcept ReportSink>
-void OrderBook<ReportSink>::handleAggressiveOrder(const NewOrderEvent& event, auto& sameSideContainer, auto& opposideSideBook, auto cmpFunc) {
-  auto& oppositeSideContainer = opposideSideBook.template get<by_price_time_seq>();
+template <ReportSinkConcept ReportSink, BookFeedConcept Feed>
+void OrderBook<ReportSink, Feed>::handleAggressiveOrder(const NewOrderEvent& event, auto& sameSideContainer, auto& opposideSideBook, auto cmpFunc) {
+  auto& oppositeSideContainer = opposideSideBook.template get<by_price_seq>();
+  // we only ever fill from the front, i.e. the top level of the opposite side
+  const Side restingSide = event.side() == Side::Buy ? Side::Sell : Side::Buy;
+  // outside a batch the order is the batch
+  if (!inBatch_) {
+    matchClock_.update();
+  }
 
-  ExecutionReportCollection fills;
   Quantity filledQuantity = 0;
   auto it = oppositeSideContainer.begin(); 
   while (filledQuantity < event.quantity() && it != oppositeSideContainer.end() && cmpFunc(event, it->price())) {
     auto leaveQuantity = event.quantity() - filledQuantity;
 
     Quantity filled {};
-    Price fillPrice { INVALID_PRICE };
-    bool modified = oppositeSideContainer.modify(it, [&](Order& order) {
-      filled = order.fill(leaveQuantity);
-      fillPrice = order.price();
+    [[maybe_unused]] bool modified = oppositeSideContainer.modify(it, [&](Entry& entry) {
+      filled = entry.order_.fill(leaveQuantity);
     });
 
     assert(modified);
 
-    fills.emplace_back(symbol_, it->clientOrderId(), event.clientOrderId(), filled, fillPrice);
-    fills.emplace_back(symbol_, event.clientOrderId(), it->clientOrderId(), filled, fillPrice);
+    recordFill(it->order_.clientOrderId_, event.clientOrderId(), filled, it->price_);
+    publishDelta(BookDelta::Action::Execute, restingSide, *it, filled);
 
     filledQuantity += filled;
 
-    it = it->state() == OrderState::Filled ? oppositeSideContainer.erase(it) : std::next(it);
+    const bool orderFilled = it->order_.isFilled();
+    onFill(restingSide, filled, orderFilled);
+    if (orderFilled) {
+      orderIds_.erase(it->order_.exchangeOrderId_);
+      it = oppositeSideContainer.erase(it);
+    } else {
+      ++it;
+    }
   }
 
-  reportFills(std::move(fills));
+  // in a batch the fills pile up until something else gets reported (or the batch ends)
+  if (!inBatch_) {
+    reportFills();
+  }
 
   if (filledQuantity != event.quantity()) {
     // no more fills so canceling the rest of the order (FILL&KILL)
     if (it == oppositeSideContainer.end()) {
       reportNewOrderCanceled(event, filledQuantity);
     } else {
-      sameSideContainer.emplace(event, nextSequenceNumber(), filledQuantity).second;
+      addOrder(event, sameSideContainer, filledQuantity);
+    }
+  }
+}
+
+template <ReportSinkConcept ReportSink, BookFeedConcept Feed>
+bool OrderBook<ReportSink, Feed>::addOrder(const NewOrderEvent& event, auto& sameSideContainer, Quantity filledQuantity) {
+  assert(filledQuantity <= event.quantity());
+  const auto id = orderIds_.nextId();
+  const auto sequenceNumber = nextSequenceNumber();
+  const Quantity openQuantity = event.quantity() - filledQuantity;
+  auto [it, inserted] = sameSideContainer.insert(Entry{event.price(), sequenceNumber,
+                                                       RestingOrder{id, openQuantity, event.clientOrderId()}});
+  if (!inserted) {
+    return false;
+  }
+  orderIds_.insert(id, &*it, OrderDetails{event.userId(), event.price(), event.timestamp(), sequenceNumber,
+                                          event.quantity(), event.side(), event.type()});
+  onOrderAdded(event.side(), event.price(), openQuantity);
+  publishDelta(BookDelta::Action::Add, event.side(), *it, openQuantity);
+  reportOrderAccepted(*it);
+  return true;
+}
+
+template <ReportSinkConcept ReportSink, BookFeedConcept Feed>
+void OrderBook<ReportSink, Feed>::onOrderAdded(Side side, Price price, Quantity openQuantity) {
+  withLevels(side, [&](auto& levels) {
+    auto& totals = levels[price];
+    totals.quantity += openQuantity;
+    ++totals.orderCount;
+    if (levels.begin()->first == price) {
+      topOf(side) = bestLevel(levels);
+    }
+  });
+}
+
+// called once the order is out of the book (canceled)
+template <ReportSinkConcept ReportSink, BookFeedConcept Feed>
+void OrderBook<ReportSink, Feed>::onOrderRemoved(Side side, Price price, Quantity openQuantity) {
+  withLevels(side, [&](auto& levels) {
+    auto it = levels.find(price);
+    assert(it != levels.end() && "OrderBook: no level for a resting order");
+    it->second.quantity -= openQuantity;
+    if (--it->second.orderCount == 0) {
+      levels.erase(it);
+    }
+    if (price == topOf(side).price_) {
+      topOf(side) = bestLevel(levels);
+    }
+  });
+}
+
+// fills always come off the top level of the resting side
+template <ReportSinkConcept ReportSink, BookFeedConcept Feed>
+void OrderBook<ReportSink, Feed>::onFill(Side restingSide, Quantity filled, bool orderFilled) {
+  withLevels(restingSide, [&](auto& levels) {
+    auto it = levels.begin();
+    assert(it != levels.end() && "OrderBook: fill on an empty side");
+    it->second.quantity -= filled;
+    if (orderFilled && --it->second.orderCount == 0) {
+      levels.erase(it);
+    }
+    topOf(restingSide) = bestLevel(levels);
+  });
+}
+
+template <ReportSinkConcept ReportSink, BookFeedConcept Feed>
+PriceLevel OrderBook<ReportSink, Feed>::bestLevel(const auto& levels) {
+  if (levels.empty()) {
+    return {};
+  }
+  const auto& [price, totals] = *levels.begin();
+  return PriceLevel{price, totals.quantity, totals.orderCount};
+}
+
+template <ReportSinkConcept ReportSink, BookFeedConcept Feed>
+uint32_t OrderBook<ReportSink, Feed>::copyLevels(const auto& levels, std::size_t numLevels, std::span<PriceLevel> out) {
+  numLevels = std::min(numLevels, out.size());
+  uint32_t count = 0;
+  for (auto it = levels.begin(); it != levels.end() && count < numLevels; ++it) {
+    out[count++] = PriceLevel{it->first, it->second.quantity, it->second.orderCount};
+  }
+  return count;
+}
+
+template <ReportSinkConcept ReportSink, BookFeedConcept Feed>
+void OrderBook<ReportSink, Feed>::publishTopOfBookIfChanged() {
+  if (!publishTopOfBook_) {
+    return;
+  }
+  const auto top = topOfBook();
+  if (top.bid_ == publishedTop_.bid_ && top.ask_ == publishedTop_.ask_) {
+    return;
+  }
+  publishedTop_ = top;
+  reportFills();
+  reportSink_->submitTopOfBook(TopOfBookReport{top});
+}
+
+template <ReportSinkConcept ReportSink, BookFeedConcept Feed>
+void OrderBook<ReportSink, Feed>::publishDelta(BookDelta::Action action, Side side, const Entry& entry, Quantity quantity) {
+  if constexpr (HAS_FEED) {
+    if (feed_) {
+      feed_->submitDelta(BookDelta{++feedSequenceNumber_, entry.order_.exchangeOrderId_, entry.price_, symbol_,
+                                   quantity, side, action});
     }
   }
 }
 
-template <ReportSinkConcept ReportSink>
-void OrderBook<ReportSink>::reportNewOrderCanceled(const NewOrderEvent& event, Quantity filledQuantity) {
+template <ReportSinkConcept ReportSink, BookFeedConcept Feed>
+void OrderBook<ReportSink, Feed>::reportOrderAccepted(const Entry& entry) {
+  reportFills();
+  reportSink_->submitAcceptedOrder(OrderAcceptedReport{symbol_, entry.order_.clientOrderId_, entry.order_.exchangeOrderId_,
+                                                       entry.order_.openQuantity_, entry.price_});
+}
+
+template <ReportSinkConcept ReportSink, BookFeedConcept Feed>
+void OrderBook<ReportSink, Feed>::reportNewOrderCanceled(const NewOrderEvent& event, Quantity filledQuantity) {
+  reportFills();
   reportSink_->submitCanceledOrder(OrderCanceledReport{symbol_, event.clientOrderId(), event.quantity() - filledQuantity, CancelReason::Fill_And_Kill});
 }
 
-template <ReportSinkConcept ReportSink>
-void OrderBook<ReportSink>::reportOrderCanceled(const Order& order) {
-  reportSink_->submitCanceledOrder(OrderCanceledReport{symbol_, order.clientOrderId(), order.openQuantity(), CancelReason::User_Canceled});
+template <ReportSinkConcept ReportSink, BookFeedConcept Feed>
+void OrderBook<ReportSink, Feed>::reportOrderCanceled(const RestingOrder& order) {
+  reportFills();
+  reportSink_->submitCanceledOrder(OrderCanceledReport{symbol_, order.clientOrderId_, order.openQuantity_, CancelReason::User_Canceled});
 }
 
-template <ReportSinkConcept ReportSink>
-void OrderBook<ReportSink>::reportFills(ExecutionReportCollection&& fills) {
-  reportSink_->submitFills(std::move(fills));
+template <ReportSinkConcept ReportSink, BookFeedConcept Feed>
+void OrderBook<ReportSink, Feed>::recordFill(OrderId restingOrderId, OrderId aggressiveOrderId, Quantity filled, Price price) {
+  if (!fills_.hasRoomFor(2)) {
+    reportFills();
+  }
+  const auto matched = matchClock_.now();
+  fills_.add(symbol_, restingOrderId, aggressiveOrderId, filled, price, matched);
+  fills_.add(symbol_, aggressiveOrderId, restingOrderId, filled, price, matched);
+}
+
+template <ReportSinkConcept ReportSink, BookFeedConcept Feed>
+void OrderBook<ReportSink, Feed>::reportFills() {
+  if (!fills_.empty()) {
+    reportSink_->submitFills(fills_.reports());
+    fills_.clear();
+  }
 }
 
 
@@ -5,14 +5,24 @@
 #include <thread>
 #include <semaphore>
 #include <atomic>
+#include <algorithm>
+#include <array>
+#include <concepts>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <span>
+#include <type_traits>
 #include <vector>
 
+#include <boost/container/small_vector.hpp>
 #include <boost/lockfree/queue.hpp>
 
 #include "OrderBook.h"
 #include "Event.h"
 #include "OrderUtils.h"
 #include "ReportSink.h"
+#include "SymbolRegistry.h"
 
 namespace Exchange {
 
@@ -21,36 +31,81 @@ namespace Exchange {
     virtual ~IOrderBookManager() = 0;
 
     virtual bool submit(Event event) = 0;
+    // a burst of events (e.g. one datagram's worth), each shard is woken once for its share
+    // returns how many were queued
+    virtual std::size_t submit(std::span<const Event> events) = 0;
 
+    virtual void stop() = 0;
   };
 
-class OrderBookManager : public IOrderBookManager {
+namespace detail {
+  void backoff(unsigned n);
+}
+
+// Book = IOrderBook, or a concrete book the manager can keep by value and build the missing books of:
+// movable, with a ReportSinkType that's built from the registry (the ReportSink prints prices in its specs),
+// and built from the symbol and its sink, plus the registry's reference price if it takes one (LadderOrderBook).
+template <class Book>
+concept ManagedBook = std::is_abstract_v<Book> ||
+  (std::move_constructible<Book> &&
+   std::constructible_from<typename Book::ReportSinkType, const SymbolRegistry&> &&
+   (std::constructible_from<Book, Symbol, std::unique_ptr<typename Book::ReportSinkType>, Price> ||
+    std::constructible_from<Book, Symbol, std::unique_ptr<typename Book::ReportSinkType>>));
+
+// Routes events to per-symbol books, spread over a few shard threads.
+// Every symbol of the SymbolRegistry gets a book, symbols are dealt round robin over the shards.
+// Routing is one index into a flat SymbolId -> (shard, slot) table built here, no hashing per event.
+//
+// Book = IOrderBook: books are owned through unique_ptr and every call is virtual, tests and mocks plug in here.
+// Book = a concrete (final) book, e.g. OrderBook<ReportSink> or LadderOrderBook<ReportSink>: each shard keeps
+// its books by value in a vector, nothing virtual between the shard loop and the matching code so it can all be inlined.
+template <ManagedBook Book>
+class BasicOrderBookManager : public IOrderBookManager {
 public:
-    using OrderBookMap = std::unordered_map<Symbol, std::unique_ptr<IOrderBook>>;
+    static constexpr bool IS_VIRTUAL = std::is_abstract_v<Book>;
+    using BookHolder = std::conditional_t<IS_VIRTUAL, std::unique_ptr<Book>, Book>;
+    using OrderBookMap = std::unordered_map<Symbol, BookHolder>;
 
     // TODO: change this to one OrderBook and we'll call clone() on it
-    OrderBookManager(OrderBookMap && map, int numShards = std::thread::hardware_concurrency() / 2);
+    BasicOrderBookManager(OrderBookMap && map, int numShards = std::thread::hardware_concurrency() / 2,
+                          const SymbolRegistry& symbols = SymbolRegistry::global());
 
-    ~OrderBookManager();
+    ~BasicOrderBookManager();
 
     bool submit(Event event) override;
+    std::size_t submit(std::span<const Event> events) override;
 
-    void stop();
+    void stop() override;
 
 private:
 
+    // where the book of a SymbolId lives, NO_SLOT for an id without a book
+    struct Route {
+      static constexpr uint32_t NO_SLOT = std::numeric_limits<uint32_t>::max();
+
+      uint32_t shard_ {0};
+      uint32_t slot_ {NO_SLOT};
+    };
+
     struct Shard {
       static constexpr unsigned QUEUE_CAPACITY = 1024;
+      static constexpr unsigned MAX_BATCH_SIZE = 32;
+
       void start();
       void stop();
 
-
+      // returns the slot of the book
+      uint32_t addBook(BookHolder&& book);
+      Book* findBook(SymbolId symbolId);
 
       bool submit(Event&& event);
+      // queue without waking the thread, notify() once for the lot
+      bool push(const Event& event);
+      void notify(std::ptrdiff_t count);
 
       void processEvents();
-      void processEvent(Event&& event);
-
+      // consecutive events for the same symbol go to their book in one submitBatch()
+      void processBatch(std::span<const Event> events);
 
 
       static_assert(std::is_trivially_copyable_v<Event>, "Event must be trivially copyable for lock-free queue");
@@ -58,20 +113,249 @@ private:
       std::counting_semaphore<> semaphore_{ 0};
       std::atomic<bool> stopRequested_ {false};
 
-      OrderBookMap orderBooks_; 
-      // kust be initialized fully before we access cuz 
+      // kust be initialized fully before we access cuz
       // going to do it concurrently
       // so we can't have any data races
+      std::vector<BookHolder> books_;
+      // the manager's table, fixed before the thread starts
+      std::span<const Route> routes_;
       std::jthread thread_;
     };
 
-    size_t shardIdx(Symbol symbol) const;
+    BookHolder makeDefaultBook(SymbolId id) const;
+
+    const Route& route(Event& event) const;
 
     std::atomic<bool> stopRequested_ {false};
+    const SymbolRegistry& symbols_;
+    // indexed by SymbolId, routes_[INVALID_SYMBOL_ID] sends unknown symbols to shard 0 which has no book for them
+    std::vector<Route> routes_;
     std::vector<std::unique_ptr<Shard>> shards_;
 
 };
 
+using OrderBookManager = BasicOrderBookManager<IOrderBook>;
+
+template <ManagedBook Book>
+BasicOrderBookManager<Book>::BasicOrderBookManager(OrderBookMap&& map, int numShards, const SymbolRegistry& symbols)
+  : symbols_(symbols)
+{
+  // // at least 2 threads otherwise what's even the point amirite
+  numShards = std::max(2, numShards);
+  shards_.reserve(numShards);
+  for (int i = 0; i < numShards; ++i) {
+    shards_.emplace_back(std::make_unique<Shard>());
+  }
+
+  routes_.resize(symbols_.size() + 1);
+  for (SymbolId id = 1; id <= symbols_.size(); ++id) {
+    const auto symbol = symbols_.symbol(id);
+    auto& route = routes_[id];
+    route.shard_ = static_cast<uint32_t>((id - 1) % shards_.size());
+
+    auto it = map.find(symbol);
+    auto& shard = shards_[route.shard_];
+    if (it == map.end()) {
+      route.slot_ = shard->addBook(makeDefaultBook(id));
+    }
+    else {
+      route.slot_ = shard->addBook(std::move(it->second));
+    }
+  }
+
+  std::ranges::for_each(shards_, [this](auto& shard) {
+    shard->routes_ = routes_;
+    shard->start();
+  });
+}
+
+template <ManagedBook Book>
+BasicOrderBookManager<Book>::~BasicOrderBookManager() {
+  stop();
+}
+
+template <ManagedBook Book>
+void BasicOrderBookManager<Book>::stop() {
+  if (!stopRequested_.exchange(true)) {
+    for (auto& shard : shards_) {
+      shard->stop();
+    }
+  }
+}
+
+template <ManagedBook Book>
+bool BasicOrderBookManager<Book>::submit(Event event) {
+  if (stopRequested_.load()) {
+    return false;
+  }
+
+  return shards_[route(event).shard_]->submit(std::move(event));
+}
+
+template <ManagedBook Book>
+std::size_t BasicOrderBookManager<Book>::submit(std::span<const Event> events) {
+  if (stopRequested_.load()) {
+    return 0;
+  }
+
+  // per shard, on the stack unless there are a lot of shards
+  boost::container::small_vector<std::ptrdiff_t, 16> queued(shards_.size(), 0);
+  std::size_t total {0};
+  for (Event event : events) {
+    const auto shard = route(event).shard_;
+    if (shards_[shard]->push(event)) {
+      ++queued[shard];
+      ++total;
+    }
+  }
+  for (std::size_t shard = 0; shard < shards_.size(); ++shard) {
+    if (queued[shard] > 0) {
+      shards_[shard]->notify(queued[shard]);
+    }
+  }
+  return total;
+}
+
+template <ManagedBook Book>
+typename BasicOrderBookManager<Book>::BookHolder BasicOrderBookManager<Book>::makeDefaultBook(SymbolId id) const {
+  const auto symbol = symbols_.symbol(id);
+  if constexpr (IS_VIRTUAL) {
+    return std::make_unique<OrderBook<ReportSink>>(symbol, std::make_unique<ReportSink>(symbols_));
+  } else if constexpr (std::constructible_from<Book, Symbol, std::unique_ptr<typename Book::ReportSinkType>, Price>) {
+    return Book(symbol, std::make_unique<typename Book::ReportSinkType>(symbols_), symbols_.referencePrice(id));
+  } else {
+    return Book(symbol, std::make_unique<typename Book::ReportSinkType>(symbols_));
+  }
+}
+
+template <ManagedBook Book>
+const typename BasicOrderBookManager<Book>::Route& BasicOrderBookManager<Book>::route(Event& event) const {
+  auto id = event.symbolId();
+  if (id == INVALID_SYMBOL_ID) {
+    // didn't come through the parser (or isn't a symbol we trade), resolve it here once so the shard can use the id
+    id = symbols_.find(event.symbol());
+    event.setSymbolId(id);
+  }
+  return routes_[id < routes_.size() ? id : INVALID_SYMBOL_ID];
+}
+
+template <ManagedBook Book>
+void BasicOrderBookManager<Book>::Shard::start() {
+  thread_ = std::jthread([this]() { processEvents(); });
+}
+
+template <ManagedBook Book>
+void BasicOrderBookManager<Book>::Shard::stop() {
+  if (!stopRequested_.exchange(true)) {
+    semaphore_.release(1);
+    thread_.join();
+  }
+}
+
+template <ManagedBook Book>
+uint32_t BasicOrderBookManager<Book>::Shard::addBook(BookHolder&& book) {
+  books_.push_back(std::move(book));
+  return static_cast<uint32_t>(books_.size() - 1);
+}
+
+template <ManagedBook Book>
+Book* BasicOrderBookManager<Book>::Shard::findBook(SymbolId symbolId) {
+  if (symbolId >= routes_.size() || routes_[symbolId].slot_ == Route::NO_SLOT) {
+    return nullptr;
+  }
+  auto& book = books_[routes_[symbolId].slot_];
+  if constexpr (IS_VIRTUAL) {
+    return book.get();
+  } else {
+    return &book;
+  }
+}
+
+template <ManagedBook Book>
+bool BasicOrderBookManager<Book>::Shard::submit(Event&& event) {
+  if (stopRequested_.load()) {
+    return false;
+  }
+  // TODO: review this, moving from the event but might still return false
+  if (!eventQueue_.push(std::move(event))) {
+    return false;
+  }
+  semaphore_.release(1);
+  return true;
+}
+
+template <ManagedBook Book>
+bool BasicOrderBookManager<Book>::Shard::push(const Event& event) {
+  return !stopRequested_.load() && eventQueue_.push(event);
+}
+
+template <ManagedBook Book>
+void BasicOrderBookManager<Book>::Shard::notify(std::ptrdiff_t count) {
+  semaphore_.release(count);
+}
+
+template <ManagedBook Book>
+void BasicOrderBookManager<Book>::Shard::processEvents() {
+  std::array<Event, MAX_BATCH_SIZE> batch;
+  while (true) {
+      semaphore_.acquire();
+      if (stopRequested_.load()) {
+        break;
+      }
+
+      std::size_t count {0};
+      unsigned int spinCount {0};
+      while (!eventQueue_.pop(batch[count])) {
+        detail::backoff(spinCount++);
+      }
+      ++count;
+
+      // opportunistic batching
+      while (!stopRequested_.load() && count < MAX_BATCH_SIZE && semaphore_.try_acquire()) {
+          if (stopRequested_.load()) {
+            semaphore_.release(); // return the token so a blocked worker can wake
+            break;
+          }
+
+          if (eventQueue_.pop(batch[count])) { ++count; }
+          else { semaphore_.release(1); break; } // return token if we lost the race
+      }
+
+      processBatch(std::span<const Event>(batch.data(), count));
+    }
+
+    // TODO: decide if want to drain the queue here
+}
+
+template <ManagedBook Book>
+void BasicOrderBookManager<Book>::Shard::processBatch(std::span<const Event> events) {
+  while (!events.empty()) {
+    const auto symbolId = events.front().symbolId();
+    auto runEnd = std::ranges::find_if(events, [symbolId](const Event& event) { return event.symbolId() != symbolId; });
+    const auto run = events.first(static_cast<std::size_t>(runEnd - events.begin()));
+    events = events.subspan(run.size());
+
+    if (Book* book = findBook(symbolId)) {
+      book->submitBatch(run);
+      continue;
+    }
+
+    for (const auto& event : run) {
+      std::visit([](const auto& ev) {
+        using T = std::decay_t<decltype(ev)>;
+        if constexpr (HasSymbol<T>) {
+          std::cout << "OrderBookManager::processEvent: Symbol not found: " << toString(ev.eventType()) << " " << ev.symbol() << std::endl;
+        } else {
+          std::cout << "Unknown Event "  << '\n';
+        }
+      }, event.data_);
+    }
+  }
+}
+
+// the virtual one is compiled once, in OrderBookManager.cpp
+extern template class BasicOrderBookManager<IOrderBook>;
+
 } // namespace Exchange
 
-#endif // ORDER_BOOK_MANAGER_H 
\ No newline at end of file
+#endif // ORDER_BOOK_MANAGER_H
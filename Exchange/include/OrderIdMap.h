@@ -0,0 +1,175 @@
+#ifndef ORDER_ID_MAP_H
+#define ORDER_ID_MAP_H
+
+#include "OrderUtils.h"
+
+#include <cassert>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace Exchange {
+
+// Exchange order id -> resting order.
+// An open addressed table (linear probing, robin hood order) with the id itself as the hash: we hand out the ids
+// ourselves, in increasing order, so live ids are mostly a contiguous run and land in consecutive slots of their own.
+// insert/find/erase are an index and a compare, a probe or two past a long resting order at most.
+// The table doubles past half full and never shrinks (a book swept empty and refilled would keep rehashing),
+// so it's sized by the most orders that ever rested at once, not by how many ids were handed out.
+// Erase shifts the probe run back (up to the first entry in its home slot), no tombstones.
+//
+// Cold, if given, is stored by value in a second array parallel to the slots: the bits of an order
+// the hot paths don't need, looked up by the same id only when reporting.
+template <class T, class Cold = void>
+class OrderIdMap {
+public:
+  static constexpr bool HAS_COLD = !std::is_void_v<Cold>;
+  struct NoCold {};
+  using ColdSlot = std::conditional_t<HAS_COLD, Cold, NoCold>;
+
+  static constexpr std::size_t MIN_CAPACITY = 64;
+
+  // id the next insert has to use
+  ExchangeOrderId nextId() const noexcept { return nextId_; }
+
+  void insert([[maybe_unused]] ExchangeOrderId id, T* value) requires (!HAS_COLD) {
+    assert(id == nextId() && "OrderIdMap: ids have to be inserted in order");
+    assert(value != nullptr);
+    place(Slot{nextId_++, value}, nullptr);
+  }
+
+  void insert([[maybe_unused]] ExchangeOrderId id, T* value, const ColdSlot& cold) requires HAS_COLD {
+    assert(id == nextId() && "OrderIdMap: ids have to be inserted in order");
+    assert(value != nullptr);
+    place(Slot{nextId_++, value}, &cold);
+  }
+
+  // only for ids that are in the map
+  const ColdSlot& cold(ExchangeOrderId id) const noexcept requires HAS_COLD {
+    const auto idx = indexOf(id);
+    assert(idx != NOT_FOUND && "OrderIdMap: no cold data for an id that isn't in the map");
+    return cold_[idx];
+  }
+
+  T* find(ExchangeOrderId id) const noexcept {
+    const auto idx = indexOf(id);
+    return idx != NOT_FOUND ? slots_[idx].value_ : nullptr;
+  }
+
+  bool erase(ExchangeOrderId id) noexcept {
+    auto hole = indexOf(id);
+    if (hole == NOT_FOUND) {
+      return false;
+    }
+    --size_;
+
+    // shift the rest of the probe run back a slot, up to the first entry that already sits in its home slot
+    for (auto next = (hole + 1) & mask_; slots_[next].id_ != INVALID_EXCHANGE_ORDER_ID && distance(next) > 0;
+         next = (next + 1) & mask_) {
+      move(next, hole);
+      hole = next;
+    }
+    slots_[hole] = Slot{};
+    return true;
+  }
+
+  std::size_t size() const noexcept { return size_; }
+  bool empty() const noexcept { return size_ == 0; }
+  // slots allocated, follows the peak size() not the id range
+  std::size_t capacity() const noexcept { return slots_.size(); }
+
+  // in no particular order
+  template <class F>
+  void forEach(F&& f) const {
+    for (const auto& slot : slots_) {
+      if (slot.value_) {
+        f(slot.value_);
+      }
+    }
+  }
+
+private:
+  static constexpr std::size_t NOT_FOUND = static_cast<std::size_t>(-1);
+
+  struct Slot {
+    ExchangeOrderId id_ {INVALID_EXCHANGE_ORDER_ID};   // INVALID_EXCHANGE_ORDER_ID: empty
+    T* value_ {nullptr};
+  };
+
+  // how far the entry at idx sits past its home slot
+  std::size_t distance(std::size_t idx) const noexcept { return (idx - slots_[idx].id_) & mask_; }
+
+  std::size_t indexOf(ExchangeOrderId id) const noexcept {
+    if (id == INVALID_EXCHANGE_ORDER_ID || slots_.empty()) {
+      return NOT_FOUND;
+    }
+    // robin hood order: past an entry closer to its home than we'd be to ours, id can't be in the run
+    for (std::size_t idx = id & mask_, probe = 0;
+         slots_[idx].id_ != INVALID_EXCHANGE_ORDER_ID && distance(idx) >= probe; idx = (idx + 1) & mask_, ++probe) {
+      if (slots_[idx].id_ == id) {
+        return idx;
+      }
+    }
+    return NOT_FOUND;
+  }
+
+  void place(Slot slot, const ColdSlot* cold) {
+    if ((size_ + 1) * 2 > slots_.size()) {
+      rehash(slots_.empty() ? MIN_CAPACITY : slots_.size() * 2);
+    }
+    ColdSlot carried {};
+    if constexpr (HAS_COLD) {
+      carried = *cold;
+    }
+    // robin hood: take the slot of an entry that's closer to its home than we are, and carry on placing that one
+    auto idx = slot.id_ & mask_;
+    for (std::size_t probe = 0; slots_[idx].id_ != INVALID_EXCHANGE_ORDER_ID; idx = (idx + 1) & mask_, ++probe) {
+      if (const auto theirs = distance(idx); theirs < probe) {
+        std::swap(slot, slots_[idx]);
+        if constexpr (HAS_COLD) {
+          std::swap(carried, cold_[idx]);
+        }
+        probe = theirs;
+      }
+    }
+    slots_[idx] = slot;
+    if constexpr (HAS_COLD) {
+      cold_[idx] = carried;
+    }
+    ++size_;
+  }
+
+  void move(std::size_t from, std::size_t to) noexcept {
+    slots_[to] = slots_[from];
+    if constexpr (HAS_COLD) {
+      cold_[to] = cold_[from];
+    }
+  }
+
+  void rehash(std::size_t capacity) {
+    auto slots = std::exchange(slots_, std::vector<Slot>(capacity));
+    auto cold = std::exchange(cold_, std::vector<ColdSlot>(HAS_COLD ? capacity : 0));
+    mask_ = capacity - 1;
+    size_ = 0;
+    for (std::size_t i = 0; i < slots.size(); ++i) {
+      if (slots[i].id_ != INVALID_EXCHANGE_ORDER_ID) {
+        if constexpr (HAS_COLD) {
+          place(slots[i], &cold[i]);
+        } else {
+          place(slots[i], nullptr);
+        }
+      }
+    }
+  }
+
+  std::vector<Slot> slots_;                                // a power of two in size, or empty
+  std::vector<ColdSlot> cold_;                             // empty without Cold
+  std::size_t mask_ {0};
+  std::size_t size_ {0};
+  ExchangeOrderId nextId_ {INVALID_EXCHANGE_ORDER_ID + 1};
+};
+
+} // namespace Exchange
+
+#endif // ORDER_ID_MAP_H
@@ -3,7 +3,11 @@
 
 #include <string>
 #include <chrono>
+#include <cstdint>
+#include <expected>
 #include <format>
+#include <limits>
+#include <string_view>
 
 #include "FixedString.h"
 
@@ -47,31 +51,87 @@ struct PriceSpec {
   //   fx (pips): scale=10000 (1 = 0.0001)
   //   crypto: scale=100000000 (1 = 1e-8)
   // tick_scaled = tick size expressed in scale units
-  int32_t scale;          // >0
+  int32_t scale;          // >0, a power of ten so prices read and print as plain decimals
   int32_t tick_scaled;    // >0, divides any valid scaled price exactly
+
+  // digits after the decimal point, e.g. 2 for scale=100
+  constexpr int decimals() const noexcept {
+    int digits = 0;
+    for (int32_t s = scale; s >= 10; s /= 10) {
+      ++digits;
+    }
+    return digits;
+  }
 };
 
 inline constexpr PriceSpec TWO_DIGITS_PRICE_SPEC = PriceSpec{100, 1};
-inline constexpr double DEFAULT_TICK_SIZE = 0.01; // 1 tick = $0.01
+// for prices printed without a symbol to look the spec up for
+inline constexpr PriceSpec DEFAULT_PRICE_SPEC = TWO_DIGITS_PRICE_SPEC;
 
 constexpr Price INVALID_PRICE {Price{-1}};
 constexpr Price MARKET_PRICE {Price{std::numeric_limits<int64_t>::max()}};
 
 Price toPrice(double price, const PriceSpec& spec);
 
+enum class PriceError : uint8_t {
+  Invalid,            // not a decimal number
+  TooManyDecimals,    // more than the spec has
+  OffTick,            // not on the tick grid
+  OutOfRange,
+};
+
+// "150.25" -> ticks, integer arithmetic only, no exceptions (the ingress path rejects bad prices with it).
+std::expected<Price, PriceError> tryParsePrice(std::string_view text, const PriceSpec& spec) noexcept;
+
+// Same, throws std::invalid_argument if it's not a decimal number, has more decimals than the spec
+// or isn't on the tick grid, std::out_of_range if it doesn't fit.
+Price parsePrice(std::string_view text, const PriceSpec& spec);
+
+// ticks -> "150.25" (spec.decimals() digits after the point), no floating point either
+// writes at most MAX_PRICE_CHARS chars starting at out, returns one past the last one
+inline constexpr std::size_t MAX_PRICE_CHARS = 32;
+char* formatPrice(char* out, Price price, const PriceSpec& spec);
+std::string toString(Price price, const PriceSpec& spec);
+
+// a price along with the spec to print it with, std::format("{}", PriceText{price, spec})
+struct PriceText {
+  Price price_;
+  PriceSpec spec_;
+};
+
 
   using OrderId = int;
   constexpr OrderId INVALID_ORDER_ID = -1;
 
+  // assigned by the book when an order rests, dense and increasing per book (0 is never handed out)
+  using ExchangeOrderId = uint64_t;
+  constexpr ExchangeOrderId INVALID_EXCHANGE_ORDER_ID = 0;
+
   using Quantity = int;
   constexpr Quantity INVALID_QUANTITY = -1;
 
-  using UserId = FixedString<32>;
-  constexpr UserId INVALID_USER_ID {};
+  // most price levels per side a depth request can ask for
+  constexpr uint32_t MAX_DEPTH_LEVELS = 10;
+
+  using UserName = FixedString<32>;
+  constexpr UserName INVALID_USER_NAME {};
+
+  // handle for a UserName, see UserRegistry
+  using UserId = uint32_t;
+  constexpr UserId INVALID_USER_ID = 0;
+
+  // a UserRegistry never hands out ids with this bit set, the _uid literal always sets it
+  constexpr UserId LITERAL_USER_ID_BIT = 0x80000000u;
+
+  // fixed id for a name, for tests and benches: pure (FNV-1a of the name), never registered anywhere,
+  // so the same literal is the same id whatever ran before, and UserRegistry::name() doesn't know it
   constexpr UserId operator"" _uid(const char* s, std::size_t n) {
-      return UserId(std::string_view{s, n}); // no unbounded scan, compile-time length
+      uint32_t hash = 2166136261u;
+      for (std::size_t i = 0; i < n; ++i) {
+          hash = (hash ^ static_cast<unsigned char>(s[i])) * 16777619u;
+      }
+      return hash | LITERAL_USER_ID_BIT;
   }
-  
 
   using Symbol = FixedString<8>;
   constexpr Symbol INVALID_SYMBOL {};
@@ -79,6 +139,10 @@ Price toPrice(double price, const PriceSpec& spec);
       return Symbol(std::string_view{s, n}); // no unbounded scan, compile-time length
   }
 
+  // handle for a Symbol we trade, see SymbolRegistry
+  using SymbolId = uint32_t;
+  constexpr SymbolId INVALID_SYMBOL_ID = 0;
+
   using Timestamp = std::chrono::steady_clock::time_point;
 
   using SequenceNumber = uint64_t;
@@ -87,26 +151,29 @@ Price toPrice(double price, const PriceSpec& spec);
 
 namespace std {
 
-  template<class CharT>
-  struct formatter<Exchange::Price, CharT> {
-    // Reuse double's formatter so things like "{:.6f}", "{:>10}", etc. work.
-    bool has_custom_format = false;
-    formatter<double, CharT> base_;
-  
-    constexpr auto parse(basic_format_parse_context<CharT>& ctx) {
-      has_custom_format = (ctx.begin() != ctx.end());
+ template<>
+  struct formatter<Exchange::PriceText, char> {
+    // string formatting on top, so "{:>10}" and the like work
+    formatter<string_view, char> base_;
+
+    constexpr auto parse(basic_format_parse_context<char>& ctx) {
       return base_.parse(ctx);
     }
-  
+
+    template<class FC>
+    auto format(const Exchange::PriceText& p, FC& fc) const {
+      char buf[Exchange::MAX_PRICE_CHARS];
+      char* end = Exchange::formatPrice(buf, p.price_, p.spec_);
+      return base_.format(string_view(buf, static_cast<size_t>(end - buf)), fc);
+    }
+  };
+
+  // no spec given, printed with DEFAULT_PRICE_SPEC
+  template<>
+  struct formatter<Exchange::Price, char> : formatter<Exchange::PriceText, char> {
     template<class FC>
     auto format(const Exchange::Price& p, FC& fc) const {
-      const double as_double = static_cast<double>(p.ticks) * Exchange::DEFAULT_TICK_SIZE;
-      if (!has_custom_format) {
-        // Default: 2 digits after the decimal point
-        return std::format_to(fc.out(), "{:.4f}",   as_double);
-      }
-      // User provided a format spec; pass it through to double's formatter
-      return base_.format(as_double, fc);
+      return formatter<Exchange::PriceText, char>::format(Exchange::PriceText{p, Exchange::DEFAULT_PRICE_SPEC}, fc);
     }
   };
   
@@ -10,33 +10,58 @@
 
 #include "Order.h"
 #include "ReportUtils.h"
+#include "SymbolRegistry.h"
 
 
 namespace Exchange {
 
+// Prints the reports from its own thread, prices in the spec the registry has for the report's symbol.
 class ReportSink {
 public:
-    ReportSink();
+    // symbols has to outlive the sink
+    explicit ReportSink(const SymbolRegistry& symbols);
     ~ReportSink();
 
-    bool submitFills(ExecutionReportCollection&& fills);
+    bool submitFills(ExecutionReportView fills);
+
+    bool submitAcceptedOrder(OrderAcceptedReport&& report);
 
     bool submitCanceledOrder(OrderCanceledReport&& report);
 
     bool submitTopOfBook(TopOfBookReport&& report);
+
+    bool submitDepth(DepthReport&& report);
+
+    // reports submitted in between are queued right away but the consumer is only woken up once, in endBatch()
+    void beginBatch();
+    void endBatch();
 private:
 
-  using QueueItem = std::variant<std::monostate, ExecutionReport, OrderCanceledReport, TopOfBookReport>;
+  // a depth snapshot is a few hundred bytes, as a variant member it'd make every slot (every fill) that big:
+  // the snapshot goes through depthQueue_ and only this marker takes a slot, in order with the rest
+  struct DepthReady {};
+
+  using QueueItem = std::variant<std::monostate, ExecutionReport, OrderAcceptedReport, OrderCanceledReport, TopOfBookReport, DepthReady>;
+  static_assert(sizeof(QueueItem) <= 64, "ReportSink::QueueItem is copied for every fill, keep it within a cache line");
 
   void stop();
   void run();
   void report(QueueItem&& item);
+  template <class Report>
+  void print(const Report& report) const;
+  void notify(std::ptrdiff_t count);
 
 
+  const SymbolRegistry& symbols_;
   boost::lockfree::spsc_queue<QueueItem> queue_{1024};
+  boost::lockfree::spsc_queue<DepthReport> depthQueue_{64};
   std::atomic<bool> stopRequested_ {false};
   std::counting_semaphore<> semaphore_ {0};
 
+  // producer side only
+  bool batching_ {false};
+  std::ptrdiff_t pendingNotifications_ {0};
+
   std::jthread thread;
 };
 
@@ -1,10 +1,14 @@
 #ifndef REPORT_UTILS_H
 #define REPORT_UTILS_H
 
+#include <array>
+#include <span>
 #include <vector>
 #include "Order.h"
 #include "OrderUtils.h"
 #include <format>
+#include <iterator>
+#include <string>
 
 namespace Exchange {
 
@@ -12,23 +16,61 @@ namespace Exchange {
   // TODO: report properly
 
 struct ExecutionReport {
-  ExecutionReport(Symbol symbol, OrderId orderId, OrderId otherOrderId, Quantity filledQuantity, Price price)
-    : symbol_(symbol), orderId_(orderId), otherOrderId_(otherOrderId), filledQuantity_(filledQuantity), price_(price) {}
+  ExecutionReport() = default;
+  ExecutionReport(Symbol symbol, OrderId orderId, OrderId otherOrderId, Quantity filledQuantity, Price price,
+                  Timestamp matched = {})
+    : symbol_(symbol), orderId_(orderId), otherOrderId_(otherOrderId), filledQuantity_(filledQuantity), price_(price),
+      matched_(matched) {}
   
-  Symbol symbol_;
-  OrderId orderId_;
-  OrderId otherOrderId_;
+  Symbol symbol_ {INVALID_SYMBOL};
+  OrderId orderId_ {INVALID_ORDER_ID};
+  OrderId otherOrderId_ {INVALID_ORDER_ID};
   
   Quantity filledQuantity_ {};
   Price price_ {};
+  Timestamp matched_ {};   // when the book matched it
 };
 
 using ExecutionReportCollection = std::vector<ExecutionReport>;
+using ExecutionReportView = std::span<const ExecutionReport>;
+
+// Scratch space the books collect the fills of an aggressive order in.
+// Fixed size and owned by the book, so matching never allocates,
+// the book hands it to the sink when it runs out of room and at the end of the sweep.
+class FillBuffer {
+public:
+  static constexpr std::size_t CAPACITY = 256;   // reports, every fill is 2 of them
+
+  bool hasRoomFor(std::size_t reports) const noexcept { return size_ + reports <= CAPACITY; }
+  bool empty() const noexcept { return size_ == 0; }
+
+  void add(Symbol symbol, OrderId orderId, OrderId otherOrderId, Quantity filledQuantity, Price price,
+           Timestamp matched) noexcept {
+    reports_[size_++] = ExecutionReport(symbol, orderId, otherOrderId, filledQuantity, price, matched);
+  }
+
+  ExecutionReportView reports() const noexcept { return {reports_.data(), size_}; }
+  void clear() noexcept { size_ = 0; }
 
+private:
+  std::array<ExecutionReport, CAPACITY> reports_ {};
+  std::size_t size_ {0};
+};
+
+
+// sent when an order rests on the book, tells the client which id to cancel it with
+struct OrderAcceptedReport {
+  Symbol symbol_ {INVALID_SYMBOL};
+  OrderId clientOrderId_ {INVALID_ORDER_ID};
+  ExchangeOrderId exchangeOrderId_ {INVALID_EXCHANGE_ORDER_ID};
+  Quantity openQuantity_ {INVALID_QUANTITY};
+  Price price_ {INVALID_PRICE};
+};
 
 enum class CancelReason {
   Fill_And_Kill,
   User_Canceled,
+  Price_Out_Of_Range,   // a limit price the book can't rest, whatever wasn't filled is dropped
   Other
 };
 
@@ -39,25 +81,54 @@ struct OrderCanceledReport {
   CancelReason reason_;
 };
 
-struct SingleOrderReport {
-  bool isValid() const { return orderId_ != INVALID_ORDER_ID; }
+// one price level of one side: price, total open quantity and number of orders resting there
+struct PriceLevel {
+  bool isValid() const { return orderCount_ != 0; }
+
+  bool operator==(const PriceLevel&) const = default;
 
-  OrderId orderId_ {INVALID_ORDER_ID};
   Price price_ {INVALID_PRICE};
-  Quantity openQuantity_ {INVALID_QUANTITY};
+  Quantity quantity_ {0};
+  uint32_t orderCount_ {0};
 };
 
 struct TopOfBookReport {
-  TopOfBookReport() = default;
-  TopOfBookReport(Symbol symbol, const Order& bid, const Order& ask);
+  bool isValid() const { return symbol_ != INVALID_SYMBOL; }
+
+  Symbol symbol_ {INVALID_SYMBOL};
+  PriceLevel bid_ {};
+  PriceLevel ask_ {};
+};
 
+// best levels of both sides, best first, only the first bidCount_/askCount_ entries are set
+struct DepthReport {
   bool isValid() const { return symbol_ != INVALID_SYMBOL; }
 
+  std::span<const PriceLevel> bids() const { return {bids_.data(), bidCount_}; }
+  std::span<const PriceLevel> asks() const { return {asks_.data(), askCount_}; }
+
   Symbol symbol_ {INVALID_SYMBOL};
-  SingleOrderReport bid_order_ {}; 
-  SingleOrderReport ask_order_ {};
+  uint32_t bidCount_ {0};
+  uint32_t askCount_ {0};
+  std::array<PriceLevel, MAX_DEPTH_LEVELS> bids_ {};
+  std::array<PriceLevel, MAX_DEPTH_LEVELS> asks_ {};
+};
+
+// a report along with the spec to print its prices in, std::format("{}", ReportText{report, spec})
+// reports don't carry their symbol's spec, whoever prints them looks it up in the registry the books were made from
+template <class Report>
+struct ReportText {
+  const Report& report_;
+  const PriceSpec& spec_;
 };
 
+namespace detail {
+  inline void formatLevel(std::string& out, const PriceLevel& level, const PriceSpec& spec) {
+    std::format_to(std::back_inserter(out), "PriceLevel{{price={}, qty={}, orders={}}}",
+                   PriceText{level.price_, spec}, level.quantity_, level.orderCount_);
+  }
+}
+
 } // namespace Exchange
 
 namespace  std {
@@ -65,16 +136,17 @@ namespace  std {
   // ---------- ExecutionReport ----------
 
   template<>
-  struct std::formatter<Exchange::ExecutionReport> : std::formatter<std::string_view> {
+  struct std::formatter<Exchange::ReportText<Exchange::ExecutionReport>> : std::formatter<std::string_view> {
     // support passing format specifiers through, e.g. "{:>80}"
     template<class ParseContext>
     constexpr auto parse(ParseContext& ctx) { return std::formatter<std::string_view>::parse(ctx); }
 
     template<class FormatContext>
-    auto format(const Exchange::ExecutionReport& r, FormatContext& ctx) const {
+    auto format(const Exchange::ReportText<Exchange::ExecutionReport>& text, FormatContext& ctx) const {
+      const auto& r = text.report_;
       auto s = std::format(
-        "ExecutionReport{{symbol={}, orderId={}, otherOrderId={}, filledQuantity={}, price={:.2f}}}",
-        r.symbol_, r.orderId_, r.otherOrderId_, r.filledQuantity_, r.price_);
+        "ExecutionReport{{symbol={}, orderId={}, otherOrderId={}, filledQuantity={}, price={}}}",
+        r.symbol_, r.orderId_, r.otherOrderId_, r.filledQuantity_, Exchange::PriceText{r.price_, text.spec_});
       return std::formatter<std::string_view>::format(s, ctx);
     }
   };
@@ -95,15 +167,16 @@ struct formatter<Exchange::CancelReason, char> {
     switch (r) {
       case Exchange::CancelReason::Fill_And_Kill: s = "Fill_And_Kill"; break;
       case Exchange::CancelReason::User_Canceled: s = "User_Canceled"; break;
+      case Exchange::CancelReason::Price_Out_Of_Range: s = "Price_Out_Of_Range"; break;
       case Exchange::CancelReason::Other:         s = "Other"; break;
     }
     return base_.format(s, fc);
   }
 };
 
-// ---------- SingleOrderReport ----------
+// ---------- PriceLevel ----------
 template<>
-struct formatter<Exchange::SingleOrderReport, char> {
+struct formatter<Exchange::PriceLevel, char> {
   formatter<string_view, char> base_;
 
   constexpr auto parse(basic_format_parse_context<char>& ctx) {
@@ -111,12 +184,31 @@ struct formatter<Exchange::SingleOrderReport, char> {
   }
 
   template<class FC>
-  auto format(const Exchange::SingleOrderReport& r, FC& fc) const {
+  auto format(const Exchange::PriceLevel& r, FC& fc) const {
     // Build a small string, then let base_ handle width/alignment.
     std::string tmp;
+    Exchange::detail::formatLevel(tmp, r, Exchange::DEFAULT_PRICE_SPEC);
+    return base_.format(std::string_view(tmp), fc);
+  }
+};
+
+// ---------- OrderAcceptedReport ----------
+template<>
+struct formatter<Exchange::ReportText<Exchange::OrderAcceptedReport>, char> {
+  formatter<string_view, char> base_;
+
+  constexpr auto parse(basic_format_parse_context<char>& ctx) {
+    return base_.parse(ctx);
+  }
+
+  template<class FC>
+  auto format(const Exchange::ReportText<Exchange::OrderAcceptedReport>& text, FC& fc) const {
+    const auto& r = text.report_;
+    std::string tmp;
     std::format_to(std::back_inserter(tmp),
-                   "SingleOrderReport{{orderId={}, price={}, openQty={}}}",
-                   r.orderId_, r.price_, r.openQuantity_);
+                   "OrderAcceptedReport{{symbol={}, clientOrderId={}, exchangeOrderId={}, openQty={}, price={}}}",
+                   r.symbol_, r.clientOrderId_, r.exchangeOrderId_, r.openQuantity_,
+                   Exchange::PriceText{r.price_, text.spec_});
     return base_.format(std::string_view(tmp), fc);
   }
 };
@@ -142,7 +234,7 @@ struct formatter<Exchange::OrderCanceledReport, char> {
 
 // ---------- TopOfBookReport ----------
 template<>
-struct formatter<Exchange::TopOfBookReport, char> {
+struct formatter<Exchange::ReportText<Exchange::TopOfBookReport>, char> {
   formatter<string_view, char> base_;
 
   constexpr auto parse(basic_format_parse_context<char>& ctx) {
@@ -150,11 +242,44 @@ struct formatter<Exchange::TopOfBookReport, char> {
   }
 
   template<class FC>
-  auto format(const Exchange::TopOfBookReport& r, FC& fc) const {
+  auto format(const Exchange::ReportText<Exchange::TopOfBookReport>& text, FC& fc) const {
+    const auto& r = text.report_;
+    const auto& spec = text.spec_;
     std::string tmp;
-    std::format_to(std::back_inserter(tmp),
-                   "TopOfBookReport{{symbol={}, bid={}, ask={}}}",
-                   r.symbol_, r.bid_order_, r.ask_order_);
+    std::format_to(std::back_inserter(tmp), "TopOfBookReport{{symbol={}, bid=", r.symbol_);
+    Exchange::detail::formatLevel(tmp, r.bid_, spec);
+    tmp += ", ask=";
+    Exchange::detail::formatLevel(tmp, r.ask_, spec);
+    tmp += '}';
+    return base_.format(std::string_view(tmp), fc);
+  }
+};
+
+// ---------- DepthReport ----------
+template<>
+struct formatter<Exchange::ReportText<Exchange::DepthReport>, char> {
+  formatter<string_view, char> base_;
+
+  constexpr auto parse(basic_format_parse_context<char>& ctx) {
+    return base_.parse(ctx);
+  }
+
+  template<class FC>
+  auto format(const Exchange::ReportText<Exchange::DepthReport>& text, FC& fc) const {
+    const auto& r = text.report_;
+    const auto& spec = text.spec_;
+    std::string tmp;
+    std::format_to(std::back_inserter(tmp), "DepthReport{{symbol={}, bids=[", r.symbol_);
+    for (const auto& level : r.bids()) {
+      tmp += ' ';
+      Exchange::detail::formatLevel(tmp, level, spec);
+    }
+    std::format_to(std::back_inserter(tmp), " ], asks=[");
+    for (const auto& level : r.asks()) {
+      tmp += ' ';
+      Exchange::detail::formatLevel(tmp, level, spec);
+    }
+    std::format_to(std::back_inserter(tmp), " ]}}");
     return base_.format(std::string_view(tmp), fc);
   }
 };
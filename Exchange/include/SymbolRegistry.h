@@ -0,0 +1,68 @@
+#ifndef SYMBOL_REGISTRY_H
+#define SYMBOL_REGISTRY_H
+
+#include <initializer_list>
+#include <span>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "OrderUtils.h"
+
+namespace Exchange {
+
+// a symbol and how its prices are quoted
+struct SymbolSpec {
+  std::string_view symbol_;
+  PriceSpec priceSpec_ {TWO_DIGITS_PRICE_SPEC};
+  // roughly where it trades, in ticks of priceSpec_: a LadderOrderBook starts its price band around it
+  Price referencePrice_ {0};
+};
+
+// The symbols we trade, each with a dense SymbolId handle, its PriceSpec and reference price.
+// Filled once at startup and read-only after that, so lookups don't lock.
+// The parser resolves the Symbol of every event here, the book manager routes on the id.
+class SymbolRegistry {
+public:
+  // ids are handed out in the given order, starting at 1, duplicates keep their first id
+  // symbols given by name only are quoted in TWO_DIGITS_PRICE_SPEC
+  SymbolRegistry(std::initializer_list<std::string_view> symbols);
+  SymbolRegistry(std::initializer_list<SymbolSpec> symbols);
+  explicit SymbolRegistry(std::span<const Symbol> symbols);
+
+  // the hard-coded default symbol list, used by the parser and the book manager unless they're given another one
+  static const SymbolRegistry& global();
+
+  // INVALID_SYMBOL_ID for a symbol we don't trade
+  SymbolId find(Symbol symbol) const;
+
+  // INVALID_SYMBOL for a handle we never handed out
+  Symbol symbol(SymbolId id) const;
+
+  // DEFAULT_PRICE_SPEC for a handle we never handed out
+  const PriceSpec& priceSpec(SymbolId id) const {
+    return priceSpecs_[id < priceSpecs_.size() ? id : INVALID_SYMBOL_ID];
+  }
+  const PriceSpec& priceSpec(Symbol symbol) const { return priceSpec(find(symbol)); }
+
+  // Price{0} for a handle we never handed out, or a symbol given without one
+  Price referencePrice(SymbolId id) const {
+    return referencePrices_[id < referencePrices_.size() ? id : INVALID_SYMBOL_ID];
+  }
+
+  // symbols()[id - 1] is the symbol with that id
+  std::span<const Symbol> symbols() const { return symbols_; }
+  std::size_t size() const { return symbols_.size(); }
+
+private:
+  void add(Symbol symbol, PriceSpec priceSpec = TWO_DIGITS_PRICE_SPEC, Price referencePrice = Price{0});
+
+  std::unordered_map<Symbol, SymbolId> ids_;
+  std::vector<Symbol> symbols_;
+  std::vector<PriceSpec> priceSpecs_ {DEFAULT_PRICE_SPEC};   // by SymbolId, [0] for unknown symbols
+  std::vector<Price> referencePrices_ {Price{0}};             // same
+};
+
+} // namespace Exchange
+
+#endif // SYMBOL_REGISTRY_H
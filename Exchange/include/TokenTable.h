@@ -0,0 +1,136 @@
+#ifndef TOKEN_TABLE_H
+#define TOKEN_TABLE_H
+
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <string_view>
+#include <utility>
+
+namespace Exchange {
+
+// Decodes the handful of short tokens of an enum ("BUY", "1", "QUIT", ...) with one multiply and one compare.
+//
+// The token, trimmed and ascii upper-cased on the fly, is packed into a uint64_t (so at most 8 chars).
+// The table is built at compile time with a multiplier that sends every key to its own slot (a perfect hash),
+// a lookup is the packed key, (key * multiplier) >> shift, and a compare against the key stored in the slot.
+// Nothing is copied, nothing allocates. Duplicate or too long tokens don't compile.
+template <class Enum, std::size_t N>
+class TokenTable {
+public:
+  static constexpr std::size_t MAX_TOKEN_SIZE = sizeof(uint64_t);
+
+  consteval TokenTable(const std::pair<std::string_view, Enum> (&entries)[N], Enum invalid) : invalid_(invalid) {
+    std::array<uint64_t, N> keys {};
+    for (std::size_t i = 0; i < N; ++i) {
+      keys[i] = pack(entries[i].first);
+      if (keys[i] == 0) {
+        throw "TokenTable: tokens have to be 1 to 8 chars";
+      }
+      for (std::size_t j = 0; j < i; ++j) {
+        if (keys[j] == keys[i]) {
+          throw "TokenTable: duplicate token";
+        }
+      }
+    }
+
+    multiplier_ = findMultiplier(keys);
+    for (auto& slot : slots_) {
+      slot = Slot{0, invalid};
+    }
+    for (std::size_t i = 0; i < N; ++i) {
+      slots_[index(keys[i], multiplier_)] = Slot{keys[i], entries[i].second};
+    }
+  }
+
+  constexpr Enum decode(std::string_view token) const noexcept {
+    const auto key = pack(trim(token));
+    const auto& slot = slots_[index(key, multiplier_)];
+    return key != 0 && slot.key_ == key ? slot.value_ : invalid_;
+  }
+
+  constexpr Enum operator()(std::string_view token) const noexcept { return decode(token); }
+
+  // 0 for a token that's empty, too long or has a NUL in it (it'd pack the same as without), nothing we store packs to 0
+  static constexpr uint64_t pack(std::string_view token) noexcept {
+    if (token.empty() || token.size() > MAX_TOKEN_SIZE) {
+      return 0;
+    }
+    uint64_t key = 0;
+    for (std::size_t i = 0; i < token.size(); ++i) {
+      auto c = static_cast<unsigned char>(token[i]);
+      if (c == 0) {
+        return 0;
+      }
+      if (c >= 'a' && c <= 'z') {
+        c -= 'a' - 'A';
+      }
+      key |= uint64_t{c} << (8 * i);
+    }
+    return key;
+  }
+
+private:
+  struct Slot {
+    uint64_t key_ {0};
+    Enum value_ {};
+  };
+
+  // twice the tokens, rounded up to a power of two, keeps the multiplier search short
+  static constexpr std::size_t SLOTS = std::bit_ceil(2 * N);
+  static constexpr int SHIFT = 64 - std::countr_zero(SLOTS);
+
+  static constexpr std::size_t index(uint64_t key, uint64_t multiplier) noexcept {
+    if constexpr (SLOTS == 1) {
+      return 0;
+    } else {
+      return static_cast<std::size_t>((key * multiplier) >> SHIFT);
+    }
+  }
+
+  // same separators as trimView, without going through find_first_not_of
+  static constexpr std::string_view trim(std::string_view token) noexcept {
+    constexpr auto isSpace = [](char c) { return c == ' ' || c == '\t' || c == '\r' || c == '\n'; };
+    std::size_t start = 0;
+    std::size_t end = token.size();
+    while (start < end && isSpace(token[start])) {
+      ++start;
+    }
+    while (end > start && isSpace(token[end - 1])) {
+      --end;
+    }
+    return token.substr(start, end - start);
+  }
+
+  static consteval uint64_t findMultiplier(const std::array<uint64_t, N>& keys) {
+    // odd splitmix64 outputs until one separates every key
+    uint64_t state = 0;
+    for (int attempt = 0; attempt < 100'000; ++attempt) {
+      state += 0x9E3779B97F4A7C15ull;
+      uint64_t z = state;
+      z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+      z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+      const uint64_t multiplier = (z ^ (z >> 31)) | 1;
+
+      std::array<bool, SLOTS> used {};
+      bool collision = false;
+      for (auto key : keys) {
+        auto& slot = used[index(key, multiplier)];
+        collision = collision || slot;
+        slot = true;
+      }
+      if (!collision) {
+        return multiplier;
+      }
+    }
+    throw "TokenTable: no perfect hash found";
+  }
+
+  std::array<Slot, SLOTS> slots_ {};
+  uint64_t multiplier_ {0};
+  Enum invalid_;
+};
+
+} // namespace Exchange
+
+#endif // TOKEN_TABLE_H
@@ -2,10 +2,16 @@
 #define UDP_LISTENER_H
 
 #include <string>
+#include <string_view>
 #include <functional>
 #include <thread>
 #include <mutex>
 #include <atomic>
+#include <utility>
+#include <vector>
+#include <cstdint>
+#include <sys/socket.h>
+#include <sys/uio.h>
 
 #include "EventQueue.h"
 
@@ -29,29 +35,89 @@ private:
   int handle_ {-1};
 };
 
+// Each datagram goes to the subscribers as is, one message or a burst of '\n' separated ones.
+//
+// On linux up to receiveBatch datagrams are read per syscall (recvmmsg), into buffers allocated once up front.
+// Subscribers get views straight into those buffers, nothing is copied unless they subscribe() for strings.
+//
+// The listener thread dispatches without taking a lock: subscribers live in an immutable snapshot behind an atomic
+// pointer, subscribe/unsubscribe publish a new one and free the old one once no dispatch can still be using it.
+// Once unsubscribe returns the callback won't be called again (called from inside a callback: after this batch).
 class UDPListener : public EventQueue {
 public:
-   
-    explicit UDPListener(int port);
+    static constexpr std::size_t DEFAULT_MAX_DATAGRAM_SIZE = 4096;
+    static constexpr std::size_t DEFAULT_RECEIVE_BATCH = 64;
+    // the largest UDP payload over IPv4, and a batch big enough that a bigger one wouldn't save any syscalls
+    static constexpr std::size_t MAX_DATAGRAM_SIZE = 65507;
+    static constexpr std::size_t MAX_RECEIVE_BATCH = 1024;
+
+    struct ReceiveStats {
+      uint64_t datagrams_ {0};
+      uint64_t receiveCalls_ {0};
+
+      double datagramsPerCall() const {
+        return receiveCalls_ == 0 ? 0.0 : static_cast<double>(datagrams_) / static_cast<double>(receiveCalls_);
+      }
+    };
+
+    // datagrams bigger than maxDatagramSize get cut short, port 0 picks a free one (see port())
+    explicit UDPListener(int port, std::size_t maxDatagramSize = DEFAULT_MAX_DATAGRAM_SIZE,
+                         std::size_t receiveBatch = DEFAULT_RECEIVE_BATCH);
     ~UDPListener();
     
-    [[nodiscard]] std::unique_ptr<SubscriptionHandle> subscribe(MessageCallback callback) override;
+    [[nodiscard]] std::unique_ptr<SubscriptionHandle> subscribeBatch(BatchCallback callback) override;
+
+    int port() const { return port_; }
+    // safe to call while listening
+    ReceiveStats stats() const;
     
 private:
     void bindToPort(int port);
     bool startListening();
     void stopListening();
     void listenLoop();
+    // blocks until at least one datagram is in, fills messages_ with what's there (up to the batch size)
+    std::size_t receive();
+    void dispatch(std::size_t received);
 
     friend class UdpSubscriptionHandle;
     bool unsubscribe(int handle);
 
+    using Subscribers = std::vector<std::pair<int, BatchCallback>>;
+    using Retired = std::vector<std::unique_ptr<const Subscribers>>;
+    // swaps in next, cbMutex_ held. Returns the snapshots that can go once the running dispatch is over
+    Retired publish(std::unique_ptr<const Subscribers> next);
+    // frees retired after waitForDispatch(), without cbMutex_ so a callback that (un)subscribes can't deadlock with us
+    void reclaim(Retired retired) const;
+    // returns once a dispatch that was running when called (if any) is over
+    void waitForDispatch() const;
+
 private:
     int socketFd_;
     int port_;
+    std::size_t maxDatagramSize_;
+    std::size_t receiveBatch_;
+
+    // receiveBatch_ slots of maxDatagramSize_ bytes, one after the other
+    std::vector<char> buffer_;
+    // what the last receive got, views into buffer_
+    std::vector<std::string_view> messages_;
+#ifdef __linux__
+    std::vector<struct iovec> iovecs_;
+    std::vector<struct mmsghdr> headers_;
+#endif
+
+    std::atomic<uint64_t> datagrams_ {0};
+    std::atomic<uint64_t> receiveCalls_ {0};
 
+    // writers only, the listener thread never takes it
     std::mutex cbMutex_;
-    std::unordered_map<int, MessageCallback> callbacks_;
+    // owned, nullptr until the first subscribe
+    std::atomic<const Subscribers*> subscribers_ {nullptr};
+    // odd while the listener thread is dispatching
+    std::atomic<uint64_t> dispatchEpoch_ {0};
+    // replaced from inside a callback, can't be freed until that dispatch is over
+    Retired retired_;
 
     std::thread listenerThread_;
 };
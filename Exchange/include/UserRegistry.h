@@ -0,0 +1,50 @@
+#ifndef USER_REGISTRY_H
+#define USER_REGISTRY_H
+
+#include <algorithm>
+#include <shared_mutex>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "OrderUtils.h"
+
+namespace Exchange {
+
+// User names <-> dense UserId handles.
+// Names are interned once at ingress (the parser), from there on events and orders only carry the 4 byte handle,
+// the name is looked up again only when something has to print it.
+// intern() is called from the ingress thread, name() from wherever reports get formatted.
+// It's bounded: names come from unauthenticated senders, so once maxUsers are in, new names are refused
+// (the parser rejects the message with ParseError::TooManyUsers) instead of growing it forever.
+class UserRegistry {
+public:
+  static constexpr std::size_t DEFAULT_MAX_USERS = 1 << 20;
+
+  // capped below LITERAL_USER_ID_BIT so interned ids never meet _uid ones
+  explicit UserRegistry(std::size_t maxUsers = DEFAULT_MAX_USERS)
+    : maxUsers_(std::min<std::size_t>(maxUsers, LITERAL_USER_ID_BIT - 1)) {}
+
+  // the one the parser uses unless it's given another
+  static UserRegistry& global();
+
+  // handle for the name, a name we haven't seen before gets the next one (starting at 1)
+  // names longer than UserName holds are cut to fit, same as before interning
+  // INVALID_USER_ID for a new name once the registry is full
+  UserId intern(std::string_view name);
+
+  // INVALID_USER_NAME for a handle we never handed out
+  UserName name(UserId id) const;
+
+  std::size_t size() const;
+
+private:
+  const std::size_t maxUsers_;
+  mutable std::shared_mutex mutex_;
+  std::unordered_map<UserName, UserId> ids_;
+  std::vector<UserName> names_;               // names_[id - 1]
+};
+
+} // namespace Exchange
+
+#endif // USER_REGISTRY_H
@@ -0,0 +1,84 @@
+#include "BinaryProtocol.h"
+
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+namespace Exchange::Binary {
+
+namespace {
+  template <std::size_t N>
+  void copyField(char (&field)[N], std::string_view value, const char* what) {
+    if (value.size() > N) {
+      throw std::invalid_argument(std::string(what) + " doesn't fit in " + std::to_string(N) + " bytes: " + std::string(value));
+    }
+    std::memset(field, 0, N);
+    std::memcpy(field, value.data(), value.size());
+  }
+
+  template <class Message>
+  Header header(MessageType type) {
+    return Header{littleEndian(static_cast<uint16_t>(sizeof(Message))), type, PROTOCOL_VERSION};
+  }
+
+  OrderFields orderFields(std::string_view user, OrderId clientOrderId, std::string_view symbol) {
+    OrderFields fields {};
+    fields.clientOrderId_ = littleEndian(static_cast<int32_t>(clientOrderId));
+    copyField(fields.user_, user, "user");
+    copyField(fields.symbol_, symbol, "symbol");
+    return fields;
+  }
+}
+
+template <class Message>
+bool Encoder::append(const Message& message) {
+  if (buffer_.size() - size_ < sizeof(Message)) {
+    return false;
+  }
+  std::memcpy(buffer_.data() + size_, &message, sizeof(Message));
+  size_ += sizeof(Message);
+  return true;
+}
+
+bool Encoder::newOrder(std::string_view user, OrderId clientOrderId, std::string_view symbol,
+                       Quantity quantity, Side side, Type type, Price price) {
+  if (side != Side::Buy && side != Side::Sell) {
+    throw std::invalid_argument("Invalid side");
+  }
+  if (type != Type::Market && type != Type::Limit) {
+    throw std::invalid_argument("Invalid type");
+  }
+  NewOrderMessage message {};
+  message.header_ = header<NewOrderMessage>(MessageType::NewOrder);
+  message.order_ = orderFields(user, clientOrderId, symbol);
+  message.price_ = littleEndian(type == Type::Limit ? price.ticks : int64_t{0});
+  message.quantity_ = littleEndian(static_cast<int32_t>(quantity));
+  message.side_ = side == Side::Buy ? WireSide::Buy : WireSide::Sell;
+  message.type_ = type == Type::Limit ? WireType::Limit : WireType::Market;
+  return append(message);
+}
+
+bool Encoder::cancelOrder(std::string_view user, OrderId clientOrderId, std::string_view symbol, ExchangeOrderId origOrderId) {
+  CancelOrderMessage message {};
+  message.header_ = header<CancelOrderMessage>(MessageType::CancelOrder);
+  message.order_ = orderFields(user, clientOrderId, symbol);
+  message.origOrderId_ = littleEndian(static_cast<uint64_t>(origOrderId));
+  return append(message);
+}
+
+bool Encoder::topOfBook(std::string_view user, OrderId clientOrderId, std::string_view symbol) {
+  TopOfBookMessage message {};
+  message.header_ = header<TopOfBookMessage>(MessageType::TopOfBook);
+  message.order_ = orderFields(user, clientOrderId, symbol);
+  return append(message);
+}
+
+bool Encoder::depth(std::string_view user, OrderId clientOrderId, std::string_view symbol, uint32_t levels) {
+  DepthMessage message {};
+  message.header_ = header<DepthMessage>(MessageType::Depth);
+  message.order_ = orderFields(user, clientOrderId, symbol);
+  message.levels_ = littleEndian(levels);
+  return append(message);
+}
+
+} // namespace Exchange::Binary
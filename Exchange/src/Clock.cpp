@@ -0,0 +1,50 @@
+#include "Clock.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#  include <cpuid.h>
+#endif
+
+namespace Exchange {
+
+namespace {
+  constexpr auto CALIBRATION_TIME = std::chrono::milliseconds(10);
+
+  bool hasInvariantTsc() {
+#if defined(__x86_64__) || defined(__i386__)
+    unsigned eax {0}, ebx {0}, ecx {0}, edx {0};
+    if (!__get_cpuid(0x80000007, &eax, &ebx, &ecx, &edx)) {
+      return false;
+    }
+    return (edx & (1u << 8)) != 0;
+#else
+    return false;
+#endif
+  }
+}
+
+TscClock::Calibration TscClock::measure() {
+  Calibration calibration;
+  if (!hasInvariantTsc()) {
+    return calibration;
+  }
+
+  const auto startTime = std::chrono::steady_clock::now();
+  const auto startTicks = ticks();
+  auto endTime = startTime;
+  while (endTime - startTime < CALIBRATION_TIME) {
+    endTime = std::chrono::steady_clock::now();
+  }
+  const auto endTicks = ticks();
+  if (endTicks <= startTicks) {
+    return calibration;
+  }
+
+  calibration.usable_ = true;
+  calibration.baseTicks_ = endTicks;
+  calibration.base_ = endTime;
+  calibration.nsPerTick_ = static_cast<double>(std::chrono::nanoseconds(endTime - startTime).count())
+                            / static_cast<double>(endTicks - startTicks);
+  return calibration;
+}
+
+} // namespace Exchange
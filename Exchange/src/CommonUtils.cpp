@@ -13,6 +13,21 @@ std::string trimCopy(std::string_view sv, std::string_view separators) {
   return std::string(sv.substr(start, end - start + 1));
 }
 
+std::string_view trimView(std::string_view sv, std::string_view separators) {
+  auto start = sv.find_first_not_of(separators);
+  if (start == std::string_view::npos) return {};
+
+  auto end = sv.find_last_not_of(separators);
+
+  return sv.substr(start, end - start + 1);
+}
+
+bool equalsIgnoreCase(std::string_view a, std::string_view b) {
+  // not std::toupper, that goes through the locale for every char
+  constexpr auto upper = [](char c) { return c >= 'a' && c <= 'z' ? static_cast<char>(c - 'a' + 'A') : c; };
+  return std::ranges::equal(a, b, [upper](char x, char y) { return upper(x) == upper(y); });
+}
+
 std::string trimAndUpperCopy(std::string_view sv, std::string_view separators) {
     std::string result(trimCopy(sv, separators));
     std::transform(result.begin(), result.end(), result.begin(), ::toupper);
@@ -0,0 +1,135 @@
+#include "DelimiterScan.h"
+
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__)
+#  include <immintrin.h>
+#  define EXCHANGE_X86 1
+#endif
+
+namespace Exchange {
+
+namespace {
+
+  uint64_t delimiterMaskScalar(const char* block) noexcept {
+    uint64_t mask {0};
+    for (std::size_t i = 0; i < DELIMITER_BLOCK_SIZE; ++i) {
+      if (block[i] == ',' || block[i] == '\n') {
+        mask |= uint64_t{1} << i;
+      }
+    }
+    return mask;
+  }
+
+#ifdef EXCHANGE_X86
+  // pcmpestrm in "equal any" mode against the two delimiters, explicit lengths so a '\0' in the data doesn't stop it
+  __attribute__((target("sse4.2")))
+  uint64_t delimiterMaskSse42(const char* block) noexcept {
+    const __m128i delimiters = _mm_setr_epi8(',', '\n', 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0);
+    constexpr int MODE = _SIDD_UBYTE_OPS | _SIDD_CMP_EQUAL_ANY | _SIDD_BIT_MASK;
+    uint64_t mask {0};
+    for (std::size_t i = 0; i < DELIMITER_BLOCK_SIZE; i += 16) {
+      const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(block + i));
+      const __m128i hits = _mm_cmpestrm(delimiters, 2, chunk, 16, MODE);
+      mask |= static_cast<uint64_t>(static_cast<uint16_t>(_mm_cvtsi128_si32(hits))) << i;
+    }
+    return mask;
+  }
+
+  __attribute__((target("avx2")))
+  uint64_t delimiterMaskAvx2(const char* block) noexcept {
+    const __m256i comma = _mm256_set1_epi8(',');
+    const __m256i newline = _mm256_set1_epi8('\n');
+    uint64_t mask {0};
+    for (std::size_t i = 0; i < DELIMITER_BLOCK_SIZE; i += 32) {
+      const __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block + i));
+      const __m256i hits = _mm256_or_si256(_mm256_cmpeq_epi8(chunk, comma), _mm256_cmpeq_epi8(chunk, newline));
+      mask |= static_cast<uint64_t>(static_cast<uint32_t>(_mm256_movemask_epi8(hits))) << i;
+    }
+    return mask;
+  }
+#endif
+
+  SimdLevel detectSimdLevel() noexcept {
+#ifdef EXCHANGE_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+      return SimdLevel::Avx2;
+    }
+    if (__builtin_cpu_supports("sse4.2")) {
+      return SimdLevel::Sse42;
+    }
+#endif
+    return SimdLevel::Scalar;
+  }
+
+} // namespace
+
+SimdLevel bestSimdLevel() noexcept {
+  static const SimdLevel level = detectSimdLevel();
+  return level;
+}
+
+bool isSupported(SimdLevel level) noexcept {
+  return level <= bestSimdLevel();
+}
+
+DelimiterMaskFn delimiterMaskFn(SimdLevel level) noexcept {
+  if (!isSupported(level)) {
+    return &delimiterMaskScalar;
+  }
+  switch (level) {
+#ifdef EXCHANGE_X86
+    case SimdLevel::Avx2:
+      return &delimiterMaskAvx2;
+    case SimdLevel::Sse42:
+      return &delimiterMaskSse42;
+#endif
+    default:
+      return &delimiterMaskScalar;
+  }
+}
+
+std::string_view toString(SimdLevel level) noexcept {
+  switch (level) {
+    case SimdLevel::Scalar: return "Scalar";
+    case SimdLevel::Sse42:  return "SSE4.2";
+    case SimdLevel::Avx2:   return "AVX2";
+  }
+  return "Unknown";
+}
+
+void DelimiterScanner::loadBlock() noexcept {
+  blockStart_ = nextBlock_;
+  nextBlock_ += DELIMITER_BLOCK_SIZE;
+  if (nextBlock_ <= buffer_.size()) {
+    mask_ = maskFn_(buffer_.data() + blockStart_);
+    return;
+  }
+  // last partial block, padded with something that isn't a delimiter
+  char tail[DELIMITER_BLOCK_SIZE] {};
+  std::memcpy(tail, buffer_.data() + blockStart_, buffer_.size() - blockStart_);
+  mask_ = maskFn_(tail);
+}
+
+bool DelimiterScanner::nextLine(SplitLine& line) noexcept {
+  if (lineStart_ >= buffer_.size()) {
+    return false;
+  }
+
+  line.fields_ = 0;
+  while (true) {
+    const auto position = next();
+    const bool endOfLine = position == buffer_.size() || buffer_[position] == '\n';
+    if (endOfLine || line.fields_ < SplitLine::MAX_FIELDS - 1) {
+      line.ends_[line.fields_++] = static_cast<uint32_t>(position - lineStart_);
+    }
+    if (endOfLine) {
+      line.line_ = buffer_.substr(lineStart_, position - lineStart_);
+      lineStart_ = position + 1;
+      return true;
+    }
+  }
+}
+
+} // namespace Exchange
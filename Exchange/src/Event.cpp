@@ -1,6 +1,8 @@
 #include "Event.h"
 #include "EventParser.h"
+#include "TokenTable.h"
 #include <boost/algorithm/string.hpp>
+#include <algorithm>
 
 namespace Exchange {
 
@@ -12,7 +14,7 @@ NewOrderEvent::NewOrderEvent(UserId userId, OrderId clientOrderId,
 
 
 
-CancelOrderEvent::CancelOrderEvent(UserId userId, OrderId clientOrderId, Symbol symbol, OrderId origOrderId) noexcept 
+CancelOrderEvent::CancelOrderEvent(UserId userId, OrderId clientOrderId, Symbol symbol, ExchangeOrderId origOrderId) noexcept 
     :  OrderEvent<CancelOrderEvent>(userId, clientOrderId, symbol), origOrderId_(origOrderId) {}
 
 
@@ -20,20 +22,24 @@ TopOfBookEvent::TopOfBookEvent(UserId userId, OrderId clientOrderId, Symbol symb
   : OrderEvent<TopOfBookEvent>(userId, clientOrderId, symbol) {}
 
 
+DepthEvent::DepthEvent(UserId userId, OrderId clientOrderId, Symbol symbol, uint32_t levels) noexcept
+  : OrderEvent<DepthEvent>(userId, clientOrderId, symbol), levels_(std::min(levels, MAX_DEPTH_LEVELS)) {}
+
+
+namespace {
+  // the FIX MsgType letters, plus Q/QUIT to stop
+  constexpr TokenTable<EventType, 6> EVENT_TYPES {{
+    {"D", EventType::NewOrder},
+    {"F", EventType::CancelOrder},
+    {"V", EventType::TopOfBook},
+    {"W", EventType::Depth},
+    {"Q", EventType::Quit}, {"QUIT", EventType::Quit},
+  }, EventType::Invalid};
+}
+
 EventType toEventType(std::string_view eventType) {
-  auto upperEvent = trimAndUpperCopy(eventType);
-  
-  if (upperEvent == "D") {
-      return EventType::NewOrder;
-  } else if (upperEvent == "F") {
-      return EventType::CancelOrder;
-  } else if (upperEvent == "V") {
-      return EventType::TopOfBook;
-  } else if (upperEvent == "Q" || upperEvent == "QUIT") {
-      return EventType::Quit;
-  }
-  
-  return EventType::Invalid; // Default case
+  // runs for every message
+  return EVENT_TYPES.decode(eventType);
 }
 
 std::string toString(EventType eventType) {
@@ -44,6 +50,8 @@ std::string toString(EventType eventType) {
           return "CancelOrder";
       case EventType::TopOfBook:
           return "TopOfBook";
+      case EventType::Depth:
+          return "Depth";
       case EventType::Quit:
           return "Quit";
       case EventType::Invalid:
@@ -3,9 +3,201 @@
 #include <boost/algorithm/string.hpp>
 #include <boost/tokenizer.hpp>
 
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <cstring>
+#include <format>
+#include <iterator>
+#include <stdexcept>
+
 namespace Exchange {
 
 namespace {
+  // trimmed and unquoted, in place
+  std::string_view cleanField(std::string_view field) {
+    field = trimView(field);
+    if (field.size() >= 2 && field.front() == '"' && field.back() == '"') {
+      field = field.substr(1, field.size() - 2);
+    }
+    return field;
+  }
+
+  // the fields of one csv line, split as we go
+  class CsvFields {
+  public:
+    explicit CsvFields(std::string_view line) : rest_(line) {}
+
+    bool next(std::string_view& field) {
+      if (done_) {
+        return false;
+      }
+      const auto comma = rest_.find(',');
+      if (comma == std::string_view::npos) {
+        field = rest_;
+        done_ = true;
+      } else {
+        field = rest_.substr(0, comma);
+        rest_.remove_prefix(comma + 1);
+      }
+      field = cleanField(field);
+      return true;
+    }
+
+  private:
+    std::string_view rest_;
+    bool done_ {false};
+  };
+
+  // the fields of a line the DelimiterScanner already split
+  class SplitFields {
+  public:
+    explicit SplitFields(const SplitLine& line) : line_(line) {}
+
+    bool next(std::string_view& field) {
+      if (next_ == line_.size()) {
+        return false;
+      }
+      field = cleanField(line_.field(next_++));
+      return true;
+    }
+
+  private:
+    const SplitLine& line_;
+    std::size_t next_ {0};
+  };
+
+  // the whole field or nothing
+  template <class T>
+  bool toNumber(std::string_view field, T& value) {
+    const auto [ptr, ec] = std::from_chars(field.data(), field.data() + field.size(), value);
+    return ec == std::errc{} && ptr == field.data() + field.size();
+  }
+
+  // what parse() throws for what tryParse() returned
+  Event valueOrThrow(ParseResult result) {
+    if (!result) {
+      throw std::runtime_error(std::string("Invalid event: ") + std::string(toString(result.error())));
+    }
+    return *result;
+  }
+
+  template <class Message>
+  Message decode(std::string_view event) {
+    Message message;
+    std::memcpy(&message, event.data(), sizeof(Message));
+    return message;
+  }
+
+  bool isTextQuit(std::string_view event) {
+    return toEventType(event) == EventType::Quit;
+  }
+
+  // length of the binary message at the front of payload, 0 if there's no header we can trust
+  std::size_t messageLength(std::string_view payload) {
+    if (payload.size() < sizeof(Binary::Header)) {
+      return 0;
+    }
+    const auto length = Binary::littleEndian(decode<Binary::Header>(payload).length_);
+    return length < sizeof(Binary::Header) ? 0 : length;
+  }
+
+  namespace FixTag {
+    constexpr int BeginString = 8;
+    constexpr int BodyLength = 9;
+    constexpr int CheckSum = 10;
+    constexpr int ClOrdID = 11;
+    constexpr int MsgType = 35;
+    constexpr int OrderID = 37;
+    constexpr int OrderQty = 38;
+    constexpr int OrdType = 40;
+    constexpr int Price = 44;
+    constexpr int SenderCompID = 49;
+    constexpr int Side = 54;
+    constexpr int Symbol = 55;
+    constexpr int NoRelatedSym = 146;
+    constexpr int MDReqID = 262;
+    constexpr int MarketDepth = 264;
+  }
+
+  // "10=nnn" plus its delimiter
+  constexpr std::size_t FIX_TRAILER_SIZE = 7;
+
+  struct FixField {
+    int tag_ {0};
+    std::string_view value_;
+  };
+
+  // tag=value fields of one message, scanned in place
+  class FixFields {
+  public:
+    FixFields(std::string_view message, char delimiter) : rest_(message), delimiter_(delimiter) {}
+
+    // false at the end, and on a field that isn't tag=value<delimiter> (malformed() tells which)
+    bool next(FixField& field) {
+      if (rest_.empty() || malformed_) {
+        return false;
+      }
+      int tag = 0;
+      std::size_t i = 0;
+      for (; i < rest_.size() && rest_[i] >= '0' && rest_[i] <= '9'; ++i) {
+        tag = tag * 10 + (rest_[i] - '0');
+        if (tag > 1'000'000) {
+          break;
+        }
+      }
+      const auto end = rest_.find(delimiter_, i);
+      if (i == 0 || i == rest_.size() || rest_[i] != '=' || end == std::string_view::npos) {
+        malformed_ = true;
+        return false;
+      }
+      field = FixField{tag, rest_.substr(i + 1, end - i - 1)};
+      consumed_ += end + 1;
+      rest_.remove_prefix(end + 1);
+      return true;
+    }
+
+    // the next field has to be tag
+    bool require(int tag, std::string_view& value) {
+      FixField field;
+      if (!next(field) || field.tag_ != tag) {
+        return false;
+      }
+      value = field.value_;
+      return true;
+    }
+
+    bool malformed() const { return malformed_; }
+    // bytes scanned so far
+    std::size_t consumed() const { return consumed_; }
+
+  private:
+    std::string_view rest_;
+    std::size_t consumed_ {0};
+    char delimiter_;
+    bool malformed_ {false};
+  };
+
+  // FIX checksum: sum of every byte before the "10=" field, mod 256
+  unsigned fixCheckSum(std::string_view bytes) {
+    unsigned sum = 0;
+    for (char c : bytes) {
+      sum += static_cast<unsigned char>(c);
+    }
+    return sum % 256;
+  }
+
+  EventType fixMsgType(std::string_view msgType) {
+    if (msgType.size() == 1) {
+      switch (msgType[0]) {
+        case 'D': return EventType::NewOrder;
+        case 'F': return EventType::CancelOrder;
+        case 'V': return EventType::TopOfBook;   // or Depth, depends on 264
+      }
+    }
+    return EventType::Invalid;
+  }
+
   std::vector<std::string> parseCSVLine(std::string_view sv) {
     using It  = std::string_view::const_iterator;
     using Sep = boost::escaped_list_separator<char>;
@@ -21,9 +213,56 @@ namespace {
 }
 
 
+std::string_view toString(ParseError error) noexcept {
+  switch (error) {
+    case ParseError::Malformed:          return "Malformed";
+    case ParseError::UnknownEventType:   return "UnknownEventType";
+    case ParseError::MissingField:       return "MissingField";
+    case ParseError::InvalidNumber:      return "InvalidNumber";
+    case ParseError::InvalidSide:        return "InvalidSide";
+    case ParseError::InvalidType:        return "InvalidType";
+    case ParseError::InvalidPrice:       return "InvalidPrice";
+    case ParseError::InvalidDepth:       return "InvalidDepth";
+    case ParseError::InvalidLength:      return "InvalidLength";
+    case ParseError::UnsupportedVersion: return "UnsupportedVersion";
+    case ParseError::BadCheckSum:        return "BadCheckSum";
+    case ParseError::UnexpectedField:    return "UnexpectedField";
+    case ParseError::TooManyUsers:       return "TooManyUsers";
+  }
+  return "Unknown";
+}
+
+
+ParseResult EventParser::tryParse(std::string_view event) const {
+  try {
+    return parse(event);
+  } catch (const std::exception&) {
+    return std::unexpected(ParseError::Malformed);
+  }
+}
+
+EventParser::BatchResult EventParser::parseBatch(std::string_view payload, std::span<Event> out) const {
+  BatchResult result;
+  while (result.consumed_ < payload.size() && result.events_ < out.size()) {
+    const auto rest = payload.substr(result.consumed_);
+    const auto end = rest.find('\n');
+    const auto line = rest.substr(0, end);
+    result.consumed_ += end == std::string_view::npos ? rest.size() : end + 1;
+
+    if (trimView(line).empty()) {
+      continue;
+    }
+    if (auto event = tryParse(line)) {
+      out[result.events_++] = *event;
+    } else {
+      result.reject(event.error());
+    }
+  }
+  return result;
+}
+
 EventType CsvEventParser::getEventType(std::string_view event) const {
-  auto trimmedUpper = trimAndUpperCopy(event.substr(0, event.find(',')));
-  return toEventType(trimmedUpper);
+  return toEventType(event.substr(0, event.find(',')));
 }
 
 
@@ -42,6 +281,8 @@ Event CsvEventParser::parse(std::string_view event) const {
       return createCancelOrderEvent(tokens);
     case EventType::TopOfBook:
       return createTopOfBookEvent(tokens);
+    case EventType::Depth:
+      return createDepthEvent(tokens);
     case EventType::Quit:
       return createQuitEvent(tokens);
     default:
@@ -50,4 +291,538 @@ Event CsvEventParser::parse(std::string_view event) const {
 }
 
 
-} // namespace Exchange 
\ No newline at end of file
+EventType FastCsvEventParser::getEventType(std::string_view event) const {
+  return toEventType(event.substr(0, event.find(',')));
+}
+
+Event FastCsvEventParser::parse(std::string_view event) const {
+  return valueOrThrow(tryParse(event));
+}
+
+ParseResult FastCsvEventParser::tryParse(std::string_view event) const {
+  CsvFields fields {event};
+  return parseFields(fields);
+}
+
+Event FastCsvEventParser::parse(const SplitLine& line) const {
+  return valueOrThrow(tryParse(line));
+}
+
+ParseResult FastCsvEventParser::tryParse(const SplitLine& line) const {
+  SplitFields fields {line};
+  return parseFields(fields);
+}
+
+EventParser::BatchResult FastCsvEventParser::parseBatch(std::string_view payload, std::span<Event> out) const {
+  BatchResult result;
+  DelimiterScanner scanner {payload};
+  SplitLine line;
+  while (result.events_ < out.size() && scanner.nextLine(line)) {
+    // the line's '\n' (if it has one) is used up too
+    result.consumed_ = std::min(payload.size(), static_cast<std::size_t>(line.line_.data() - payload.data()) + line.line_.size() + 1);
+
+    if (trimView(line.line_).empty()) {
+      continue;
+    }
+    if (auto event = tryParse(line)) {
+      out[result.events_++] = *event;
+    } else {
+      result.reject(event.error());
+    }
+  }
+  return result;
+}
+
+template <class Fields>
+ParseResult FastCsvEventParser::parseFields(Fields& fields) const {
+  std::string_view field;
+  if (!fields.next(field)) {
+    return std::unexpected(ParseError::MissingField);
+  }
+  // the one and only look at the type
+  const auto eventType = toEventType(field);
+
+  switch (eventType) {
+    case EventType::NewOrder:
+    case EventType::CancelOrder:
+    case EventType::TopOfBook:
+    case EventType::Depth:
+      break;
+    case EventType::Quit:
+      return Event{std::in_place_type<QuitEvent>};
+    default:
+      return std::unexpected(ParseError::UnknownEventType);
+  }
+
+  // every order event starts with UserID, ClientOrderId, Symbol
+  std::string_view user, clientOrderIdField, symbolField;
+  if (!fields.next(user) || !fields.next(clientOrderIdField) || !fields.next(symbolField)) {
+    return std::unexpected(ParseError::MissingField);
+  }
+  OrderId clientOrderId {};
+  if (!toNumber(clientOrderIdField, clientOrderId)) {
+    return std::unexpected(ParseError::InvalidNumber);
+  }
+  const auto symbol = Symbol(symbolField);
+  const auto symbolId = symbols_->find(symbol);
+
+  Event result;
+  switch (eventType) {
+    case EventType::NewOrder: {
+      std::string_view quantityField, sideField, typeField;
+      if (!fields.next(quantityField) || !fields.next(sideField) || !fields.next(typeField)) {
+        return std::unexpected(ParseError::MissingField);
+      }
+      Quantity quantity {};
+      if (!toNumber(quantityField, quantity)) {
+        return std::unexpected(ParseError::InvalidNumber);
+      }
+      const auto side = toSide(sideField);
+      if (side == Side::Invalid) {
+        return std::unexpected(ParseError::InvalidSide);
+      }
+      const auto type = toType(typeField);
+      if (type == Type::Invalid) {
+        return std::unexpected(ParseError::InvalidType);
+      }
+      Price price = INVALID_PRICE;
+      if (type == Type::Limit) {
+        std::string_view priceField;
+        if (!fields.next(priceField)) {
+          return std::unexpected(ParseError::MissingField);
+        }
+        const auto parsed = tryParsePrice(priceField, symbols_->priceSpec(symbolId));
+        if (!parsed) {
+          return std::unexpected(ParseError::InvalidPrice);
+        }
+        price = *parsed;
+      }
+      result = Event{std::in_place_type<NewOrderEvent>, INVALID_USER_ID, clientOrderId, symbol, quantity, side, type, price};
+      break;
+    }
+    case EventType::CancelOrder: {
+      std::string_view origOrderIdField;
+      if (!fields.next(origOrderIdField)) {
+        return std::unexpected(ParseError::MissingField);
+      }
+      ExchangeOrderId origOrderId {};
+      if (!toNumber(origOrderIdField, origOrderId)) {
+        return std::unexpected(ParseError::InvalidNumber);
+      }
+      result = Event{std::in_place_type<CancelOrderEvent>, INVALID_USER_ID, clientOrderId, symbol, origOrderId};
+      break;
+    }
+    case EventType::TopOfBook:
+      result = Event{std::in_place_type<TopOfBookEvent>, INVALID_USER_ID, clientOrderId, symbol};
+      break;
+    case EventType::Depth: {
+      uint32_t levels = MAX_DEPTH_LEVELS;
+      std::string_view levelsField;
+      if (fields.next(levelsField)) {
+        int requested {0};
+        if (!toNumber(levelsField, requested)) {
+          return std::unexpected(ParseError::InvalidNumber);
+        }
+        if (requested <= 0) {
+          return std::unexpected(ParseError::InvalidDepth);
+        }
+        levels = static_cast<uint32_t>(requested);
+      }
+      result = Event{std::in_place_type<DepthEvent>, INVALID_USER_ID, clientOrderId, symbol, levels};
+      break;
+    }
+    default:
+      break;
+  }
+
+  // only once the whole message is good, so junk never grows the registry
+  const auto userId = users_->intern(user);
+  if (userId == INVALID_USER_ID) {
+    return std::unexpected(ParseError::TooManyUsers);
+  }
+  result.setUserId(userId);
+  result.setSymbolId(symbolId);
+  return result;
+}
+
+
+EventType BinaryEventParser::getEventType(std::string_view event) const {
+  if (event.size() < sizeof(Binary::Header)) {
+    return isTextQuit(event) ? EventType::Quit : EventType::Invalid;
+  }
+  switch (decode<Binary::Header>(event).type_) {
+    case Binary::MessageType::NewOrder:    return EventType::NewOrder;
+    case Binary::MessageType::CancelOrder: return EventType::CancelOrder;
+    case Binary::MessageType::TopOfBook:   return EventType::TopOfBook;
+    case Binary::MessageType::Depth:       return EventType::Depth;
+  }
+  return isTextQuit(event) ? EventType::Quit : EventType::Invalid;
+}
+
+Event BinaryEventParser::parse(std::string_view event) const {
+  return valueOrThrow(tryParse(event));
+}
+
+ParseResult BinaryEventParser::tryParse(std::string_view event) const {
+  using namespace Binary;
+
+  if (isTextQuit(event)) {
+    return Event{std::in_place_type<QuitEvent>};
+  }
+  if (event.size() < sizeof(Header)) {
+    return std::unexpected(ParseError::InvalidLength);
+  }
+  const auto header = decode<Header>(event);
+  const auto expected = messageSize(header.type_);
+  if (expected == 0) {
+    return std::unexpected(ParseError::UnknownEventType);
+  }
+  if (header.version_ != PROTOCOL_VERSION) {
+    return std::unexpected(ParseError::UnsupportedVersion);
+  }
+  if (littleEndian(header.length_) != expected || event.size() != expected) {
+    return std::unexpected(ParseError::InvalidLength);
+  }
+
+  // every message starts with the same order fields right after the header
+  const auto order = decode<OrderFields>(event.substr(sizeof(Header)));
+  const auto clientOrderId = static_cast<OrderId>(littleEndian(order.clientOrderId_));
+  const auto symbol = Symbol(fieldView(order.symbol_));
+  const auto symbolId = symbols_->find(symbol);
+
+  Event result;
+  switch (header.type_) {
+    case MessageType::NewOrder: {
+      const auto message = decode<NewOrderMessage>(event);
+      Side side = Side::Invalid;
+      switch (message.side_) {
+        case WireSide::Buy:  side = Side::Buy; break;
+        case WireSide::Sell: side = Side::Sell; break;
+      }
+      if (side == Side::Invalid) {
+        return std::unexpected(ParseError::InvalidSide);
+      }
+      Type type = Type::Invalid;
+      switch (message.type_) {
+        case WireType::Market: type = Type::Market; break;
+        case WireType::Limit:  type = Type::Limit; break;
+      }
+      if (type == Type::Invalid) {
+        return std::unexpected(ParseError::InvalidType);
+      }
+      const Price price = type == Type::Limit ? Price{littleEndian(message.price_)} : INVALID_PRICE;
+      result = Event{std::in_place_type<NewOrderEvent>, INVALID_USER_ID, clientOrderId, symbol,
+                     static_cast<Quantity>(littleEndian(message.quantity_)), side, type, price};
+      break;
+    }
+    case MessageType::CancelOrder: {
+      const auto message = decode<CancelOrderMessage>(event);
+      result = Event{std::in_place_type<CancelOrderEvent>, INVALID_USER_ID, clientOrderId, symbol,
+                     static_cast<ExchangeOrderId>(littleEndian(message.origOrderId_))};
+      break;
+    }
+    case MessageType::TopOfBook:
+      result = Event{std::in_place_type<TopOfBookEvent>, INVALID_USER_ID, clientOrderId, symbol};
+      break;
+    case MessageType::Depth: {
+      const auto levels = littleEndian(decode<DepthMessage>(event).levels_);
+      result = Event{std::in_place_type<DepthEvent>, INVALID_USER_ID, clientOrderId, symbol,
+                     levels == 0 ? MAX_DEPTH_LEVELS : levels};
+      break;
+    }
+  }
+
+  // user goes in last, same as the csv one, so junk never grows the registry
+  const auto userId = users_->intern(fieldView(order.user_));
+  if (userId == INVALID_USER_ID) {
+    return std::unexpected(ParseError::TooManyUsers);
+  }
+  result.setUserId(userId);
+  result.setSymbolId(symbolId);
+  return result;
+}
+
+EventParser::BatchResult BinaryEventParser::parseBatch(std::string_view payload, std::span<Event> out) const {
+  BatchResult result;
+  while (result.consumed_ < payload.size() && result.events_ < out.size()) {
+    const auto rest = payload.substr(result.consumed_);
+    if (isTextQuit(rest)) {
+      out[result.events_++] = Event{std::in_place_type<QuitEvent>};
+      result.consumed_ = payload.size();
+      break;
+    }
+    const auto length = messageLength(rest);
+    if (length == 0 || length > rest.size()) {
+      // no way to find the next message, the rest of the datagram goes
+      result.reject(ParseError::InvalidLength);
+      result.consumed_ = payload.size();
+      break;
+    }
+    if (auto event = tryParse(rest.substr(0, length))) {
+      out[result.events_++] = *event;
+    } else {
+      result.reject(event.error());
+    }
+    result.consumed_ += length;
+  }
+  return result;
+}
+
+
+EventType FixEventParser::getEventType(std::string_view event) const {
+  if (isTextQuit(event)) {
+    return EventType::Quit;
+  }
+  FixFields fields {event, delimiter_};
+  FixField field;
+  while (fields.next(field)) {
+    if (field.tag_ == FixTag::MsgType) {
+      return fixMsgType(field.value_);
+    }
+  }
+  return EventType::Invalid;
+}
+
+Event FixEventParser::parse(std::string_view event) const {
+  return valueOrThrow(tryParse(event));
+}
+
+ParseResult FixEventParser::tryParse(std::string_view event) const {
+  if (isTextQuit(event)) {
+    return Event{std::in_place_type<QuitEvent>};
+  }
+
+  // trailer first, 10=nnn has to be the last field and match the sum of everything before it
+  const auto trailerStart = event.size() < FIX_TRAILER_SIZE ? 0 : event.size() - FIX_TRAILER_SIZE;
+  const auto trailer = event.substr(trailerStart);
+  if (trailerStart == 0 || event[trailerStart - 1] != delimiter_ || !trailer.starts_with("10=") || trailer.back() != delimiter_) {
+    return std::unexpected(ParseError::InvalidLength);
+  }
+  unsigned checkSum {0};
+  if (!toNumber(trailer.substr(3, 3), checkSum) || checkSum != fixCheckSum(event.substr(0, trailerStart))) {
+    return std::unexpected(ParseError::BadCheckSum);
+  }
+
+  FixFields fields {event.substr(0, trailerStart), delimiter_};
+  std::string_view beginString, bodyLengthField, msgType;
+  if (!fields.require(FixTag::BeginString, beginString)) {
+    return std::unexpected(ParseError::UnexpectedField);
+  }
+  if (beginString != "FIX.4.2" && beginString != "FIX.4.4") {
+    return std::unexpected(ParseError::UnsupportedVersion);
+  }
+  std::size_t bodyLength {0};
+  if (!fields.require(FixTag::BodyLength, bodyLengthField) || !toNumber(bodyLengthField, bodyLength) ||
+      bodyLength != trailerStart - fields.consumed()) {
+    return std::unexpected(ParseError::InvalidLength);
+  }
+  if (!fields.require(FixTag::MsgType, msgType)) {
+    return std::unexpected(ParseError::UnexpectedField);
+  }
+  const auto eventType = fixMsgType(msgType);
+  if (eventType == EventType::Invalid) {
+    return std::unexpected(ParseError::UnknownEventType);
+  }
+
+  // only what we need, the rest of the tags go by
+  std::string_view sender, clOrdId, symbolField, orderQty, sideField, ordType, priceField, orderId, mdReqId, marketDepth;
+  FixField field;
+  while (fields.next(field)) {
+    switch (field.tag_) {
+      case FixTag::SenderCompID: sender = field.value_; break;
+      case FixTag::ClOrdID:      clOrdId = field.value_; break;
+      case FixTag::Symbol:
+        if (!symbolField.empty()) {
+          return std::unexpected(ParseError::UnexpectedField);
+        }
+        symbolField = field.value_;
+        break;
+      case FixTag::OrderQty:     orderQty = field.value_; break;
+      case FixTag::Side:         sideField = field.value_; break;
+      case FixTag::OrdType:      ordType = field.value_; break;
+      case FixTag::Price:        priceField = field.value_; break;
+      case FixTag::OrderID:      orderId = field.value_; break;
+      case FixTag::MDReqID:      mdReqId = field.value_; break;
+      case FixTag::MarketDepth:  marketDepth = field.value_; break;
+      case FixTag::NoRelatedSym:
+        if (field.value_ != "1") {
+          return std::unexpected(ParseError::UnexpectedField);
+        }
+        break;
+      case FixTag::BeginString:
+      case FixTag::BodyLength:
+      case FixTag::MsgType:
+        return std::unexpected(ParseError::UnexpectedField);
+      default:
+        break;
+    }
+  }
+  if (fields.malformed()) {
+    return std::unexpected(ParseError::Malformed);
+  }
+  if (sender.empty() || symbolField.empty()) {
+    return std::unexpected(ParseError::MissingField);
+  }
+
+  const auto symbol = Symbol(symbolField);
+  const auto symbolId = symbols_->find(symbol);
+
+  Event result;
+  switch (eventType) {
+    case EventType::NewOrder: {
+      if (clOrdId.empty() || orderQty.empty() || sideField.empty() || ordType.empty()) {
+        return std::unexpected(ParseError::MissingField);
+      }
+      OrderId clientOrderId {};
+      Quantity quantity {};
+      if (!toNumber(clOrdId, clientOrderId) || !toNumber(orderQty, quantity)) {
+        return std::unexpected(ParseError::InvalidNumber);
+      }
+      // our Side/Type values are the FIX ones
+      const auto side = toSide(sideField);
+      if (side == Side::Invalid) {
+        return std::unexpected(ParseError::InvalidSide);
+      }
+      const auto type = toType(ordType);
+      if (type == Type::Invalid) {
+        return std::unexpected(ParseError::InvalidType);
+      }
+      Price price = INVALID_PRICE;
+      if (type == Type::Limit) {
+        if (priceField.empty()) {
+          return std::unexpected(ParseError::MissingField);
+        }
+        const auto parsed = tryParsePrice(priceField, symbols_->priceSpec(symbolId));
+        if (!parsed) {
+          return std::unexpected(ParseError::InvalidPrice);
+        }
+        price = *parsed;
+      }
+      result = Event{std::in_place_type<NewOrderEvent>, INVALID_USER_ID, clientOrderId, symbol, quantity, side, type, price};
+      break;
+    }
+    case EventType::CancelOrder: {
+      if (clOrdId.empty() || orderId.empty()) {
+        return std::unexpected(ParseError::MissingField);
+      }
+      OrderId clientOrderId {};
+      ExchangeOrderId origOrderId {};
+      if (!toNumber(clOrdId, clientOrderId) || !toNumber(orderId, origOrderId)) {
+        return std::unexpected(ParseError::InvalidNumber);
+      }
+      result = Event{std::in_place_type<CancelOrderEvent>, INVALID_USER_ID, clientOrderId, symbol, origOrderId};
+      break;
+    }
+    case EventType::TopOfBook: {
+      if (mdReqId.empty()) {
+        return std::unexpected(ParseError::MissingField);
+      }
+      OrderId clientOrderId {};
+      int depth {1};
+      if (!toNumber(mdReqId, clientOrderId) || (!marketDepth.empty() && !toNumber(marketDepth, depth))) {
+        return std::unexpected(ParseError::InvalidNumber);
+      }
+      if (depth < 0) {
+        return std::unexpected(ParseError::InvalidDepth);
+      }
+      if (depth == 1) {
+        result = Event{std::in_place_type<TopOfBookEvent>, INVALID_USER_ID, clientOrderId, symbol};
+      } else {
+        const auto levels = depth == 0 ? MAX_DEPTH_LEVELS : static_cast<uint32_t>(depth);
+        result = Event{std::in_place_type<DepthEvent>, INVALID_USER_ID, clientOrderId, symbol, levels};
+      }
+      break;
+    }
+    default:
+      return result;    // nothing with a user in it
+  }
+
+  // user goes in last, same as the csv one, so junk never grows the registry
+  const auto userId = users_->intern(sender);
+  if (userId == INVALID_USER_ID) {
+    return std::unexpected(ParseError::TooManyUsers);
+  }
+  result.setUserId(userId);
+
+  result.setSymbolId(symbolId);
+  return result;
+}
+
+std::size_t FixEventParser::messageLength(std::string_view payload) const {
+  // 8=FIX.4.x<d>9=nnn<d> then nnn bytes of body then the trailer
+  FixFields fields {payload, delimiter_};
+  std::string_view beginString, bodyLengthField;
+  std::size_t bodyLength {0};
+  if (!fields.require(FixTag::BeginString, beginString) || !fields.require(FixTag::BodyLength, bodyLengthField) ||
+      !toNumber(bodyLengthField, bodyLength)) {
+    return 0;
+  }
+  const auto length = fields.consumed() + bodyLength + FIX_TRAILER_SIZE;
+  return length <= payload.size() ? length : 0;
+}
+
+EventParser::BatchResult FixEventParser::parseBatch(std::string_view payload, std::span<Event> out) const {
+  BatchResult result;
+  while (result.events_ < out.size()) {
+    // newlines and such between messages
+    while (result.consumed_ < payload.size() && std::isspace(static_cast<unsigned char>(payload[result.consumed_]))) {
+      ++result.consumed_;
+    }
+    if (result.consumed_ == payload.size()) {
+      break;
+    }
+    const auto rest = payload.substr(result.consumed_);
+    if (isTextQuit(rest)) {
+      out[result.events_++] = Event{std::in_place_type<QuitEvent>};
+      result.consumed_ = payload.size();
+      break;
+    }
+    const auto length = messageLength(rest);
+    if (length == 0) {
+      // no way to find the next message, the rest of the datagram goes
+      result.reject(ParseError::InvalidLength);
+      result.consumed_ = payload.size();
+      break;
+    }
+    if (auto event = tryParse(rest.substr(0, length))) {
+      out[result.events_++] = *event;
+    } else {
+      result.reject(event.error());
+    }
+    result.consumed_ += length;
+  }
+  return result;
+}
+
+std::string FixEventParser::frame(std::string_view body, std::string_view beginString, char delimiter) {
+  std::string message;
+  std::format_to(std::back_inserter(message), "8={}{}9={}{}{}", beginString, delimiter, body.size(), delimiter, body);
+  std::format_to(std::back_inserter(message), "10={:03}{}", fixCheckSum(message), delimiter);
+  return message;
+}
+
+
+WireFormat toWireFormat(std::string_view format) {
+  if (equalsIgnoreCase(format, "csv")) {
+    return WireFormat::Csv;
+  } else if (equalsIgnoreCase(format, "binary")) {
+    return WireFormat::Binary;
+  } else if (equalsIgnoreCase(format, "fix")) {
+    return WireFormat::Fix;
+  }
+  throw std::invalid_argument("Invalid wire format: " + std::string(format));
+}
+
+std::unique_ptr<EventParser> makeEventParser(WireFormat format, UserRegistry& users, const SymbolRegistry& symbols) {
+  switch (format) {
+    case WireFormat::Binary:
+      return std::make_unique<BinaryEventParser>(users, symbols);
+    case WireFormat::Fix:
+      return std::make_unique<FixEventParser>(users, symbols);
+    case WireFormat::Csv:
+      break;
+  }
+  return std::make_unique<FastCsvEventParser>(users, symbols);
+}
+
+} // namespace Exchange
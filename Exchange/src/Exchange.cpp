@@ -1,14 +1,24 @@
 #include "Exchange.h"
 
-#include <iostream>
+#include <algorithm>
+#include <span>
 
+#include "Clock.h"
 #include "Event.h"
 #include "EventParser.h"
 
 namespace Exchange {
 
 
-Exchange::Exchange(EventQueue& eventQueue, EventParser& eventParser, OrderBookManager& orderBookManager) : orderBookManager_(orderBookManager), eventParser_(eventParser), eventQueue_(eventQueue){
+Exchange::Exchange(EventQueue& eventQueue, EventParser& eventParser, IOrderBookManager& orderBookManager) : orderBookManager_(orderBookManager), eventParser_(eventParser), eventQueue_(eventQueue){
+  // here rather than on the first message the ingress thread stamps
+  Clock::calibrate();
+}
+
+Exchange::Exchange(EventQueue& eventQueue, WireFormat wireFormat, IOrderBookManager& orderBookManager)
+  : orderBookManager_(orderBookManager), ownedEventParser_(makeEventParser(wireFormat)),
+    eventParser_(*ownedEventParser_), eventQueue_(eventQueue) {
+  Clock::calibrate();
 }
 
 Exchange::~Exchange() {
@@ -17,7 +27,7 @@ Exchange::~Exchange() {
 }
 
 void Exchange::start() {
-  eventQueueSubscription_ = eventQueue_.subscribeWith(&Exchange::processEvent, this);
+  eventQueueSubscription_ = eventQueue_.subscribeBatch([this](EventQueue::MessageBatch messages) { processBatch(messages); });
 
   std::unique_lock<std::mutex> lock(stopMutex_);
   
@@ -38,28 +48,47 @@ void Exchange::handleStop() {
   orderBookManager_.stop();
 }
 
-void Exchange::processEvent(const std::string& eventStr) {
-    EventType eventType = eventParser_.getEventType(eventStr);
-    
-    switch (eventType) {
-      case EventType::Quit:
-        requestStop();
-        break;
-      case EventType::NewOrder:
-      case EventType::CancelOrder:
-      case EventType::TopOfBook:
-        try {
-          auto event = eventParser_.parse(eventStr);
-          orderBookManager_.submit(std::move(event));
-          // std::cout << "Processed event: " << toString(eventPtr->type()) << std::endl;
-        } catch (const std::exception& e) {
-          std::cerr << "Error processing event: " << e.what() << std::endl;
-        }
-        break;
-      default:
-        std::cerr << "Unknown event type: " << eventStr << std::endl;
+void Exchange::processBatch(EventQueue::MessageBatch messages) {
+    // the one clock read per receive, everything downstream uses the event's timestamp
+    const auto received = Clock::now();
+    for (const auto& payload : messages) {
+      if (!processEvent(payload, received)) {
+        return;
+      }
+    }
+}
+
+bool Exchange::processEvent(std::string_view payload, Timestamp received) {
+    std::string_view rest {payload};
+    while (!rest.empty()) {
+      const auto result = eventParser_.parseBatch(rest, batch_);
+      rejects_.add(result);
+      if (result.consumed_ == 0) {
         break;
+      }
+      rest.remove_prefix(result.consumed_);
+
+      auto events = std::span<Event>(batch_).first(result.events_);
+      // anything after a quit is dropped
+      const auto quit = std::ranges::find_if(events, [](const Event& event) {
+        return std::holds_alternative<QuitEvent>(event.data_);
+      });
+      const bool quitRequested = quit != events.end();
+      events = events.first(static_cast<std::size_t>(quit - events.begin()));
+
+      for (auto& event : events) {
+        event.setTimestamp(received);
+      }
+      if (!events.empty()) {
+        orderBookManager_.submit(std::span<const Event>(events));
+      }
+
+      if (quitRequested) {
+        requestStop();
+        return false;
+      }
     }
+    return true;
 }
 
 } // namespace Exchange
\ No newline at end of file
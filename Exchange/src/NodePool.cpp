@@ -0,0 +1,85 @@
+#include "NodePool.h"
+
+#include <algorithm>
+#include <cassert>
+
+namespace Exchange {
+
+namespace {
+  constexpr std::size_t BLOCK_ALIGNMENT = alignof(std::max_align_t);
+
+  constexpr std::size_t roundUp(std::size_t size, std::size_t alignment) {
+    return (size + alignment - 1) / alignment * alignment;
+  }
+}
+
+NodePool::NodePool(std::size_t blockSize, NodePoolConfig config)
+  : blockSize_(roundUp(std::max(blockSize, sizeof(FreeBlock)), BLOCK_ALIGNMENT)), config_(config) {
+  config_.blocksPerChunk = std::max<std::size_t>(config_.blocksPerChunk, 1);
+  if (config_.initialCapacity > 0) {
+    addChunk(config_.initialCapacity);
+  }
+}
+
+void* NodePool::allocate() {
+  if (!freeList_) {
+    addChunk(config_.blocksPerChunk);
+  }
+  FreeBlock* block = freeList_;
+  freeList_ = block->next;
+
+  stats_.peak = std::max(stats_.peak, ++stats_.live);
+  return block;
+}
+
+void NodePool::deallocate(void* p) noexcept {
+  if (!p) {
+    return;
+  }
+  assert(stats_.live > 0 && "NodePool: deallocating more than we handed out");
+  auto* block = static_cast<FreeBlock*>(p);
+  block->next = freeList_;
+  freeList_ = block;
+  --stats_.live;
+}
+
+void NodePool::addChunk(std::size_t blocks) {
+  // new[] of std::byte is only guaranteed max_align_t alignment, which is all we promise
+  auto chunk = std::make_unique<std::byte[]>(blocks * blockSize_);
+  std::byte* base = chunk.get();
+
+  // thread the new blocks onto the free list back to front so they get handed out in address order
+  for (std::size_t i = blocks; i-- > 0;) {
+    auto* block = reinterpret_cast<FreeBlock*>(base + i * blockSize_);
+    block->next = freeList_;
+    freeList_ = block;
+  }
+
+  chunks_.push_back(std::move(chunk));
+  ++stats_.chunks;
+  stats_.capacity += blocks;
+}
+
+NodePool& NodeArena::pool(std::size_t blockSize) {
+  const auto rounded = roundUp(blockSize, BLOCK_ALIGNMENT);
+  for (auto& pool : pools_) {
+    if (pool->blockSize() == rounded) {
+      return *pool;
+    }
+  }
+  return *pools_.emplace_back(std::make_unique<NodePool>(blockSize, config_));
+}
+
+NodePoolStats NodeArena::stats() const {
+  NodePoolStats total;
+  for (const auto& pool : pools_) {
+    const auto& stats = pool->stats();
+    total.live += stats.live;
+    total.peak += stats.peak;
+    total.chunks += stats.chunks;
+    total.capacity += stats.capacity;
+  }
+  return total;
+}
+
+} // namespace Exchange
@@ -1,157 +1,20 @@
 #include "OrderBookManager.h"
-#include <iostream>
 #include <thread>
 
 
 namespace Exchange {
 
-  namespace {
-
-    constexpr unsigned MAX_BATCH_SIZE = 32;
-
-    void backoff(unsigned n) {
-      if (n < 32) std::this_thread::yield();
-      else std::this_thread::sleep_for(std::chrono::microseconds(1));
-  }
+namespace detail {
 
+  void backoff(unsigned n) {
+    if (n < 32) std::this_thread::yield();
+    else std::this_thread::sleep_for(std::chrono::microseconds(1));
   }
 
-IOrderBookManager::~IOrderBookManager() = default;
-
-OrderBookManager::OrderBookManager(OrderBookManager::OrderBookMap&& map, int numShards) 
-{  
-  // // at least 2 threads otherwise what's even the point amirite
-  numShards = std::max(2, numShards);
-  shards_.reserve(numShards);  
-  for (int i = 0; i < numShards; ++i) {
-    shards_.emplace_back(std::make_unique<Shard>());
-  }
-
-  // TOOD: move to ConfigManager and clone the given map
-  for (std::string_view symStr : {"AAPL", "GOOGL", "MSFT", "AMZN", "META", "NVDA"}) {
-    auto symbol = Symbol{symStr};
-    auto it = map.find(symbol);
-    auto& shard = shards_[shardIdx(symbol)];
-    if (it == map.end()) {
-      auto sink = std::make_unique<ReportSink>();
-      shard->orderBooks_[symbol] = std::make_unique<OrderBook<ReportSink>>(symbol, std::move(sink));
-    }
-    else {
-      shard->orderBooks_[symbol] = std::move(it->second);
-    }
-  }
-
-  std::ranges::for_each(shards_, [](auto& shard) { shard->start(); });
-}
-
-OrderBookManager::~OrderBookManager() {
-  stop();
-}
-
-void OrderBookManager::stop() {
-  if (!stopRequested_.exchange(true)) {
-    for (auto& shard : shards_) {
-      shard->stop();
-    }
-  }
-}
-
-
-bool OrderBookManager::submit(Event event) {
-  if (stopRequested_.load()) {
-    return false;
-  }
-
-  auto idx  {shardIdx(event.symbol())};
-  return shards_[idx]->submit(std::move(event));
-}
-
-size_t OrderBookManager::shardIdx(Symbol symbol) const {
-  return std::hash<Symbol>()(symbol) % shards_.size();
 }
 
-void OrderBookManager::Shard::start() {
-  thread_ = std::jthread([this]() { processEvents(); });
-}
-
-void OrderBookManager::Shard::stop() {
-  if (!stopRequested_.exchange(true)) {
-    semaphore_.release(1);
-    thread_.join();
-  }
-}
-
-bool OrderBookManager::Shard::submit(Event&& event) {
-  if (stopRequested_.load()) {
-    return false;
-  }
-  // TODO: review this, moving from the event but might still return false
-  if (!eventQueue_.push(std::move(event))) {
-    return false;
-  }
-  semaphore_.release(1);
-  return true;
-}
-
-void OrderBookManager::Shard::processEvents() {
-  while (true) {
-      semaphore_.acquire();
-      if (stopRequested_.load()) {
-        break;
-      }
-
-      Event event;
-
-      unsigned int spinCount {0};
-      while (!eventQueue_.pop(event)) {
-        backoff(spinCount++);
-      }
-      processEvent(std::move(event));
-
-      // opportunistic batching
-      unsigned int grabbed {0};
-      while (!stopRequested_.load() && grabbed < MAX_BATCH_SIZE && semaphore_.try_acquire()) {
-          if (stopRequested_.load()) {
-            semaphore_.release(); // return the token so a blocked worker can wake
-            break;
-          }
-
-          if (eventQueue_.pop(event)) { processEvent(std::move(event)); ++grabbed; }
-          else { semaphore_.release(1); break; } // return token if we lost the race
-      }
-    }
-
-    // TODO: decide if want to drain the queue here
-}
-
-void OrderBookManager::Shard::processEvent(Event&& arg) {
-  auto event = std::move(arg.data_);
-
-  auto findAndInvoke = [this](auto&& event, auto&& memFunc) {
-    auto it = orderBooks_.find(event.symbol());
-    if (it != orderBooks_.end()) {
-      std::invoke(memFunc, (*it->second), std::forward<decltype(event)>(event));
-    }
-    else {
-      std::cout << "OrderBookManager::processEvent: Symbol not found: " << toString(event.eventType()) << " " << event.symbol() << std::endl;
-    }
-  };
-
-  std::visit([findAndInvoke](auto&& event) {
-    using T = std::decay_t<decltype(event)>;
-    if constexpr (std::is_same_v<T, NewOrderEvent>) {
-      findAndInvoke(std::forward<decltype(event)>(event), &IOrderBook::submitNewOrder);
-    }
-    else if constexpr (std::is_same_v<T, CancelOrderEvent>) {
-      findAndInvoke(std::forward<decltype(event)>(event), &IOrderBook::submitCancelOrder);
-    }
-    else if constexpr (std::is_same_v<T, TopOfBookEvent>) {
-      findAndInvoke(std::forward<decltype(event)>(event), &IOrderBook::submitTopOfBook);
-    } 
-    else
-        std::cout << "Unknown Event "  << '\n';
-  }, std::move(event));
+IOrderBookManager::~IOrderBookManager() = default;
 
-}
+template class BasicOrderBookManager<IOrderBook>;
 
-} // namespace Exchange 
\ No newline at end of file
+} // namespace Exchange
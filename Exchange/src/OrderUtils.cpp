@@ -1,38 +1,46 @@
 #include "OrderUtils.h"
 #include "CommonUtils.h"
+#include "TokenTable.h"
+
+#include <algorithm>
+#include <charconv>
+#include <stdexcept>
 
 namespace Exchange {
 
 namespace {
-  static const char* BUY = "BUY";
-  static const char* SELL = "SELL";
+  // names or FIX values, any case
+  constexpr TokenTable<Side, 4> SIDES {{
+    {"BUY", Side::Buy}, {"1", Side::Buy},
+    {"SELL", Side::Sell}, {"2", Side::Sell},
+  }, Side::Invalid};
+
+  constexpr TokenTable<Type, 4> TYPES {{
+    {"MARKET", Type::Market}, {"1", Type::Market},
+    {"LIMIT", Type::Limit}, {"2", Type::Limit},
+  }, Type::Invalid};
+
+  static_assert(SIDES.decode(" buy ") == Side::Buy && SIDES.decode("BUYS") == Side::Invalid);
+
+  constexpr int MAX_PRICE_DIGITS = 18;   // per side of the point, 10^18 still fits an int64
 
-  static const char* MARKET = "MARKET";
-  static const char* LIMIT = "LIMIT";
+  constexpr int64_t pow10(int exponent) {
+    int64_t value = 1;
+    while (exponent-- > 0) {
+      value *= 10;
+    }
+    return value;
+  }
+
+  bool isDigit(char c) { return c >= '0' && c <= '9'; }
 }
 
 Side toSide(std::string_view side) {
-    auto upperSide = trimAndUpperCopy(side);
-    
-    if (upperSide == BUY || upperSide == "1") {
-        return Side::Buy;
-    } else if (upperSide == SELL || upperSide == "2") {
-        return Side::Sell;
-    }
-    
-    return Side::Invalid;
+    return SIDES.decode(side);
 }
 
 Type toType(std::string_view type) {
-    auto upperType = trimAndUpperCopy(type);
-    
-    if (upperType == MARKET || upperType == "1") {
-        return Type::Market;
-    } else if (upperType == LIMIT || upperType == "2") {
-        return Type::Limit;
-    }
-    
-    return Type::Invalid;
+    return TYPES.decode(type);
 }
 
 Price toPrice(double price, const PriceSpec& spec) {
@@ -46,4 +54,108 @@ Price toPrice(double price, const PriceSpec& spec) {
   return Price{ scaled_i / spec.tick_scaled };
 }
 
-} // namespace Exchange 
\ No newline at end of file
+std::expected<Price, PriceError> tryParsePrice(std::string_view text, const PriceSpec& spec) noexcept {
+  auto it = text.begin();
+  const bool negative = it != text.end() && *it == '-';
+  if (it != text.end() && (*it == '-' || *it == '+')) {
+    ++it;
+  }
+
+  int64_t whole {0};
+  int wholeDigits {0};
+  for (; it != text.end() && isDigit(*it); ++it) {
+    if (++wholeDigits > MAX_PRICE_DIGITS) {
+      return std::unexpected(PriceError::OutOfRange);
+    }
+    whole = whole * 10 + (*it - '0');
+  }
+
+  // fraction as fraction / 10^fractionDigits, trailing zeros don't count
+  int64_t fraction {0};
+  int fractionDigits {0};
+  int pendingZeros {0};
+  if (it != text.end() && *it == '.') {
+    for (++it; it != text.end() && isDigit(*it); ++it) {
+      if (*it == '0') {
+        ++pendingZeros;
+        continue;
+      }
+      fractionDigits += pendingZeros + 1;
+      if (fractionDigits > spec.decimals()) {
+        return std::unexpected(PriceError::TooManyDecimals);
+      }
+      fraction = fraction * pow10(pendingZeros + 1) + (*it - '0');
+      pendingZeros = 0;
+    }
+  }
+
+  if (it != text.end() || (wholeDigits == 0 && fractionDigits == 0 && pendingZeros == 0)) {
+    return std::unexpected(PriceError::Invalid);
+  }
+  if (whole > std::numeric_limits<int64_t>::max() / spec.scale - 1) {
+    return std::unexpected(PriceError::OutOfRange);
+  }
+
+  int64_t scaled = whole * spec.scale + fraction * (spec.scale / pow10(fractionDigits));
+  if (negative) {
+    scaled = -scaled;
+  }
+  if (scaled % spec.tick_scaled != 0) {
+    return std::unexpected(PriceError::OffTick);
+  }
+  return Price{ scaled / spec.tick_scaled };
+}
+
+Price parsePrice(std::string_view text, const PriceSpec& spec) {
+  const auto price = tryParsePrice(text, spec);
+  if (price) {
+    return *price;
+  }
+  switch (price.error()) {
+    case PriceError::OutOfRange:
+      throw std::out_of_range("Price out of range: " + std::string(text));
+    case PriceError::TooManyDecimals:
+      throw std::invalid_argument("Price has more decimals than the price spec: " + std::string(text));
+    case PriceError::OffTick:
+      throw std::invalid_argument("Price is not on a tick grid");
+    case PriceError::Invalid:
+      break;
+  }
+  throw std::invalid_argument("Invalid price: " + std::string(text));
+}
+
+char* formatPrice(char* out, Price price, const PriceSpec& spec) {
+  if (price == MARKET_PRICE) {
+    constexpr std::string_view text {"MKT"};
+    return std::copy(text.begin(), text.end(), out);
+  }
+
+  const int64_t scaled = price.ticks * spec.tick_scaled;
+  // magnitude as unsigned so INT64_MIN doesn't overflow
+  uint64_t magnitude = scaled < 0 ? 0 - static_cast<uint64_t>(scaled) : static_cast<uint64_t>(scaled);
+  if (scaled < 0) {
+    *out++ = '-';
+  }
+
+  const auto scale = static_cast<uint64_t>(spec.scale);
+  out = std::to_chars(out, out + MAX_PRICE_CHARS, magnitude / scale).ptr;
+
+  const int decimals = spec.decimals();
+  if (decimals > 0) {
+    *out++ = '.';
+    uint64_t fraction = magnitude % scale;
+    for (int i = decimals - 1; i >= 0; --i) {
+      out[i] = static_cast<char>('0' + fraction % 10);
+      fraction /= 10;
+    }
+    out += decimals;
+  }
+  return out;
+}
+
+std::string toString(Price price, const PriceSpec& spec) {
+  char buf[MAX_PRICE_CHARS];
+  return std::string(buf, formatPrice(buf, price, spec));
+}
+
+} // namespace Exchange
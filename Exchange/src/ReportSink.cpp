@@ -7,7 +7,7 @@ namespace {
   constexpr int MAX_ITEMS_PER_BATCH = 64;
 }
 
-ReportSink::ReportSink() {
+ReportSink::ReportSink(const SymbolRegistry& symbols) : symbols_(symbols) {
   thread = std::jthread([this] {
     run();
   });
@@ -60,10 +60,10 @@ void ReportSink::run() {
   }
 }
 
-bool ReportSink::submitFills(ExecutionReportCollection&& fills) {
+bool ReportSink::submitFills(ExecutionReportView fills) {
   size_t numPushed = 0;
-  for (auto& report : fills) {
-    if (queue_.push(QueueItem(std::in_place_type<ExecutionReport>, std::move(report)))) {
+  for (const auto& report : fills) {
+    if (queue_.push(QueueItem(std::in_place_type<ExecutionReport>, report))) {
       numPushed++;
     } else {
       // TODO: handle this case
@@ -71,14 +71,22 @@ bool ReportSink::submitFills(ExecutionReportCollection&& fills) {
     }
   }
   if (numPushed > 0) {
-    semaphore_.release(numPushed);
+    notify(static_cast<std::ptrdiff_t>(numPushed));
   }
   return numPushed > 0;
 }
 
+bool ReportSink::submitAcceptedOrder(OrderAcceptedReport&& report) {
+  if (queue_.push(QueueItem(std::in_place_type<OrderAcceptedReport>, std::move(report)))) {
+    notify(1);
+    return true;
+  }
+  return false;
+}
+
 bool ReportSink::submitCanceledOrder(OrderCanceledReport&& report) {
   if (queue_.push(QueueItem(std::in_place_type<OrderCanceledReport>, std::move(report)))) {
-    semaphore_.release();
+    notify(1);
     return true;
   }
   return false;
@@ -86,23 +94,69 @@ bool ReportSink::submitCanceledOrder(OrderCanceledReport&& report) {
 
 bool ReportSink::submitTopOfBook(TopOfBookReport&& report) {
   if (queue_.push(QueueItem(std::in_place_type<TopOfBookReport>, std::move(report)))) {
-    semaphore_.release();
+    notify(1);
     return true;
   }
   return false;
 }
 
+bool ReportSink::submitDepth(DepthReport&& report) {
+  // we're the only producer: with a free slot for the marker now, its push below can't fail
+  // and leave a snapshot behind that the next marker would pick up
+  if (queue_.write_available() == 0 || !depthQueue_.push(std::move(report))) {
+    return false;
+  }
+  queue_.push(QueueItem(std::in_place_type<DepthReady>));
+  notify(1);
+  return true;
+}
+
+void ReportSink::beginBatch() {
+  batching_ = true;
+}
+
+void ReportSink::endBatch() {
+  batching_ = false;
+  if (pendingNotifications_ > 0) {
+    semaphore_.release(pendingNotifications_);
+    pendingNotifications_ = 0;
+  }
+}
+
+void ReportSink::notify(std::ptrdiff_t count) {
+  if (batching_) {
+    pendingNotifications_ += count;
+  } else {
+    semaphore_.release(count);
+  }
+}
+
 void ReportSink::report(QueueItem&& item) {
-  std::visit([](auto&& arg) {
+  std::visit([this](auto&& arg) {
     using T = std::decay_t<decltype(arg)>;
-    if constexpr (std::is_same_v<T, ExecutionReport> 
-               || std::is_same_v<T, OrderCanceledReport> 
-               || std::is_same_v<T, TopOfBookReport>) {
-      std::osyncstream(std::cout) << std::format("{}", arg) << '\n';
-  } else {
+    if constexpr (std::is_same_v<T, DepthReady>) {
+      // pushed before its marker
+      DepthReport depth;
+      if (depthQueue_.pop(depth)) {
+        print(depth);
+      }
+    } else if constexpr (std::is_same_v<T, std::monostate>) {
       std::osyncstream(std::cout) << "Unknown report type\n";
+    } else {
+      print(arg);
     }
   }, std::move(item));
 }
 
+template <class Report>
+void ReportSink::print(const Report& report) const {
+  if constexpr (std::is_same_v<Report, OrderCanceledReport>) {
+    std::osyncstream(std::cout) << std::format("{}", report) << '\n';
+  } else {
+    // on the sink's thread, off the matching path
+    const auto& spec = symbols_.priceSpec(report.symbol_);
+    std::osyncstream(std::cout) << std::format("{}", ReportText<Report>{report, spec}) << '\n';
+  }
+}
+
 } // namespace Exchange
\ No newline at end of file
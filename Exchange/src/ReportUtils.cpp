@@ -1,13 +0,0 @@
-#include "ReportUtils.h"
-
-namespace Exchange {
-
-  
-  TopOfBookReport::TopOfBookReport(Symbol symbol, const Order& bid, const Order& ask) 
-  : symbol_(symbol),
-    bid_order_(bid.clientOrderId(), bid.price(), bid.openQuantity()),
-    ask_order_(ask.clientOrderId(), ask.price(), ask.openQuantity()) {}
-
-
-
-} // namespace Exchange
\ No newline at end of file
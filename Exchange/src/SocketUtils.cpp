@@ -31,9 +31,8 @@ namespace SocketUtils {
     dest.sin_port = htons(port); // target port
     inet_pton(AF_INET, "127.0.0.1", &dest.sin_addr); // target IP
 
-    const char* msg = message.c_str();
-
-    ssize_t sent = sendto(sockfd, msg, strlen(msg), 0,
+    // binary payloads have NULs in them, send all of it
+    ssize_t sent = sendto(sockfd, message.data(), message.size(), 0,
                           reinterpret_cast<sockaddr*>(&dest), sizeof(dest));
     if (sent < 0) {
         std::cerr << "sendto failed" << std::endl;
@@ -0,0 +1,49 @@
+#include "SymbolRegistry.h"
+
+namespace Exchange {
+
+SymbolRegistry::SymbolRegistry(std::initializer_list<std::string_view> symbols) {
+  for (auto symbol : symbols) {
+    add(Symbol{symbol});
+  }
+}
+
+SymbolRegistry::SymbolRegistry(std::initializer_list<SymbolSpec> symbols) {
+  for (const auto& spec : symbols) {
+    add(Symbol{spec.symbol_}, spec.priceSpec_, spec.referencePrice_);
+  }
+}
+
+SymbolRegistry::SymbolRegistry(std::span<const Symbol> symbols) {
+  for (auto symbol : symbols) {
+    add(symbol);
+  }
+}
+
+const SymbolRegistry& SymbolRegistry::global() {
+  // hard-coded, there is no symbol config to load yet; code that needs another list builds its own registry
+  static const SymbolRegistry registry {"AAPL", "GOOGL", "MSFT", "AMZN", "META", "NVDA"};
+  return registry;
+}
+
+void SymbolRegistry::add(Symbol symbol, PriceSpec priceSpec, Price referencePrice) {
+  if (ids_.try_emplace(symbol, static_cast<SymbolId>(symbols_.size() + 1)).second) {
+    symbols_.push_back(symbol);
+    priceSpecs_.push_back(priceSpec);
+    referencePrices_.push_back(referencePrice);
+  }
+}
+
+SymbolId SymbolRegistry::find(Symbol symbol) const {
+  auto it = ids_.find(symbol);
+  return it == ids_.end() ? INVALID_SYMBOL_ID : it->second;
+}
+
+Symbol SymbolRegistry::symbol(SymbolId id) const {
+  if (id == INVALID_SYMBOL_ID || id > symbols_.size()) {
+    return INVALID_SYMBOL;
+  }
+  return symbols_[id - 1];
+}
+
+} // namespace Exchange
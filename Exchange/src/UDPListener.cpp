@@ -9,6 +9,10 @@
 #include <netinet/in.h>
 #include <arpa/inet.h>
 #include <atomic>
+#include <algorithm>
+#include <span>
+#include <iterator>
+#include <utility>
 
 #include "SocketUtils.h"
 #include "EventParser.h"
@@ -31,7 +35,20 @@ UdpSubscriptionHandle::~UdpSubscriptionHandle() {
   }
 }
 
-UDPListener::UDPListener(int port) : socketFd_(-1), port_(port) {
+UDPListener::UDPListener(int port, std::size_t maxDatagramSize, std::size_t receiveBatch)
+  : socketFd_(-1), port_(port), maxDatagramSize_(maxDatagramSize), receiveBatch_(std::max<std::size_t>(receiveBatch, 1)),
+    buffer_(receiveBatch_ * maxDatagramSize_), messages_(receiveBatch_) {
+#ifdef __linux__
+    iovecs_.resize(receiveBatch_);
+    headers_.resize(receiveBatch_);
+    for (std::size_t i = 0; i < receiveBatch_; ++i) {
+      iovecs_[i].iov_base = buffer_.data() + i * maxDatagramSize_;
+      iovecs_[i].iov_len = maxDatagramSize_;
+      headers_[i] = {};
+      headers_[i].msg_hdr.msg_iov = &iovecs_[i];
+      headers_[i].msg_hdr.msg_iovlen = 1;
+    }
+#endif
     bindToPort(port_);
     startListening();
 }
@@ -41,18 +58,74 @@ UDPListener::~UDPListener() {
     if (socketFd_ >= 0) {
         close(socketFd_);
     }
+    delete subscribers_.load();
 }
 
-std::unique_ptr<SubscriptionHandle> UDPListener::subscribe(MessageCallback callback) {
-  std::lock_guard<std::mutex> lock(cbMutex_);
+std::unique_ptr<SubscriptionHandle> UDPListener::subscribeBatch(BatchCallback callback) {
   auto handle = getNextHandle();
-  callbacks_[handle] = callback;
+  Retired retired;
+  {
+    std::lock_guard<std::mutex> lock(cbMutex_);
+    const auto* current = subscribers_.load(std::memory_order_relaxed);
+    auto next = current ? std::make_unique<Subscribers>(*current) : std::make_unique<Subscribers>();
+    next->emplace_back(handle, std::move(callback));
+    retired = publish(std::move(next));
+  }
+  reclaim(std::move(retired));
   return std::make_unique<UdpSubscriptionHandle>(this, handle);
 }
 
 bool UDPListener::unsubscribe(int handle) {
-  std::lock_guard<std::mutex> lock(cbMutex_);
-  return callbacks_.erase(handle) > 0;
+  Retired retired;
+  {
+    std::lock_guard<std::mutex> lock(cbMutex_);
+    const auto* current = subscribers_.load(std::memory_order_relaxed);
+    if (!current) {
+      return false;
+    }
+    auto next = std::make_unique<Subscribers>();
+    next->reserve(current->size());
+    std::ranges::copy_if(*current, std::back_inserter(*next), [handle](const auto& subscriber) { return subscriber.first != handle; });
+    if (next->size() == current->size()) {
+      return false;
+    }
+    retired = publish(std::move(next));
+  }
+  reclaim(std::move(retired));
+  return true;
+}
+
+UDPListener::Retired UDPListener::publish(std::unique_ptr<const Subscribers> next) {
+  retired_.emplace_back(subscribers_.exchange(next.release(), std::memory_order_seq_cst));
+  if (std::this_thread::get_id() == listenerThread_.get_id()) {
+    // we're inside a callback, the dispatch that called us is still walking what we replaced.
+    // it stays in retired_ for the next writer from another thread (or the destructor)
+    return {};
+  }
+  // whatever a callback retired before this is unreachable as well now
+  return std::exchange(retired_, {});
+}
+
+void UDPListener::reclaim(Retired retired) const {
+  if (!retired.empty()) {
+    waitForDispatch();
+  }
+}
+
+void UDPListener::waitForDispatch() const {
+  // pairs with the seq_cst increment + load in dispatch(): either that dispatch sees the new snapshot,
+  // or we see it's running and wait for it to end
+  const auto epoch = dispatchEpoch_.load(std::memory_order_seq_cst);
+  if (epoch % 2 == 0) {
+    return;
+  }
+  while (dispatchEpoch_.load(std::memory_order_acquire) == epoch) {
+    std::this_thread::yield();
+  }
+}
+
+UDPListener::ReceiveStats UDPListener::stats() const {
+  return ReceiveStats{datagrams_.load(std::memory_order_relaxed), receiveCalls_.load(std::memory_order_relaxed)};
 }
 
 void UDPListener::bindToPort(int port) {
@@ -82,8 +155,14 @@ void UDPListener::bindToPort(int port) {
       socketFd_ = -1;
       throw std::runtime_error("Failed to bind to port " + std::to_string(port) + ": " + std::string(strerror(errno)));
   }
+
+  // the port we actually got, matters when asked for 0
+  socklen_t addrLen = sizeof(serverAddr);
+  if (getsockname(socketFd_, (struct sockaddr*)&serverAddr, &addrLen) == 0) {
+      port_ = ntohs(serverAddr.sin_port);
+  }
   
-  std::cout << "UDP Listener initialized on port " << port << std::endl;
+  std::cout << "UDP Listener initialized on port " << port_ << std::endl;
   std::cout << "Socket FD: " << socketFd_ << std::endl;
 
 }
@@ -103,43 +182,60 @@ void UDPListener::stopListening() {
 }
 
 void UDPListener::listenLoop() {
-    char buffer[4096];
-    struct sockaddr_in clientAddr;
-    socklen_t clientAddrLen = sizeof(clientAddr);
     std::cout << "Started listening for UDP messages..." << std::endl;
     while (true) {
-        // Clear client address structure
-        memset(&clientAddr, 0, sizeof(clientAddr));
-        
-        // Receive message (blocking)
-        ssize_t bytesReceived = recvfrom(socketFd_, buffer, sizeof(buffer) - 1, 0,
-                                        (struct sockaddr*)&clientAddr, &clientAddrLen);
-        
-        if (bytesReceived > 0) {
-            // Null-terminate the received data
-            buffer[bytesReceived] = '\0';
-            
-            std::cout << "DEBUG: Received " << bytesReceived << " bytes" << std::endl;
-            std::string message{buffer};
-
-            // TODO: yes, it's not great calling user-supplied code under our lock. 
-            // either copy/snapshot or do atomic<Umap*> and swap on update
-            {
-              std::lock_guard<std::mutex> lock(cbMutex_);
-              for (const auto& [_, callback] : callbacks_) {
-                  callback(message);
-              } 
-            }
-
-            if (toEventType(std::string(buffer)) == EventType::Quit) {
-              break;
-            }
-
-        } else if (bytesReceived < 0) {
-            // Error occurred
-            std::cerr << "Error receiving UDP message: " << strerror(errno) << std::endl;
+        const auto received = receive();
+        if (received == 0) {
+            continue;
+        }
+        datagrams_.fetch_add(received, std::memory_order_relaxed);
+        receiveCalls_.fetch_add(1, std::memory_order_relaxed);
+
+        dispatch(received);
+
+        // only a datagram that is nothing but a quit stops us, a quit inside a burst is the subscribers' business
+        const auto batch = MessageBatch(messages_).first(received);
+        if (std::ranges::any_of(batch, [](std::string_view message) { return toEventType(message) == EventType::Quit; })) {
+            break;
+        }
+    }
+}
+
+std::size_t UDPListener::receive() {
+#ifdef __linux__
+    if (receiveBatch_ > 1) {
+        // MSG_WAITFORONE: block for the first datagram, then take whatever else is already queued
+        const int received = recvmmsg(socketFd_, headers_.data(), static_cast<unsigned int>(receiveBatch_), MSG_WAITFORONE, nullptr);
+        if (received < 0) {
+            std::cerr << "Error receiving UDP messages: " << strerror(errno) << std::endl;
+            return 0;
+        }
+        for (int i = 0; i < received; ++i) {
+            messages_[i] = std::string_view(static_cast<const char*>(iovecs_[i].iov_base), headers_[i].msg_len);
+        }
+        return static_cast<std::size_t>(received);
+    }
+#endif
+    // Receive message (blocking)
+    ssize_t bytesReceived = recvfrom(socketFd_, buffer_.data(), maxDatagramSize_, 0, nullptr, nullptr);
+    if (bytesReceived < 0) {
+        std::cerr << "Error receiving UDP message: " << strerror(errno) << std::endl;
+        return 0;
+    }
+    messages_[0] = std::string_view(buffer_.data(), static_cast<std::size_t>(bytesReceived));
+    return 1;
+}
+
+void UDPListener::dispatch(std::size_t received) {
+    const auto batch = MessageBatch(messages_).first(received);
+
+    dispatchEpoch_.fetch_add(1, std::memory_order_seq_cst);
+    if (const auto* subscribers = subscribers_.load(std::memory_order_seq_cst)) {
+        for (const auto& [_, callback] : *subscribers) {
+            callback(batch);
         }
     }
+    dispatchEpoch_.fetch_add(1, std::memory_order_release);
 }
 
-} // namespace Exchange
\ No newline at end of file
+} // namespace Exchange
@@ -0,0 +1,46 @@
+#include "UserRegistry.h"
+
+#include <mutex>
+
+namespace Exchange {
+
+UserRegistry& UserRegistry::global() {
+  static UserRegistry registry;
+  return registry;
+}
+
+UserId UserRegistry::intern(std::string_view name) {
+  const UserName key {name};
+  {
+    std::shared_lock lock(mutex_);
+    if (auto it = ids_.find(key); it != ids_.end()) {
+      return it->second;
+    }
+  }
+
+  std::unique_lock lock(mutex_);
+  if (names_.size() >= maxUsers_) {
+    auto it = ids_.find(key);    // someone else may have put it in meanwhile
+    return it != ids_.end() ? it->second : INVALID_USER_ID;
+  }
+  auto [it, inserted] = ids_.try_emplace(key, static_cast<UserId>(names_.size() + 1));
+  if (inserted) {
+    names_.push_back(key);
+  }
+  return it->second;
+}
+
+UserName UserRegistry::name(UserId id) const {
+  std::shared_lock lock(mutex_);
+  if (id == INVALID_USER_ID || id > names_.size()) {
+    return INVALID_USER_NAME;
+  }
+  return names_[id - 1];
+}
+
+std::size_t UserRegistry::size() const {
+  std::shared_lock lock(mutex_);
+  return names_.size();
+}
+
+} // namespace Exchange
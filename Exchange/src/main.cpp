@@ -21,8 +21,14 @@ void signalHandler(int signum) {
 }
 
 void printUsage(const char* programName) {
-    std::cout << "Usage: " << programName << " <port>" << std::endl;
+    std::cout << "Usage: " << programName << " <port> [max datagram size] [wire format] [receive batch]" << std::endl;
     std::cout << "  port: UDP port to listen on (e.g., 8080)" << std::endl;
+    std::cout << "  max datagram size: bytes, a datagram can carry several newline separated messages (1-"
+              << Exchange::UDPListener::MAX_DATAGRAM_SIZE << ", default "
+              << Exchange::UDPListener::DEFAULT_MAX_DATAGRAM_SIZE << ")" << std::endl;
+    std::cout << "  wire format: csv (default), binary (see BinaryProtocol.h) or fix" << std::endl;
+    std::cout << "  receive batch: datagrams read per syscall at most (1-" << Exchange::UDPListener::MAX_RECEIVE_BATCH
+              << ", default " << Exchange::UDPListener::DEFAULT_RECEIVE_BATCH << ", 1 turns batching off)" << std::endl;
 }
 
 int parsePort(const char* portStr) {
@@ -37,14 +43,40 @@ int parsePort(const char* portStr) {
     }
 }
 
+// the receive buffers are sized off these up front, so anything outside [1, max] is refused rather than allocated
+std::size_t parseSize(const char* sizeStr, std::size_t max, const char* what) {
+    try {
+        std::size_t pos {0};
+        const auto size = std::stoull(sizeStr, &pos);
+        if (sizeStr[pos] != '\0' || sizeStr[0] == '-' || size == 0 || size > max) {
+            throw std::out_of_range("Size out of range");
+        }
+        return static_cast<std::size_t>(size);
+    } catch (const std::exception& e) {
+        throw std::runtime_error("Invalid " + std::string(what) + ": " + std::string(sizeStr));
+    }
+}
+
 int main(int argc, char* argv[]) {
-    if (argc != 2) {
+    if (argc < 2 || argc > 5) {
         printUsage(argv[0]);
         return 1;
     }
     
+    std::size_t maxDatagramSize = Exchange::UDPListener::DEFAULT_MAX_DATAGRAM_SIZE;
+    auto wireFormat = Exchange::WireFormat::Csv;
+    std::size_t receiveBatch = Exchange::UDPListener::DEFAULT_RECEIVE_BATCH;
     try {
         port = parsePort(argv[1]);
+        if (argc >= 3) {
+            maxDatagramSize = parseSize(argv[2], Exchange::UDPListener::MAX_DATAGRAM_SIZE, "max datagram size");
+        }
+        if (argc >= 4) {
+            wireFormat = Exchange::toWireFormat(argv[3]);
+        }
+        if (argc == 5) {
+            receiveBatch = parseSize(argv[4], Exchange::UDPListener::MAX_RECEIVE_BATCH, "receive batch");
+        }
     } catch (const std::exception& e) {
         std::cerr << "Error: " << e.what() << std::endl;
         printUsage(argv[0]);
@@ -56,26 +88,45 @@ int main(int argc, char* argv[]) {
     signal(SIGTERM, signalHandler);
     
     {
-      Exchange::CsvEventParser eventParser;
-      Exchange::UDPListener listener(port);
+      Exchange::UDPListener listener(port, maxDatagramSize, receiveBatch);
+
+      // the parser, the books and their sinks all go by the same symbol list
+      const auto& symbols = Exchange::SymbolRegistry::global();
 
       // TODO: this whole creation needs to be fixed, should be using one report sink per book to reduce contention
-      Exchange::ReportSink reportSink;
-      Exchange::OrderBookManager::OrderBookMap orderBookMap;
-      for (std::string_view symbol : {"AAPL", "GOOGL", "MSFT", "AMZN", "META", "NVDA"}) {
-        auto sink = std::make_unique<Exchange::ReportSink>();
-        orderBookMap.emplace(symbol, std::make_unique<Exchange::OrderBook<Exchange::ReportSink>>(Exchange::Symbol{symbol}, std::move(sink)));
+      Exchange::ReportSink reportSink {symbols};
+      // books held by value in the shards, no virtual calls on the matching path
+      using OrderBookManager = Exchange::BasicOrderBookManager<Exchange::OrderBook<Exchange::ReportSink>>;
+      OrderBookManager::OrderBookMap orderBookMap;
+      for (auto symbol : symbols.symbols()) {
+        auto sink = std::make_unique<Exchange::ReportSink>(symbols);
+        orderBookMap.emplace(symbol, Exchange::OrderBook<Exchange::ReportSink>(symbol, std::move(sink)));
       }
       // const auto numThreads = std  ::max(static_cast<int>(std::thread::hardware_concurrency() / 2), 2);
       const auto numThreads = 3;
       
-      Exchange::OrderBookManager orderBookManager {std::move(orderBookMap), numThreads};
-      Exchange::Exchange  exchange(listener, eventParser, orderBookManager);
+      OrderBookManager orderBookManager {std::move(orderBookMap), numThreads, symbols};
+      Exchange::Exchange  exchange(listener, wireFormat, orderBookManager);
     
       std::cout << "UDP Exchange Server running on port " << port << std::endl;
       std::cout << "Press Ctrl+C to stop..." << std::endl;
 
       exchange.start();
+
+      if (const auto rejected = exchange.rejects().total(); rejected > 0) {
+        std::cout << "Rejected " << rejected << " message(s):";
+        for (std::size_t i = 0; i < Exchange::PARSE_ERROR_COUNT; ++i) {
+          const auto error = static_cast<Exchange::ParseError>(i);
+          if (const auto count = exchange.rejects().count(error)) {
+            std::cout << ' ' << Exchange::toString(error) << '=' << count;
+          }
+        }
+        std::cout << std::endl;
+      }
+
+      const auto stats = listener.stats();
+      std::cout << "Received " << stats.datagrams_ << " datagram(s) in " << stats.receiveCalls_ << " receive call(s), "
+                << stats.datagramsPerCall() << " per call" << std::endl;
     }
     
     std::cout << "Shutting down..." << std::endl;
@@ -0,0 +1,23 @@
+#ifndef MOCK_REPORT_SINK_H
+#define MOCK_REPORT_SINK_H
+
+#include <gmock/gmock.h>
+#include "ReportUtils.h"
+
+namespace Exchange {
+namespace test {
+
+// Mock ReportSink for testing using older Google Mock syntax
+class MockReportSink {
+public:
+    MOCK_METHOD1(submitFills, bool(ExecutionReportView fills));
+    MOCK_METHOD1(submitAcceptedOrder, bool(OrderAcceptedReport&& report));
+    MOCK_METHOD1(submitCanceledOrder, bool(OrderCanceledReport&& report));
+    MOCK_METHOD1(submitTopOfBook, bool(TopOfBookReport&& report));
+    MOCK_METHOD1(submitDepth, bool(DepthReport&& report));
+};
+
+} // namespace test
+} // namespace Exchange
+
+#endif // MOCK_REPORT_SINK_H
@@ -0,0 +1,173 @@
+#include <gtest/gtest.h>
+#include "EventParser.h"
+
+#include <array>
+#include <cstring>
+#include <functional>
+
+namespace Exchange {
+namespace test {
+
+class BinaryProtocolTest : public ::testing::Test {
+  protected:
+    std::string_view encodeOne(auto&& append) {
+        encoder.clear();
+        EXPECT_TRUE(append(encoder));
+        return encoder.data();
+    }
+
+    UserRegistry users;
+    SymbolRegistry symbols {{"AAPL"}, {"MSFT"}, {"EURUSD", PriceSpec{100000, 1}}};
+    FastCsvEventParser csv {users, symbols};
+    BinaryEventParser parser {users, symbols};
+
+    std::array<char, 512> buffer {};
+    Binary::Encoder encoder {buffer};
+};
+
+TEST_F(BinaryProtocolTest, SameEventsAsCsv) {
+    using E = Binary::Encoder;
+    const std::pair<std::function<bool(E&)>, std::string_view> cases[] = {
+        {[](E& e) { return e.newOrder("user123", 1001, "AAPL", 100, Side::Buy, Type::Market); }, "D,user123,1001,AAPL,100,BUY,MARKET"},
+        {[](E& e) { return e.newOrder("user123", 1002, "AAPL", 100, Side::Sell, Type::Limit, Price{15075}); }, "D,user123,1002,AAPL,100,SELL,LIMIT,150.75"},
+        {[](E& e) { return e.newOrder("user456", 1004, "EURUSD", 100000, Side::Buy, Type::Limit, Price{108345}); }, "D,user456,1004,EURUSD,100000,BUY,LIMIT,1.08345"},
+        {[](E& e) { return e.newOrder("user789", 1005, "GOOGL", 10, Side::Buy, Type::Market); }, "D,user789,1005,GOOGL,10,BUY,MARKET"},
+        {[](E& e) { return e.cancelOrder("user123", 2002, "MSFT", 18446744073709551615ull); }, "F,user123,2002,MSFT,18446744073709551615"},
+        {[](E& e) { return e.topOfBook("user123", 3001, "AAPL"); }, "V,user123,3001,AAPL"},
+        {[](E& e) { return e.depth("user123", 4001, "AAPL"); }, "W,user123,4001,AAPL"},
+        {[](E& e) { return e.depth("user123", 4002, "AAPL", 3); }, "W,user123,4002,AAPL,3"},
+        {[](E& e) { return e.topOfBook("exactly16charsxx", 3002, "EURUSD"); }, "V,exactly16charsxx,3002,EURUSD"},
+    };
+    for (const auto& [encode, line] : cases) {
+        SCOPED_TRACE(line);
+        const auto message = encodeOne(encode);
+        EXPECT_EQ(parser.getEventType(message), csv.getEventType(line));
+        EXPECT_EQ(parser.parse(message), csv.parse(line));
+    }
+}
+
+TEST_F(BinaryProtocolTest, NewUser_RegistryFull_TooManyUsers) {
+    UserRegistry full {1};
+    const BinaryEventParser parser {full, symbols};
+
+    EXPECT_TRUE(parser.tryParse(encodeOne([](auto& e) { return e.topOfBook("user123", 3001, "AAPL"); })).has_value());
+    EXPECT_EQ(parser.tryParse(encodeOne([](auto& e) { return e.topOfBook("user456", 3002, "AAPL"); })).error(),
+              ParseError::TooManyUsers);
+    EXPECT_EQ(full.size(), 1u);
+}
+
+TEST_F(BinaryProtocolTest, WireLayoutIsLittleEndianFixedOffsets) {
+    const auto message = encodeOne([](auto& e) { return e.newOrder("ab", 0x01020304, "AAPL", 7, Side::Sell, Type::Limit, Price{0x1122}); });
+    ASSERT_EQ(message.size(), 48u);
+
+    const auto byte = [&](std::size_t i) { return static_cast<uint8_t>(message[i]); };
+    EXPECT_EQ(byte(0), 48);        // length
+    EXPECT_EQ(byte(1), 0);
+    EXPECT_EQ(byte(2), 1);         // NewOrder
+    EXPECT_EQ(byte(3), Binary::PROTOCOL_VERSION);
+    EXPECT_EQ(byte(4), 0x04);      // clientOrderId
+    EXPECT_EQ(byte(7), 0x01);
+    EXPECT_EQ(message.substr(8, 3), std::string_view("ab\0", 3));
+    EXPECT_EQ(message.substr(24, 4), "AAPL");
+    EXPECT_EQ(byte(32), 0x22);     // price
+    EXPECT_EQ(byte(33), 0x11);
+    EXPECT_EQ(byte(40), 7);        // quantity
+    EXPECT_EQ(byte(44), 2);        // Sell
+    EXPECT_EQ(byte(45), 2);        // Limit
+}
+
+TEST_F(BinaryProtocolTest, Encoder_FullBufferAndBadFields) {
+    std::array<char, 70> small {};
+    Binary::Encoder encoder {small};
+    EXPECT_TRUE(encoder.topOfBook("u", 1, "AAPL"));
+    EXPECT_FALSE(encoder.newOrder("u", 2, "AAPL", 1, Side::Buy, Type::Market));
+    EXPECT_EQ(encoder.size(), sizeof(Binary::TopOfBookMessage));
+    EXPECT_TRUE(encoder.topOfBook("u", 3, "AAPL"));
+    EXPECT_EQ(encoder.size(), 2 * sizeof(Binary::TopOfBookMessage));
+
+    encoder.clear();
+    EXPECT_THROW(encoder.topOfBook("a_user_name_that_is_too_long", 1, "AAPL"), std::invalid_argument);
+    EXPECT_THROW(encoder.topOfBook("u", 1, "TOOLONGSYM"), std::invalid_argument);
+    EXPECT_THROW(encoder.newOrder("u", 1, "AAPL", 1, Side::Invalid, Type::Market), std::invalid_argument);
+    EXPECT_EQ(encoder.size(), 0u);
+}
+
+TEST_F(BinaryProtocolTest, Rejects) {
+    const auto good = std::string(encodeOne([](auto& e) { return e.newOrder("u", 1, "AAPL", 1, Side::Buy, Type::Limit, Price{100}); }));
+
+    EXPECT_THROW(parser.parse(""), std::runtime_error);
+    EXPECT_THROW(parser.parse(good.substr(0, 3)), std::runtime_error);
+    EXPECT_THROW(parser.parse(good.substr(0, 40)), std::runtime_error);
+    EXPECT_THROW(parser.parse(good + '\0'), std::runtime_error);
+    EXPECT_THROW(parser.parse("D,user123,1001,AAPL,100,BUY,MARKET"), std::runtime_error);
+
+    auto corrupt = [&](std::size_t offset, uint8_t value) {
+        auto message = good;
+        message[offset] = static_cast<char>(value);
+        return message;
+    };
+    EXPECT_THROW(parser.parse(corrupt(0, 40)), std::runtime_error);    // length doesn't match the type
+    EXPECT_THROW(parser.parse(corrupt(2, 9)), std::runtime_error);     // unknown type
+    EXPECT_THROW(parser.parse(corrupt(3, 2)), std::runtime_error);     // version
+    EXPECT_THROW(parser.parse(corrupt(44, 3)), std::runtime_error);    // side
+    EXPECT_THROW(parser.parse(corrupt(45, 0)), std::runtime_error);    // type
+    EXPECT_EQ(parser.getEventType(corrupt(2, 9)), EventType::Invalid);
+
+    EXPECT_EQ(parser.tryParse(good.substr(0, 3)).error(), ParseError::InvalidLength);
+    EXPECT_EQ(parser.tryParse(corrupt(0, 40)).error(), ParseError::InvalidLength);
+    EXPECT_EQ(parser.tryParse(corrupt(2, 9)).error(), ParseError::UnknownEventType);
+    EXPECT_EQ(parser.tryParse(corrupt(3, 2)).error(), ParseError::UnsupportedVersion);
+    EXPECT_EQ(parser.tryParse(corrupt(44, 3)).error(), ParseError::InvalidSide);
+    EXPECT_EQ(parser.tryParse(corrupt(45, 0)).error(), ParseError::InvalidType);
+}
+
+TEST_F(BinaryProtocolTest, TextQuitStillStops) {
+    EXPECT_EQ(parser.getEventType("QUIT"), EventType::Quit);
+    EXPECT_EQ(parser.parse("QUIT"), Event{std::in_place_type<QuitEvent>});
+}
+
+TEST_F(BinaryProtocolTest, ParseBatch_MessagesBackToBack) {
+    encoder.newOrder("u", 1, "AAPL", 10, Side::Buy, Type::Limit, Price{100});
+    encoder.topOfBook("u", 2, "MSFT");
+    encoder.cancelOrder("u", 3, "AAPL", 77);
+    auto payload = std::string(encoder.data());
+    // a bad message with an intact header is skipped on its own
+    payload[sizeof(Binary::NewOrderMessage) + 3] = 9;
+
+    std::array<Event, 8> out;
+    auto result = parser.parseBatch(payload, out);
+    EXPECT_EQ(result.events_, 2u);
+    EXPECT_EQ(result.rejected_, 1u);
+    EXPECT_EQ(result.consumed_, payload.size());
+    EXPECT_EQ(std::get<NewOrderEvent>(out[0].data_).clientOrderId(), 1);
+    EXPECT_EQ(std::get<CancelOrderEvent>(out[1].data_).origOrderId(), 77u);
+
+    // out full, the rest is left for the next call
+    std::array<Event, 1> one;
+    result = parser.parseBatch(payload, one);
+    EXPECT_EQ(result.events_, 1u);
+    EXPECT_EQ(result.consumed_, sizeof(Binary::NewOrderMessage));
+
+    // a length running past the datagram loses the framing, the rest is dropped
+    payload.resize(payload.size() - 1);
+    result = parser.parseBatch(payload, out);
+    EXPECT_EQ(result.events_, 1u);
+    EXPECT_EQ(result.rejected_, 2u);
+    EXPECT_EQ(result.consumed_, payload.size());
+
+    result = parser.parseBatch("QUIT", out);
+    EXPECT_EQ(result.events_, 1u);
+    EXPECT_TRUE(std::holds_alternative<QuitEvent>(out[0].data_));
+}
+
+TEST_F(BinaryProtocolTest, MakeEventParser_ByWireFormat) {
+    EXPECT_EQ(toWireFormat("csv"), WireFormat::Csv);
+    EXPECT_EQ(toWireFormat("BINARY"), WireFormat::Binary);
+    EXPECT_THROW(toWireFormat("xml"), std::invalid_argument);
+
+    EXPECT_NE(dynamic_cast<FastCsvEventParser*>(makeEventParser(WireFormat::Csv, users, symbols).get()), nullptr);
+    EXPECT_NE(dynamic_cast<BinaryEventParser*>(makeEventParser(WireFormat::Binary, users, symbols).get()), nullptr);
+}
+
+} // namespace test
+} // namespace Exchange
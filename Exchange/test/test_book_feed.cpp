@@ -0,0 +1,32 @@
+#include <gtest/gtest.h>
+#include <vector>
+#include "BookFeed.h"
+
+namespace Exchange {
+namespace test {
+
+TEST(BookFeedTest, Poll_HandsOverDeltasInOrder) {
+    BookFeed feed(8);
+    for (uint64_t seq = 1; seq <= 3; ++seq) {
+      EXPECT_TRUE(feed.submitDelta(BookDelta{.sequenceNumber_ = seq, .orderId_ = seq}));
+    }
+
+    std::vector<uint64_t> seen;
+    EXPECT_EQ(feed.poll([&seen](const BookDelta& delta) { seen.push_back(delta.sequenceNumber_); }), 3);
+    EXPECT_EQ(seen, (std::vector<uint64_t>{1, 2, 3}));
+    EXPECT_EQ(feed.poll([](const BookDelta&) {}), 0);
+}
+
+TEST(BookFeedTest, SlowConsumer_DropsAreCounted) {
+    BookFeed feed(2);
+    EXPECT_TRUE(feed.submitDelta(BookDelta{.sequenceNumber_ = 1}));
+    EXPECT_TRUE(feed.submitDelta(BookDelta{.sequenceNumber_ = 2}));
+    EXPECT_FALSE(feed.submitDelta(BookDelta{.sequenceNumber_ = 3}));
+    EXPECT_EQ(feed.dropped(), 1);
+
+    feed.poll([](const BookDelta&) {});
+    EXPECT_TRUE(feed.submitDelta(BookDelta{.sequenceNumber_ = 4}));
+}
+
+} // namespace test
+} // namespace Exchange
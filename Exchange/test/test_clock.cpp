@@ -0,0 +1,53 @@
+#include <gtest/gtest.h>
+#include "Clock.h"
+#include "Event.h"
+
+#include <thread>
+
+namespace Exchange {
+namespace test {
+
+TEST(ClockTest, TscClock_TracksSteadyClock) {
+    const auto before = std::chrono::steady_clock::now();
+    const auto now = TscClock::now();
+    const auto after = std::chrono::steady_clock::now();
+
+    // calibration error only, well under a millisecond over a run this short
+    EXPECT_GE(now, before - std::chrono::milliseconds(1));
+    EXPECT_LE(now, after + std::chrono::milliseconds(1));
+}
+
+TEST(ClockTest, TscClock_DoesNotGoBackwards) {
+    auto last = TscClock::now();
+    for (int i = 0; i < 10000; ++i) {
+        const auto now = TscClock::now();
+        EXPECT_GE(now, last);
+        last = now;
+    }
+}
+
+TEST(ClockTest, CoarseClock_OnlyMovesOnUpdate) {
+    CoarseClock clock;
+    const auto t0 = Timestamp{} + std::chrono::seconds(5);
+    clock.update(t0);
+    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    EXPECT_EQ(clock.now(), t0);
+
+    clock.update();
+    EXPECT_GT(clock.now(), t0);
+
+    const CoarseClock copy {clock};
+    EXPECT_EQ(copy.now(), clock.now());
+}
+
+TEST(ClockTest, Event_TimestampIsSetExplicitly) {
+    Event event {std::in_place_type<NewOrderEvent>, INVALID_USER_ID, 1, "AAPL"_sym, 10, Side::Buy, Type::Market};
+    EXPECT_EQ(std::get<NewOrderEvent>(event.data_).timestamp(), Timestamp{});
+
+    const auto now = Clock::now();
+    event.setTimestamp(now);
+    EXPECT_EQ(std::get<NewOrderEvent>(event.data_).timestamp(), now);
+}
+
+} // namespace test
+} // namespace Exchange
@@ -0,0 +1,147 @@
+#include <gtest/gtest.h>
+#include "DelimiterScan.h"
+#include "EventParser.h"
+
+#include <random>
+#include <string>
+#include <vector>
+
+namespace Exchange {
+namespace test {
+
+namespace {
+  std::vector<std::size_t> delimitersOf(std::string_view buffer) {
+    std::vector<std::size_t> positions;
+    for (std::size_t i = 0; i < buffer.size(); ++i) {
+      if (buffer[i] == ',' || buffer[i] == '\n') {
+        positions.push_back(i);
+      }
+    }
+    return positions;
+  }
+
+  std::vector<std::size_t> scan(std::string_view buffer, SimdLevel level) {
+    std::vector<std::size_t> positions;
+    DelimiterScanner scanner {buffer, level};
+    for (auto position = scanner.next(); position != buffer.size(); position = scanner.next()) {
+      positions.push_back(position);
+    }
+    return positions;
+  }
+
+  constexpr SimdLevel ALL_LEVELS[] = {SimdLevel::Scalar, SimdLevel::Sse42, SimdLevel::Avx2};
+}
+
+TEST(DelimiterScanTest, KernelsAgreeWithScalar) {
+    std::mt19937 rng {42};
+    std::uniform_int_distribution<int> pick {0, 5};
+    const char alphabet[] = {',', '\n', 'a', '0', '\0', '"'};
+
+    for (int round = 0; round < 100; ++round) {
+        char block[DELIMITER_BLOCK_SIZE];
+        for (auto& c : block) {
+            c = alphabet[pick(rng)];
+        }
+        const auto expected = delimiterMaskFn(SimdLevel::Scalar)(block);
+        for (auto level : ALL_LEVELS) {
+            if (!isSupported(level)) {
+                continue;
+            }
+            SCOPED_TRACE(toString(level));
+            EXPECT_EQ(delimiterMaskFn(level)(block), expected);
+        }
+    }
+}
+
+TEST(DelimiterScanTest, Scanner_FindsEveryDelimiter_AcrossBlocksAndTail) {
+    std::string buffer;
+    for (int i = 0; i < 50; ++i) {
+        buffer += "D,user" + std::to_string(i) + ",1001,AAPL,100,BUY,LIMIT,150.25\n";
+    }
+    buffer += "V,user1,7,AAPL";   // no trailing newline
+
+    for (auto level : ALL_LEVELS) {
+        SCOPED_TRACE(toString(level));
+        EXPECT_EQ(scan(buffer, level), delimitersOf(buffer));
+        for (std::size_t size : {0, 1, 63, 64, 65, 127, 128, 129}) {
+            EXPECT_EQ(scan(std::string_view(buffer).substr(0, size), level), delimitersOf(std::string_view(buffer).substr(0, size)));
+        }
+    }
+}
+
+TEST(DelimiterScanTest, Scanner_SplitsLines) {
+    const std::string buffer = "D,a,1\n\nV,b\nQ";
+    DelimiterScanner scanner {buffer};
+    SplitLine line;
+
+    ASSERT_TRUE(scanner.nextLine(line));
+    EXPECT_EQ(line.line_, "D,a,1");
+    ASSERT_EQ(line.size(), 3u);
+    EXPECT_EQ(line.field(0), "D");
+    EXPECT_EQ(line.field(1), "a");
+    EXPECT_EQ(line.field(2), "1");
+
+    ASSERT_TRUE(scanner.nextLine(line));
+    EXPECT_EQ(line.line_, "");
+    EXPECT_EQ(line.size(), 1u);
+
+    ASSERT_TRUE(scanner.nextLine(line));
+    EXPECT_EQ(line.line_, "V,b");
+    EXPECT_EQ(line.field(1), "b");
+
+    ASSERT_TRUE(scanner.nextLine(line));
+    EXPECT_EQ(line.line_, "Q");
+    EXPECT_FALSE(scanner.nextLine(line));
+}
+
+TEST(DelimiterScanTest, Scanner_TooManyFields_EndUpInTheLast) {
+    std::string buffer = "a";
+    for (std::size_t i = 1; i < SplitLine::MAX_FIELDS + 3; ++i) {
+        buffer += ",f";
+    }
+    DelimiterScanner scanner {buffer};
+    SplitLine line;
+
+    ASSERT_TRUE(scanner.nextLine(line));
+    ASSERT_EQ(line.size(), SplitLine::MAX_FIELDS);
+    EXPECT_EQ(line.field(0), "a");
+    EXPECT_EQ(line.field(SplitLine::MAX_FIELDS - 1), "f,f,f,f");
+}
+
+TEST(DelimiterScanTest, ParseBuffer_SameEventsAsLineByLine) {
+    UserRegistry users;
+    FastCsvEventParser parser {users};
+    const std::vector<std::string> lines {
+        "D,user123,1001,AAPL,100,BUY,LIMIT,150.75",
+        "D , user456 , 1002 , MSFT , 5 , sell , market\r",
+        "F,user123,2001,AAPL,42",
+        "",
+        "D,user123,1003,AAPL,100,HOLD,MARKET",   // rejected
+        "V,user123,3001,AAPL",
+        "W,user123,4001,NVDA,3",
+        "Q",
+    };
+    std::string buffer;
+    for (const auto& line : lines) {
+        buffer += line + '\n';
+    }
+
+    for (auto level : ALL_LEVELS) {
+        SCOPED_TRACE(toString(level));
+        std::vector<Event> events;
+        const auto result = parser.parseBuffer(buffer, [&](Event&& event) { events.push_back(std::move(event)); }, level);
+
+        EXPECT_EQ(result.events_, 6u);
+        EXPECT_EQ(result.rejected_, 1u);
+        ASSERT_EQ(events.size(), 6u);
+        EXPECT_EQ(events[0], parser.parse(lines[0]));
+        EXPECT_EQ(events[1], parser.parse(lines[1]));
+        EXPECT_EQ(events[2], parser.parse(lines[2]));
+        EXPECT_EQ(events[3], parser.parse(lines[5]));
+        EXPECT_EQ(events[4], parser.parse(lines[6]));
+        EXPECT_EQ(events[5], parser.parse(lines[7]));
+    }
+}
+
+} // namespace test
+} // namespace Exchange
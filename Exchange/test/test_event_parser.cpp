@@ -7,10 +7,11 @@ namespace Exchange {
 
 class EventParserTest : public ::testing::Test {
   protected:
+    UserRegistry users;
     std::unique_ptr<Exchange::CsvEventParser> parser;
 protected:
     void SetUp() override {
-        parser = std::make_unique<CsvEventParser>();
+        parser = std::make_unique<CsvEventParser>(users);
     }
 
     void TearDown() override {
@@ -28,7 +29,7 @@ TEST_F(EventParserTest, ParseNewOrder_ValidMarketOrder) {
     EXPECT_EQ(event.symbol(), "AAPL"_sym);
 
     EXPECT_EQ(newOrderEvent.eventType(), EventType::NewOrder);
-    EXPECT_EQ(newOrderEvent.userId_, UserId("user123"));
+    EXPECT_EQ(users.name(newOrderEvent.userId_), UserName("user123"));
     EXPECT_EQ(newOrderEvent.clientOrderId_, 1001);
     EXPECT_EQ(newOrderEvent.symbol_, "AAPL"_sym);
     EXPECT_EQ(newOrderEvent.quantity_, 100);
@@ -37,6 +38,37 @@ TEST_F(EventParserTest, ParseNewOrder_ValidMarketOrder) {
     EXPECT_EQ(newOrderEvent.price_, INVALID_PRICE);
 }
 
+TEST_F(EventParserTest, Parse_ResolvesSymbolId) {
+    SymbolRegistry symbols {"MSFT", "AAPL"};
+    CsvEventParser symbolParser {users, symbols};
+
+    auto event = symbolParser.parse("D,user123,1001,AAPL,100,BUY,MARKET");
+    EXPECT_EQ(event.symbolId(), symbols.find("AAPL"_sym));
+    EXPECT_EQ(std::get<NewOrderEvent>(event.data_).symbolId_, 2u);
+
+    auto cancel = symbolParser.parse("F,user123,1002,MSFT,7");
+    EXPECT_EQ(cancel.symbolId(), 1u);
+
+    // parses fine, the book manager is the one that rejects it
+    auto unknown = symbolParser.parse("V,user123,1003,GOOGL");
+    EXPECT_EQ(unknown.symbol(), "GOOGL"_sym);
+    EXPECT_EQ(unknown.symbolId(), INVALID_SYMBOL_ID);
+}
+
+TEST_F(EventParserTest, ParseNewOrder_PriceInTheSymbolsSpec) {
+    SymbolRegistry symbols {{"AAPL"}, {"EURUSD", PriceSpec{100000, 1}}};
+    CsvEventParser symbolParser {users, symbols};
+
+    auto fx = symbolParser.parse("D,user123,1001,EURUSD,100000,BUY,LIMIT,1.08345");
+    EXPECT_EQ(std::get<NewOrderEvent>(fx.data_).price_, Price{108345});
+
+    auto equity = symbolParser.parse("D,user123,1002,AAPL,100,BUY,LIMIT,150.25");
+    EXPECT_EQ(std::get<NewOrderEvent>(equity.data_).price_, Price{15025});
+
+    // more decimals than AAPL is quoted in
+    EXPECT_ANY_THROW(symbolParser.parse("D,user123,1003,AAPL,100,BUY,LIMIT,1.08345"));
+}
+
 
 TEST_F(EventParserTest, ParseNewOrder_ValidLimitOrder) {
     std::string csv = "D,user456,1002,MSFT,50,SELL,LIMIT,150.75";
@@ -47,7 +79,7 @@ TEST_F(EventParserTest, ParseNewOrder_ValidLimitOrder) {
     EXPECT_EQ(event.symbol(), "MSFT"_sym);
 
     EXPECT_EQ(newOrderEvent.eventType(), EventType::NewOrder);
-    EXPECT_EQ(newOrderEvent.userId_, UserId("user456"));
+    EXPECT_EQ(users.name(newOrderEvent.userId_), UserName("user456"));
     EXPECT_EQ(newOrderEvent.clientOrderId_, 1002);
     EXPECT_EQ(newOrderEvent.symbol_, "MSFT"_sym);
     EXPECT_EQ(newOrderEvent.quantity_, 50);
@@ -66,7 +98,7 @@ TEST_F(EventParserTest, ParseNewOrder_WithWhitespace) {
     
     EXPECT_EQ(newOrderEvent.eventType(), EventType::NewOrder);
     
-    EXPECT_EQ(newOrderEvent.userId_, UserId("user789"));
+    EXPECT_EQ(users.name(newOrderEvent.userId_), UserName("user789"));
     EXPECT_EQ(newOrderEvent.clientOrderId_, 1003);
     EXPECT_EQ(newOrderEvent.symbol_, "GOOGL"_sym);
     EXPECT_EQ(newOrderEvent.quantity_, 200);
@@ -85,7 +117,7 @@ TEST_F(EventParserTest, ParseNewOrder_CaseInsensitive) {
     NewOrderEvent newOrderEvent = std::get<NewOrderEvent>(event.data_);
     
     EXPECT_EQ(newOrderEvent.eventType(), EventType::NewOrder);
-    EXPECT_EQ(newOrderEvent.userId_, UserId("user101"));
+    EXPECT_EQ(users.name(newOrderEvent.userId_), UserName("user101"));
     EXPECT_EQ(newOrderEvent.clientOrderId_, 1004);
     EXPECT_EQ(newOrderEvent.symbol_, "TSLA"_sym);
     EXPECT_EQ(newOrderEvent.quantity_, 75);
@@ -104,7 +136,7 @@ TEST_F(EventParserTest, ParseNewOrder_ShortForm) {
     EXPECT_EQ(event.symbol(), "NFLX"_sym);
 
     EXPECT_EQ(newOrderEvent.eventType(), EventType::NewOrder);
-    EXPECT_EQ(newOrderEvent.userId_, UserId("user202"));
+    EXPECT_EQ(users.name(newOrderEvent.userId_), UserName("user202"));
     EXPECT_EQ(newOrderEvent.clientOrderId_, 1005);
     EXPECT_EQ(newOrderEvent.symbol_, "NFLX"_sym);
     EXPECT_EQ(newOrderEvent.quantity_, 25);
@@ -137,6 +169,15 @@ TEST_F(EventParserTest, ParseNewOrder_TooFewTokens) {
     EXPECT_THROW(parser->parse(csv), std::runtime_error);
 }
 
+TEST_F(EventParserTest, Parse_RejectsDontInternUsers) {
+    const auto before = users.size();
+    EXPECT_ANY_THROW(parser->parse("D,junk1,1001,AAPL,100,HOLD,MARKET"));
+    EXPECT_ANY_THROW(parser->parse("F,junk2,1002,AAPL,abc"));
+    EXPECT_ANY_THROW(parser->parse("V,junk3,abc,AAPL"));
+    EXPECT_ANY_THROW(parser->parse("W,junk4,1004,AAPL,0"));
+    EXPECT_EQ(users.size(), before);
+}
+
 TEST_F(EventParserTest, ParseNewOrder_WhitespaceOnly) {
     std::string csv = "   ";
     
@@ -204,7 +245,7 @@ TEST_F(EventParserTest, ParseCancelOrder_Valid) {
     CancelOrderEvent cancelOrderEvent = std::get<CancelOrderEvent>(event.data_);
     
     EXPECT_EQ(cancelOrderEvent.eventType(), EventType::CancelOrder);
-    EXPECT_EQ(cancelOrderEvent.userId_, UserId("user123"));
+    EXPECT_EQ(users.name(cancelOrderEvent.userId_), UserName("user123"));
     EXPECT_EQ(cancelOrderEvent.origOrderId_, 2001);
     EXPECT_EQ(cancelOrderEvent.symbol_, "AAPL"_sym);
 }
@@ -218,7 +259,7 @@ TEST_F(EventParserTest, ParseCancelOrder_WithWhitespace) {
     CancelOrderEvent cancelOrderEvent = std::get<CancelOrderEvent>(event.data_);
     
     EXPECT_EQ(cancelOrderEvent.eventType(), EventType::CancelOrder);
-    EXPECT_EQ(cancelOrderEvent.userId_, UserId("user456"));
+    EXPECT_EQ(users.name(cancelOrderEvent.userId_), UserName("user456"));
     EXPECT_EQ(cancelOrderEvent.origOrderId_, 2002);
     EXPECT_EQ(cancelOrderEvent.symbol_, "MSFT"_sym);
 }
@@ -246,7 +287,7 @@ TEST_F(EventParserTest, ParseTopOfBook_Valid) {
     TopOfBookEvent topOfBookEvent = std::get<TopOfBookEvent>(event.data_);
     
     EXPECT_EQ(topOfBookEvent.eventType(), EventType::TopOfBook);
-    EXPECT_EQ(topOfBookEvent.userId_, UserId("user123"));
+    EXPECT_EQ(users.name(topOfBookEvent.userId_), UserName("user123"));
     EXPECT_EQ(topOfBookEvent.symbol_, "AAPL"_sym);
 }
 
@@ -259,7 +300,7 @@ TEST_F(EventParserTest, ParseTopOfBook_WithWhitespace) {
     TopOfBookEvent topOfBookEvent = std::get<TopOfBookEvent>(event.data_);
     
     EXPECT_EQ(topOfBookEvent.eventType(), EventType::TopOfBook);
-    EXPECT_EQ(topOfBookEvent.userId_, UserId("user456"));
+    EXPECT_EQ(users.name(topOfBookEvent.userId_), UserName("user456"));
     EXPECT_EQ(topOfBookEvent.symbol_, "MSFT"_sym);
 }
 
@@ -271,6 +312,25 @@ TEST_F(EventParserTest, ParseTopOfBook_TooFewTokens) {
     EXPECT_THROW(parser->parse(csv), std::runtime_error);
 }
 
+TEST_F(EventParserTest, ParseDepth_Valid) {
+    auto event = parser->parse("W,user123,1001,AAPL,3");
+    EXPECT_EQ(event.symbol(), "AAPL"_sym);
+
+    DepthEvent depthEvent = std::get<DepthEvent>(event.data_);
+    EXPECT_EQ(depthEvent.eventType(), EventType::Depth);
+    EXPECT_EQ(users.name(depthEvent.userId_), UserName("user123"));
+    EXPECT_EQ(depthEvent.levels(), 3u);
+
+    // levels are optional
+    EXPECT_EQ(std::get<DepthEvent>(parser->parse(" W , user123 , 1001 , AAPL ").data_).levels(), MAX_DEPTH_LEVELS);
+}
+
+TEST_F(EventParserTest, ParseDepth_InvalidLevels) {
+    EXPECT_THROW(parser->parse("W,user123,1001,AAPL,0"), std::runtime_error);
+    EXPECT_THROW(parser->parse("W,user123,1001,AAPL,abc"), std::invalid_argument);
+    EXPECT_THROW(parser->parse("W,user123,1001"), std::runtime_error);
+}
+
 TEST_F(EventParserTest, ParseQuit_Valid) {
     std::string csv = "Q";
     
@@ -307,10 +367,10 @@ TEST_F(EventParserTest, GetEventType_AllCases) {
 TEST_F(EventParserTest, CreateNewOrderEvent_VariousRanges) {
    std::list<std::string> tokens = {"D", "user456", "1002", "MSFT", "50", "SELL", "LIMIT", "150.75"};
     
-    auto verify = [](const auto& event) {
+    auto verify = [this](const auto& event) {
       EXPECT_EQ(event.symbol(), "MSFT"_sym);
       NewOrderEvent newOrderEvent = std::get<NewOrderEvent>(event.data_);
-      EXPECT_EQ(newOrderEvent.userId_, UserId("user456"));  
+      EXPECT_EQ(users.name(newOrderEvent.userId_), UserName("user456"));  
       EXPECT_EQ(newOrderEvent.clientOrderId_, 1002);
       EXPECT_EQ(newOrderEvent.symbol_, "MSFT"_sym);
       EXPECT_EQ(newOrderEvent.quantity_, 50);
@@ -340,10 +400,10 @@ TEST_F(EventParserTest, CreateNewOrderEvent_VariousRanges) {
 TEST_F(EventParserTest, CreateCancelOrderEvent_VariousRanges) {
   std::list<std::string> tokens {"F", "user123", "1001", "AAPL", "2001"};
 
-    auto verify = [](const auto& event) {
+    auto verify = [this](const auto& event) {
       EXPECT_EQ(event.symbol(), "AAPL"_sym);
       CancelOrderEvent cancelOrderEvent = std::get<CancelOrderEvent>(event.data_);
-      EXPECT_EQ(cancelOrderEvent.userId_, UserId("user123"));
+      EXPECT_EQ(users.name(cancelOrderEvent.userId_), UserName("user123"));
       EXPECT_EQ(cancelOrderEvent.clientOrderId_, 1001);
       EXPECT_EQ(cancelOrderEvent.symbol_, "AAPL"_sym);
       EXPECT_EQ(cancelOrderEvent.origOrderId_, 2001);
@@ -371,10 +431,10 @@ TEST_F(EventParserTest, CreateCancelOrderEvent_VariousRanges) {
 TEST_F(EventParserTest, CreateTopOfBookEvent_VariousRanges) {
   std::list<std::string> tokens {"V", "user456", "1002", "MSFT"};
 
-  auto verify = [](const auto& event) {
+  auto verify = [this](const auto& event) {
     EXPECT_EQ(event.symbol(), "MSFT"_sym);
     TopOfBookEvent topOfBookEvent = std::get<TopOfBookEvent>(event.data_);
-    EXPECT_EQ(topOfBookEvent.userId_, UserId("user456"));
+    EXPECT_EQ(users.name(topOfBookEvent.userId_), UserName("user456"));
     EXPECT_EQ(topOfBookEvent.clientOrderId_, 1002);
     EXPECT_EQ(topOfBookEvent.symbol_, "MSFT"_sym );
   };
@@ -1,5 +1,6 @@
 #include <gtest/gtest.h>
 #include "Event.h"
+#include "UserRegistry.h"
 
 namespace Exchange {
 namespace test {
@@ -54,6 +55,17 @@ TEST_F(EventTest, TopOfBookEvent_Construction) {
     EXPECT_EQ(event.symbol_, "AAPL"_sym);
 }
 
+TEST_F(EventTest, DepthEvent_Construction) {
+    DepthEvent event("user123"_uid, 1001, "AAPL"_sym, 5);
+
+    EXPECT_EQ(event.eventType(), EventType::Depth);
+    EXPECT_EQ(event.symbol_, "AAPL"_sym);
+    EXPECT_EQ(event.levels(), 5u);
+
+    EXPECT_EQ(DepthEvent("user123"_uid, 1001, "AAPL"_sym).levels(), MAX_DEPTH_LEVELS);
+    EXPECT_EQ(DepthEvent("user123"_uid, 1001, "AAPL"_sym, 500).levels(), MAX_DEPTH_LEVELS);
+}
+
 
 TEST_F(EventTest, QuitEvent_Construction) {
     QuitEvent  event;
@@ -72,6 +84,9 @@ TEST_F(EventTest, ToEventType_ValidTypes) {
     EXPECT_EQ(toEventType("V"), EventType::TopOfBook);
     EXPECT_EQ(toEventType("v"), EventType::TopOfBook);
     EXPECT_EQ(toEventType("  V  "), EventType::TopOfBook);
+
+    EXPECT_EQ(toEventType("W"), EventType::Depth);
+    EXPECT_EQ(toEventType("w"), EventType::Depth);
     
     EXPECT_EQ(toEventType("Q"), EventType::Quit);
     EXPECT_EQ(toEventType("q"), EventType::Quit);
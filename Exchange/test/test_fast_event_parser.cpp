@@ -0,0 +1,189 @@
+#include <gtest/gtest.h>
+#include "EventParser.h"
+
+namespace Exchange {
+namespace test {
+
+class FastCsvEventParserTest : public ::testing::Test {
+  protected:
+    UserRegistry users;
+    SymbolRegistry symbols {{"AAPL"}, {"MSFT"}, {"EURUSD", PriceSpec{100000, 1}}};
+    CsvEventParser reference {users, symbols};
+    FastCsvEventParser parser {users, symbols};
+};
+
+TEST_F(FastCsvEventParserTest, SameEventsAsCsvEventParser) {
+    for (std::string_view line : {
+            "D,user123,1001,AAPL,100,BUY,MARKET",
+            "D,user123,1002,AAPL,100,SELL,LIMIT,150.75",
+            "d, user456 , 1003 , MSFT , 50 , buy , limit , 250.5 ",
+            "D,user456,1004,EURUSD,100000,2,2,1.08345",
+            "D,user789,1005,GOOGL,10,1,1",
+            "D,\"user789\",1006,\"AAPL\",10,BUY,LIMIT,\"99.99\"",
+            "D,user123,1007,AAPL,100,BUY,MARKET,ignored,extra",
+            "F,user123,2001,AAPL,42",
+            "F , user123 , 2002 , MSFT , 18446744073709551615",
+            "V,user123,3001,AAPL",
+            "v,user123,3002,GOOGL",
+            "W,user123,4001,AAPL",
+            "W,user123,4002,AAPL,3",
+            "W,user123,4003,AAPL,50",
+            "Q",
+            " quit ",
+        }) {
+        SCOPED_TRACE(line);
+        EXPECT_EQ(parser.getEventType(line), reference.getEventType(line));
+        EXPECT_EQ(parser.parse(line), reference.parse(line));
+    }
+}
+
+TEST_F(FastCsvEventParserTest, ResolvesSymbolIdAndPrice) {
+    auto event = parser.parse("D,user123,1001,EURUSD,100000,BUY,LIMIT,1.08345");
+    const auto& order = std::get<NewOrderEvent>(event.data_);
+
+    EXPECT_EQ(order.symbolId_, symbols.find("EURUSD"_sym));
+    EXPECT_EQ(order.price_, Price{108345});
+    EXPECT_EQ(users.name(order.userId_), UserName("user123"));
+
+    EXPECT_EQ(parser.parse("V,user123,3002,GOOGL").symbolId(), INVALID_SYMBOL_ID);
+}
+
+TEST_F(FastCsvEventParserTest, Rejects) {
+    for (std::string_view line : {
+            "",
+            "X,user123,1001,AAPL",
+            "D",
+            "D,user123",
+            "D,user123,1001",
+            "D,user123,1001,AAPL",
+            "D,user123,1001,AAPL,100",
+            "D,user123,1001,AAPL,100,BUY",
+            "D,user123,1001,AAPL,100,BUY,LIMIT",
+            "D,user123,abc,AAPL,100,BUY,MARKET",
+            "D,user123,1001,AAPL,1x0,BUY,MARKET",
+            "D,user123,1001,AAPL,100,HOLD,MARKET",
+            "D,user123,1001,AAPL,100,BUY,STOP",
+            "D,user123,1001,AAPL,100,BUY,LIMIT,abc",
+            "D,user123,1001,AAPL,100,BUY,LIMIT,150.755",
+            "F,user123,2001,AAPL",
+            "F,user123,2001,AAPL,-1",
+            "W,user123,4001,AAPL,0",
+            "W,user123,4001,AAPL,-3",
+        }) {
+        SCOPED_TRACE(line);
+        EXPECT_ANY_THROW(parser.parse(line));
+    }
+}
+
+TEST_F(FastCsvEventParserTest, TryParse_ErrorCodes) {
+    const std::pair<std::string_view, ParseError> cases[] = {
+        {"", ParseError::UnknownEventType},
+        {"X,user123,1001,AAPL", ParseError::UnknownEventType},
+        {"D,user123,1001", ParseError::MissingField},
+        {"D,user123,1001,AAPL,100,BUY,LIMIT", ParseError::MissingField},
+        {"D,user123,abc,AAPL,100,BUY,MARKET", ParseError::InvalidNumber},
+        {"D,user123,1001,AAPL,100,HOLD,MARKET", ParseError::InvalidSide},
+        {"D,user123,1001,AAPL,100,BUY,STOP", ParseError::InvalidType},
+        {"D,user123,1001,AAPL,100,BUY,LIMIT,150.755", ParseError::InvalidPrice},
+        {"F,user123,2001,AAPL,-1", ParseError::InvalidNumber},
+        {"W,user123,4001,AAPL,0", ParseError::InvalidDepth},
+    };
+    for (const auto& [line, error] : cases) {
+        SCOPED_TRACE(line);
+        const auto result = parser.tryParse(line);
+        ASSERT_FALSE(result.has_value());
+        EXPECT_EQ(result.error(), error);
+    }
+
+    EXPECT_EQ(parser.tryParse("V,user123,3001,AAPL"), parser.parse("V,user123,3001,AAPL"));
+    // the old parser still throws, the default tryParse() wraps that
+    EXPECT_EQ(reference.tryParse("D,user123,abc,AAPL,100,BUY,MARKET").error(), ParseError::Malformed);
+}
+
+TEST_F(FastCsvEventParserTest, TryParse_RejectsDontInternUsers) {
+    const auto before = users.size();
+    EXPECT_FALSE(parser.tryParse("D,junk1,1001,AAPL,100,HOLD,MARKET").has_value());
+    EXPECT_FALSE(parser.tryParse("W,junk2,4001,AAPL,0").has_value());
+    EXPECT_EQ(users.size(), before);
+}
+
+TEST(FastCsvEventParserFullRegistryTest, TryParse_NewUser_TooManyUsers) {
+    UserRegistry users {1};
+    const SymbolRegistry symbols {{"AAPL"}, {"EURUSD", PriceSpec{100000, 1}}};
+    const FastCsvEventParser parser {users, symbols};
+    const CsvEventParser reference {users, symbols};
+
+    ASSERT_TRUE(parser.tryParse("D,user123,1001,AAPL,100,BUY,MARKET").has_value());
+    EXPECT_TRUE(parser.tryParse("V,user123,3001,AAPL").has_value());
+
+    EXPECT_EQ(parser.tryParse("D,user456,1002,AAPL,100,BUY,MARKET").error(), ParseError::TooManyUsers);
+    EXPECT_EQ(parser.tryParse("W,user456,4001,AAPL").error(), ParseError::TooManyUsers);
+    EXPECT_ANY_THROW(reference.parse("F,user456,2001,AAPL,42"));
+    EXPECT_EQ(users.size(), 1u);
+}
+
+TEST_F(FastCsvEventParserTest, ParseBatch_CountsRejectsByReason) {
+    const std::string payload =
+        "D,user123,1001,AAPL,100,HOLD,MARKET\n"
+        "V,user123,3001,AAPL\n"
+        "D,user123,1002,AAPL,100,SELL,MARKET\n"
+        "D,user123,1003,AAPL,100,BUY,STOP\n"
+        "D,user123,1004,AAPL,100,BUY,SIDEWAYS\n"
+        "garbage\n";
+
+    std::array<Event, 8> out;
+    const auto result = parser.parseBatch(payload, out);
+    EXPECT_EQ(result.events_, 2u);
+    EXPECT_EQ(result.rejected_, 4u);
+    EXPECT_EQ(result.errors_[static_cast<std::size_t>(ParseError::InvalidSide)], 1u);
+    EXPECT_EQ(result.errors_[static_cast<std::size_t>(ParseError::InvalidType)], 2u);
+    EXPECT_EQ(result.errors_[static_cast<std::size_t>(ParseError::UnknownEventType)], 1u);
+
+    RejectCounters counters;
+    counters.add(result);
+    counters.add(result);
+    EXPECT_EQ(counters.total(), 8u);
+    EXPECT_EQ(counters.count(ParseError::InvalidType), 4u);
+    EXPECT_EQ(counters.count(ParseError::BadCheckSum), 0u);
+}
+
+TEST_F(FastCsvEventParserTest, ParseBatch_OneDatagramManyMessages) {
+    const std::string payload =
+        "D,user123,1001,AAPL,100,BUY,LIMIT,150.75\n"
+        "\n"
+        "F,user123,2001,AAPL,42\r\n"
+        "D,user123,1002,AAPL,100,HOLD,MARKET\n"
+        "V,user123,3001,AAPL\n"
+        "W,user123,4001,MSFT,3";
+
+    for (const EventParser* p : {static_cast<const EventParser*>(&parser), static_cast<const EventParser*>(&reference)}) {
+        std::array<Event, 8> out;
+        const auto result = p->parseBatch(payload, out);
+
+        EXPECT_EQ(result.events_, 4u);
+        EXPECT_EQ(result.rejected_, 1u);
+        EXPECT_EQ(result.consumed_, payload.size());
+        EXPECT_EQ(out[0], parser.parse("D,user123,1001,AAPL,100,BUY,LIMIT,150.75"));
+        EXPECT_EQ(out[1], parser.parse("F,user123,2001,AAPL,42"));
+        EXPECT_EQ(out[2], parser.parse("V,user123,3001,AAPL"));
+        EXPECT_EQ(out[3], parser.parse("W,user123,4001,MSFT,3"));
+    }
+}
+
+TEST_F(FastCsvEventParserTest, ParseBatch_OutFull_PicksUpWhereItStopped) {
+    const std::string payload = "V,u,1,AAPL\nV,u,2,AAPL\nV,u,3,AAPL\n";
+
+    for (const EventParser* p : {static_cast<const EventParser*>(&parser), static_cast<const EventParser*>(&reference)}) {
+        std::array<Event, 2> out;
+        auto result = p->parseBatch(payload, out);
+        ASSERT_EQ(result.events_, 2u);
+        EXPECT_EQ(std::get<TopOfBookEvent>(out[1].data_).clientOrderId(), 2);
+
+        result = p->parseBatch(std::string_view(payload).substr(result.consumed_), out);
+        ASSERT_EQ(result.events_, 1u);
+        EXPECT_EQ(std::get<TopOfBookEvent>(out[0].data_).clientOrderId(), 3);
+    }
+}
+
+} // namespace test
+} // namespace Exchange
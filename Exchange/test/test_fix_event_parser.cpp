@@ -0,0 +1,155 @@
+#include <gtest/gtest.h>
+#include "EventParser.h"
+
+#include <array>
+
+namespace Exchange {
+namespace test {
+
+class FixEventParserTest : public ::testing::Test {
+  protected:
+    // '|' keeps the messages readable, SOH is tested on its own
+    std::string fix(std::string_view body, std::string_view beginString = "FIX.4.4") {
+        return FixEventParser::frame(body, beginString, '|');
+    }
+
+    UserRegistry users;
+    SymbolRegistry symbols {{"AAPL"}, {"MSFT"}, {"EURUSD", PriceSpec{100000, 1}}};
+    FastCsvEventParser csv {users, symbols};
+    FixEventParser parser {users, symbols, '|'};
+};
+
+TEST_F(FixEventParserTest, Frame_BodyLengthAndCheckSum) {
+    // the classic heartbeat example
+    EXPECT_EQ(FixEventParser::frame("35=0\x01", "FIX.4.2"), "8=FIX.4.2\x01" "9=5\x01" "35=0\x01" "10=161\x01");
+    EXPECT_EQ(FixEventParser::frame("35=0|", "FIX.4.2", '|'), "8=FIX.4.2|9=5|35=0|10=018|");
+}
+
+TEST_F(FixEventParserTest, SameEventsAsCsv) {
+    const std::pair<std::string, std::string_view> cases[] = {
+        {fix("35=D|49=user123|56=EXCH|34=1|11=1001|55=AAPL|54=1|38=100|40=1|"), "D,user123,1001,AAPL,100,BUY,MARKET"},
+        {fix("35=D|49=user123|11=1002|21=1|55=AAPL|54=2|38=100|40=2|44=150.75|59=0|"), "D,user123,1002,AAPL,100,SELL,LIMIT,150.75"},
+        {fix("35=D|49=user456|11=1004|55=EURUSD|54=1|38=100000|40=2|44=1.08345|", "FIX.4.2"), "D,user456,1004,EURUSD,100000,BUY,LIMIT,1.08345"},
+        {fix("35=D|49=user789|11=1005|55=GOOGL|54=1|38=10|40=1|"), "D,user789,1005,GOOGL,10,BUY,MARKET"},
+        {fix("35=F|49=user123|11=2002|41=1002|37=18446744073709551615|55=MSFT|54=1|"), "F,user123,2002,MSFT,18446744073709551615"},
+        {fix("35=V|49=user123|262=3001|263=0|264=1|146=1|55=AAPL|"), "V,user123,3001,AAPL"},
+        {fix("35=V|49=user123|262=3002|146=1|55=AAPL|"), "V,user123,3002,AAPL"},
+        {fix("35=V|49=user123|262=4001|264=0|55=AAPL|"), "W,user123,4001,AAPL"},
+        {fix("35=V|49=user123|262=4002|264=3|55=AAPL|"), "W,user123,4002,AAPL,3"},
+    };
+    for (const auto& [message, line] : cases) {
+        SCOPED_TRACE(message);
+        EXPECT_EQ(parser.getEventType(message), csv.getEventType(line) == EventType::Depth ? EventType::TopOfBook : csv.getEventType(line));
+        EXPECT_EQ(parser.parse(message), csv.parse(line));
+    }
+}
+
+TEST_F(FixEventParserTest, SohDelimited) {
+    FixEventParser soh {users, symbols};
+    const auto message = FixEventParser::frame("35=V\x01" "49=user123\x01" "262=7\x01" "55=MSFT\x01");
+    EXPECT_EQ(soh.parse(message), csv.parse("V,user123,7,MSFT"));
+    EXPECT_EQ(soh.parse(message).symbolId(), symbols.find("MSFT"_sym));
+}
+
+TEST_F(FixEventParserTest, Rejects) {
+    const auto good = fix("35=D|49=u|11=1|55=AAPL|54=1|38=100|40=2|44=1.5|");
+    ASSERT_NO_THROW(parser.parse(good));
+
+    auto withCheckSum = [](std::string message, std::string_view checkSum) {
+        return message.replace(message.size() - 4, 3, checkSum);
+    };
+    for (const auto& message : {
+            std::string{},
+            std::string{"8=FIX.4.4|"},
+            withCheckSum(good, "000"),
+            withCheckSum(good, "abc"),
+            good.substr(0, good.size() - 1),
+            fix("35=D|49=u|11=1|55=AAPL|54=1|38=100|40=2|44=1.5|", "FIX.5.0"),
+            std::string{"9=5|8=FIX.4.4|35=0|10=161|"},
+            fix("49=u|35=D|11=1|55=AAPL|54=1|38=100|40=1|"),   // 35 not third
+            fix("35=0|"),                                        // heartbeat, not ours
+            fix("35=D|49=u|11=1|55=AAPL|54=1|38=100|40=2|"),     // limit without a price
+            fix("35=D|11=1|55=AAPL|54=1|38=100|40=1|"),          // no sender
+            fix("35=D|49=u|11=x|55=AAPL|54=1|38=100|40=1|"),
+            fix("35=D|49=u|11=1|55=AAPL|54=3|38=100|40=1|"),
+            fix("35=D|49=u|11=1|55=AAPL|54=1|38=100|40=3|"),
+            fix("35=D|49=u|11=1|55=AAPL|54=1|38=100|40=1|55=MSFT|"),
+            fix("35=F|49=u|11=1|55=AAPL|41=7|"),                 // cancels go by the exchange's OrderID
+            fix("35=V|49=u|262=1|146=2|55=AAPL|55=MSFT|"),
+            fix("35=V|49=u|262=1|264=-1|55=AAPL|"),
+            fix("35=D|49=u|11=1|55=AAPL|54=1|38=100|40=1|x=1|"),
+            fix("35=D|49=u|11=1|55=AAPL|54=1|38=100|40=1|99|"),
+        }) {
+        SCOPED_TRACE(message);
+        EXPECT_THROW(parser.parse(message), std::exception);
+    }
+
+    const std::pair<std::string, ParseError> cases[] = {
+        {withCheckSum(good, "000"), ParseError::BadCheckSum},
+        {good.substr(0, good.size() - 1), ParseError::InvalidLength},
+        {fix("35=D|49=u|11=1|55=AAPL|54=1|38=100|40=2|44=1.5|", "FIX.5.0"), ParseError::UnsupportedVersion},
+        {fix("49=u|35=D|11=1|55=AAPL|54=1|38=100|40=1|"), ParseError::UnexpectedField},
+        {fix("35=0|"), ParseError::UnknownEventType},
+        {fix("35=D|49=u|11=1|55=AAPL|54=1|38=100|40=2|"), ParseError::MissingField},
+        {fix("35=D|49=u|11=x|55=AAPL|54=1|38=100|40=1|"), ParseError::InvalidNumber},
+        {fix("35=D|49=u|11=1|55=AAPL|54=1|38=100|40=2|44=1.555|"), ParseError::InvalidPrice},
+        {fix("35=D|49=u|11=1|55=AAPL|54=1|38=100|40=1|99|"), ParseError::Malformed},
+    };
+    for (const auto& [message, error] : cases) {
+        SCOPED_TRACE(message);
+        EXPECT_EQ(parser.tryParse(message).error(), error);
+    }
+
+    // the body length is checked against the message, not just used to frame it
+    auto shortBody = good;
+    shortBody.replace(shortBody.find("9=") + 2, 2, "40");
+    EXPECT_THROW(parser.parse(shortBody), std::runtime_error);
+}
+
+TEST_F(FixEventParserTest, NewUser_RegistryFull_TooManyUsers) {
+    UserRegistry full {1};
+    const FixEventParser parser {full, symbols, '|'};
+
+    EXPECT_TRUE(parser.tryParse(fix("35=V|49=user123|262=1|263=0|264=1|146=1|55=AAPL|")).has_value());
+    EXPECT_EQ(parser.tryParse(fix("35=F|49=user456|11=2|41=1|37=7|55=AAPL|")).error(), ParseError::TooManyUsers);
+    EXPECT_EQ(full.size(), 1u);
+}
+
+TEST_F(FixEventParserTest, TextQuitStillStops) {
+    EXPECT_EQ(parser.getEventType("QUIT"), EventType::Quit);
+    EXPECT_EQ(parser.parse("QUIT"), Event{std::in_place_type<QuitEvent>});
+}
+
+TEST_F(FixEventParserTest, ParseBatch_FramedByBodyLength) {
+    auto bad = fix("35=D|49=u|11=2|55=AAPL|54=1|38=100|40=1|");
+    bad.replace(bad.size() - 4, 3, "000");
+    const auto payload = fix("35=D|49=u|11=1|55=AAPL|54=1|38=100|40=1|") + "\n" + bad +
+                         fix("35=V|49=u|262=3|55=MSFT|") + "\r\n";
+
+    std::array<Event, 8> out;
+    auto result = parser.parseBatch(payload, out);
+    EXPECT_EQ(result.events_, 2u);
+    EXPECT_EQ(result.rejected_, 1u);
+    EXPECT_EQ(result.consumed_, payload.size());
+    EXPECT_EQ(std::get<NewOrderEvent>(out[0].data_).clientOrderId(), 1);
+    EXPECT_EQ(std::get<TopOfBookEvent>(out[1].data_).clientOrderId(), 3);
+
+    // out full, picks up at the next message
+    std::array<Event, 1> one;
+    result = parser.parseBatch(payload, one);
+    EXPECT_EQ(result.events_, 1u);
+    const auto rest = std::string_view(payload).substr(result.consumed_);
+    result = parser.parseBatch(rest, one);
+    EXPECT_EQ(result.events_, 1u);
+    EXPECT_EQ(result.rejected_, 1u);
+    EXPECT_EQ(std::get<TopOfBookEvent>(one[0].data_).clientOrderId(), 3);
+
+    // a BodyLength running past the datagram loses the framing, the rest is dropped
+    result = parser.parseBatch(std::string_view(payload).substr(0, 30), out);
+    EXPECT_EQ(result.events_, 0u);
+    EXPECT_EQ(result.rejected_, 1u);
+    EXPECT_EQ(result.consumed_, 30u);
+}
+
+} // namespace test
+} // namespace Exchange
@@ -0,0 +1,405 @@
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include "LadderOrderBook.h"
+#include "Event.h"
+#include "UserRegistry.h"
+#include "OrderUtils.h"
+#include "ReportUtils.h"
+#include "MockReportSink.h"
+
+namespace Exchange {
+namespace test {
+
+class LadderOrderBookTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+      auto mockReportSink = std::make_unique<MockReportSink>();
+      mockReportSink_ = mockReportSink.get();
+
+      // small band on purpose so the growth paths get exercised too
+      orderBook_ = std::make_unique<LadderOrderBook<MockReportSink>>(
+          Symbol{"AAPL"}, std::move(mockReportSink), toPrice(150.00, TWO_DIGITS_PRICE_SPEC), 64);
+    }
+
+    void TearDown() override {
+        mockReportSink_ = nullptr;
+        orderBook_.reset();
+    }
+
+    static NewOrderEvent limit(OrderId id, Side side, Quantity quantity, double price) {
+      return NewOrderEvent("user"_uid, id, "AAPL"_sym, quantity, side, Type::Limit, toPrice(price, TWO_DIGITS_PRICE_SPEC));
+    }
+
+    void expectFills() {
+      EXPECT_CALL(*mockReportSink_, submitFills(testing::_))
+          .WillOnce(testing::Invoke([this](ExecutionReportView fills) {
+              capturedFills_.assign(fills.begin(), fills.end());
+              return true;
+          }));
+    }
+
+    void expectCancel() {
+      EXPECT_CALL(*mockReportSink_, submitCanceledOrder(testing::_))
+          .WillOnce(testing::Invoke([this](OrderCanceledReport&& report) {
+              capturedCancel_ = std::move(report);
+              return true;
+          }));
+    }
+
+    TopOfBookReport topOfBook() {
+      TopOfBookReport captured;
+      EXPECT_CALL(*mockReportSink_, submitTopOfBook(testing::_))
+          .WillOnce(testing::Invoke([&captured](TopOfBookReport&& report) {
+              captured = std::move(report);
+              return true;
+          }));
+      orderBook_->submitTopOfBook(TopOfBookEvent("user"_uid, 1, "AAPL"_sym));
+      return captured;
+    }
+
+    MockReportSink* mockReportSink_ {nullptr};
+    std::unique_ptr<LadderOrderBook<MockReportSink>> orderBook_;
+    ExecutionReportCollection capturedFills_;
+    OrderCanceledReport capturedCancel_ {};
+};
+
+TEST_F(LadderOrderBookTest, SubmitTopOfBook_EmptyBook_ReturnsInvalidOrders) {
+    auto tob = topOfBook();
+
+    EXPECT_FALSE(tob.bid_.isValid());
+    EXPECT_FALSE(tob.ask_.isValid());
+}
+
+TEST_F(LadderOrderBookTest, SubmitNewOrder_RestingOrders_BestPricesOnTop) {
+    EXPECT_TRUE(orderBook_->submitNewOrder(limit(1, Side::Buy, 10, 149.90)));
+    EXPECT_TRUE(orderBook_->submitNewOrder(limit(2, Side::Buy, 20, 149.95)));
+    EXPECT_TRUE(orderBook_->submitNewOrder(limit(3, Side::Sell, 30, 150.10)));
+    EXPECT_TRUE(orderBook_->submitNewOrder(limit(4, Side::Sell, 40, 150.05)));
+
+    auto tob = topOfBook();
+
+    EXPECT_EQ(tob.bid_.orderCount_, 1u);
+    EXPECT_EQ(tob.bid_.quantity_, 20);
+    EXPECT_EQ(tob.bid_.price_, toPrice(149.95, TWO_DIGITS_PRICE_SPEC));
+    EXPECT_EQ(tob.ask_.orderCount_, 1u);
+    EXPECT_EQ(tob.ask_.quantity_, 40);
+    EXPECT_EQ(tob.ask_.price_, toPrice(150.05, TWO_DIGITS_PRICE_SPEC));
+}
+
+TEST_F(LadderOrderBookTest, SubmitNewOrder_SameClientOrderId_GetsItsOwnExchangeId) {
+    std::vector<OrderAcceptedReport> accepted;
+    EXPECT_CALL(*mockReportSink_, submitAcceptedOrder(testing::_))
+        .Times(2)
+        .WillRepeatedly(testing::Invoke([&accepted](OrderAcceptedReport&& report) {
+            accepted.push_back(report);
+            return true;
+        }));
+
+    // client ids are the client's business, we key on our own
+    EXPECT_TRUE(orderBook_->submitNewOrder(limit(1, Side::Buy, 10, 149.90)));
+    EXPECT_TRUE(orderBook_->submitNewOrder(limit(1, Side::Buy, 10, 149.80)));
+
+    ASSERT_EQ(accepted.size(), 2);
+    EXPECT_EQ(accepted[0].clientOrderId_, 1);
+    EXPECT_EQ(accepted[0].exchangeOrderId_, 1);
+    EXPECT_EQ(accepted[1].clientOrderId_, 1);
+    EXPECT_EQ(accepted[1].exchangeOrderId_, 2);
+
+    EXPECT_CALL(*mockReportSink_, submitCanceledOrder(testing::_)).WillOnce(testing::Return(true));
+    EXPECT_TRUE(orderBook_->submitCancelOrder(CancelOrderEvent("user"_uid, 2, "AAPL"_sym, 1)));
+
+    auto tob = topOfBook();
+    EXPECT_EQ(tob.bid_.price_, toPrice(149.80, TWO_DIGITS_PRICE_SPEC));
+}
+
+TEST_F(LadderOrderBookTest, SubmitNewOrder_SweepsLevels_PriceTimePriority) {
+    orderBook_->submitNewOrder(limit(1, Side::Sell, 50, 150.00));
+    orderBook_->submitNewOrder(limit(2, Side::Sell, 30, 150.00));
+    orderBook_->submitNewOrder(limit(3, Side::Sell, 40, 149.50));
+    orderBook_->submitNewOrder(limit(4, Side::Sell, 20, 149.00));
+
+    expectFills();
+    orderBook_->submitNewOrder(limit(5, Side::Buy, 100, 151.00));
+
+    ASSERT_EQ(capturedFills_.size(), 6);
+    EXPECT_EQ(capturedFills_[0].orderId_, 4);
+    EXPECT_EQ(capturedFills_[0].filledQuantity_, 20);
+    EXPECT_EQ(capturedFills_[0].price_, toPrice(149.00, TWO_DIGITS_PRICE_SPEC));
+    EXPECT_EQ(capturedFills_[1].orderId_, 5);
+    EXPECT_EQ(capturedFills_[1].otherOrderId_, 4);
+    EXPECT_EQ(capturedFills_[2].orderId_, 3);
+    EXPECT_EQ(capturedFills_[2].filledQuantity_, 40);
+    EXPECT_EQ(capturedFills_[4].orderId_, 1);     // first in at 150.00
+    EXPECT_EQ(capturedFills_[4].filledQuantity_, 40);
+
+    // order 1 keeps its place at the front of the level with what's left, order 2 behind it
+    auto tob = topOfBook();
+    EXPECT_EQ(tob.ask_.orderCount_, 2u);
+    EXPECT_EQ(tob.ask_.quantity_, 40);
+    EXPECT_FALSE(tob.bid_.isValid());
+}
+
+TEST_F(LadderOrderBookTest, SubmitNewOrder_PartialFill_RemainingGoesToBook) {
+    orderBook_->submitNewOrder(limit(1, Side::Sell, 100, 150.00));
+    orderBook_->submitNewOrder(limit(2, Side::Sell, 200, 152.00));
+
+    expectFills();
+    orderBook_->submitNewOrder(limit(3, Side::Buy, 150, 151.00));
+
+    ASSERT_EQ(capturedFills_.size(), 2);
+    EXPECT_EQ(capturedFills_[1].filledQuantity_, 100);
+
+    auto tob = topOfBook();
+    EXPECT_EQ(tob.bid_.orderCount_, 1u);
+    EXPECT_EQ(tob.bid_.quantity_, 50);
+    EXPECT_EQ(tob.ask_.orderCount_, 1u);
+}
+
+TEST_F(LadderOrderBookTest, SubmitNewOrder_LargeOrder_FillsEntireBookAndKillsRest) {
+    for (int i = 0; i < 5; ++i) {
+      orderBook_->submitNewOrder(limit(100 + i, Side::Sell, 10, 150.00 + i * 0.01));
+    }
+
+    OrderCanceledReport capturedCancel;
+    expectFills();
+    EXPECT_CALL(*mockReportSink_, submitCanceledOrder(testing::_))
+        .WillOnce(testing::Invoke([&capturedCancel](OrderCanceledReport&& report) {
+            capturedCancel = std::move(report);
+            return true;
+        }));
+
+    orderBook_->submitNewOrder(limit(200, Side::Buy, 100, 155.00));
+
+    ASSERT_EQ(capturedFills_.size(), 10);
+    for (int i = 0; i < 5; ++i) {
+      EXPECT_EQ(capturedFills_[i * 2].orderId_, 100 + i);
+    }
+    EXPECT_EQ(capturedCancel.orderId_, 200);
+    EXPECT_EQ(capturedCancel.remainingQuantity_, 50);
+    EXPECT_EQ(capturedCancel.reason_, CancelReason::Fill_And_Kill);
+
+    auto tob = topOfBook();
+    EXPECT_FALSE(tob.ask_.isValid());
+    EXPECT_FALSE(tob.bid_.isValid());
+}
+
+TEST_F(LadderOrderBookTest, SubmitNewOrder_MarketOrder_NoLiquidity_Cancelled) {
+    OrderCanceledReport capturedCancel;
+    EXPECT_CALL(*mockReportSink_, submitCanceledOrder(testing::_))
+        .WillOnce(testing::Invoke([&capturedCancel](OrderCanceledReport&& report) {
+            capturedCancel = std::move(report);
+            return true;
+        }));
+
+    orderBook_->submitNewOrder(NewOrderEvent("user"_uid, 1, "AAPL"_sym, 100, Side::Buy, Type::Market, MARKET_PRICE));
+
+    EXPECT_EQ(capturedCancel.orderId_, 1);
+    EXPECT_EQ(capturedCancel.remainingQuantity_, 100);
+    EXPECT_EQ(capturedCancel.reason_, CancelReason::Fill_And_Kill);
+}
+
+TEST_F(LadderOrderBookTest, SubmitCancelOrder_MiddleOfLevel_KeepsFifo) {
+    orderBook_->submitNewOrder(limit(1, Side::Buy, 10, 149.00));
+    orderBook_->submitNewOrder(limit(2, Side::Buy, 20, 149.00));
+    orderBook_->submitNewOrder(limit(3, Side::Buy, 30, 149.00));
+
+    OrderCanceledReport capturedCancel;
+    EXPECT_CALL(*mockReportSink_, submitCanceledOrder(testing::_))
+        .WillOnce(testing::Invoke([&capturedCancel](OrderCanceledReport&& report) {
+            capturedCancel = std::move(report);
+            return true;
+        }));
+    // exchange ids are handed out in the order the book accepts them, so client order 2 is exchange order 2 here
+    EXPECT_TRUE(orderBook_->submitCancelOrder(CancelOrderEvent("user"_uid, 4, "AAPL"_sym, 2)));
+    EXPECT_FALSE(orderBook_->submitCancelOrder(CancelOrderEvent("user"_uid, 5, "AAPL"_sym, 2)));
+
+    EXPECT_EQ(capturedCancel.orderId_, 2);
+    EXPECT_EQ(capturedCancel.remainingQuantity_, 20);
+    EXPECT_EQ(capturedCancel.reason_, CancelReason::User_Canceled);
+
+    expectFills();
+    orderBook_->submitNewOrder(limit(6, Side::Sell, 40, 149.00));
+
+    ASSERT_EQ(capturedFills_.size(), 4);
+    EXPECT_EQ(capturedFills_[0].orderId_, 1);
+    EXPECT_EQ(capturedFills_[2].orderId_, 3);
+}
+
+TEST_F(LadderOrderBookTest, SubmitCancelOrder_BestLevelEmptied_NextLevelBecomesBest) {
+    orderBook_->submitNewOrder(limit(1, Side::Sell, 10, 150.50));
+    orderBook_->submitNewOrder(limit(2, Side::Sell, 20, 150.10));
+
+    EXPECT_CALL(*mockReportSink_, submitCanceledOrder(testing::_)).WillOnce(testing::Return(true));
+    EXPECT_TRUE(orderBook_->submitCancelOrder(CancelOrderEvent("user"_uid, 3, "AAPL"_sym, 2)));
+
+    auto tob = topOfBook();
+    EXPECT_EQ(tob.ask_.orderCount_, 1u);
+    EXPECT_EQ(tob.ask_.price_, toPrice(150.50, TWO_DIGITS_PRICE_SPEC));
+}
+
+TEST_F(LadderOrderBookTest, SubmitNewOrder_OutOfBandPrices_GrowLadder) {
+    // band is 64 ticks around 150.00, these are all well outside of it
+    EXPECT_TRUE(orderBook_->submitNewOrder(limit(1, Side::Buy, 10, 120.00)));
+    EXPECT_TRUE(orderBook_->submitNewOrder(limit(2, Side::Sell, 10, 190.00)));
+    EXPECT_TRUE(orderBook_->submitNewOrder(limit(3, Side::Buy, 10, 0.50)));
+
+    auto tob = topOfBook();
+    EXPECT_EQ(tob.bid_.orderCount_, 1u);
+    EXPECT_EQ(tob.bid_.price_, toPrice(120.00, TWO_DIGITS_PRICE_SPEC));
+    EXPECT_EQ(tob.ask_.orderCount_, 1u);
+    EXPECT_EQ(tob.ask_.price_, toPrice(190.00, TWO_DIGITS_PRICE_SPEC));
+
+    expectFills();
+    orderBook_->submitNewOrder(limit(4, Side::Sell, 15, 0.50));
+    ASSERT_EQ(capturedFills_.size(), 4);
+    EXPECT_EQ(capturedFills_[0].orderId_, 1);
+    EXPECT_EQ(capturedFills_[2].orderId_, 3);
+    EXPECT_EQ(capturedFills_[2].price_, toPrice(0.50, TWO_DIGITS_PRICE_SPEC));
+}
+
+TEST_F(LadderOrderBookTest, SubmitBatch_SweepsMergedIntoOneHandOff) {
+    orderBook_->submitNewOrder(limit(1, Side::Sell, 10, 150.00));
+    orderBook_->submitNewOrder(limit(2, Side::Sell, 10, 150.05));
+
+    const std::array<Event, 2> batch {
+      Event{std::in_place_type<NewOrderEvent>, "user"_uid, 3, "AAPL"_sym, 10, Side::Buy, Type::Limit, toPrice(150.00, TWO_DIGITS_PRICE_SPEC)},
+      Event{std::in_place_type<NewOrderEvent>, "user"_uid, 4, "AAPL"_sym, 5, Side::Buy, Type::Market, MARKET_PRICE},
+    };
+
+    expectFills();
+    EXPECT_EQ(orderBook_->submitBatch(batch), 2);
+
+    ASSERT_EQ(capturedFills_.size(), 4);
+    EXPECT_EQ(capturedFills_[0].orderId_, 1);
+    EXPECT_EQ(capturedFills_[2].orderId_, 2);
+    EXPECT_EQ(capturedFills_[3].orderId_, 4);
+    EXPECT_EQ(capturedFills_[3].filledQuantity_, 5);
+}
+
+TEST_F(LadderOrderBookTest, Fills_StampedAtTheMatch) {
+    orderBook_->submitNewOrder(limit(1, Side::Sell, 10, 150.00));
+    orderBook_->submitNewOrder(limit(2, Side::Sell, 10, 150.05));
+
+    expectFills();
+    const auto before = Clock::now();
+    orderBook_->submitNewOrder(limit(3, Side::Buy, 20, 150.05));
+    const auto after = Clock::now();
+
+    ASSERT_EQ(capturedFills_.size(), 4);
+    // one stamp for the whole sweep, not a clock read per fill
+    for (const auto& fill : capturedFills_) {
+      EXPECT_GE(fill.matched_, before);
+      EXPECT_LE(fill.matched_, after);
+      EXPECT_EQ(fill.matched_, capturedFills_[0].matched_);
+    }
+}
+
+TEST_F(LadderOrderBookTest, SubmitNewOrder_InvalidPrice_Rejected) {
+    expectCancel();
+    EXPECT_FALSE(orderBook_->submitNewOrder(NewOrderEvent("user"_uid, 1, "AAPL"_sym, 10, Side::Buy, Type::Limit, INVALID_PRICE)));
+    EXPECT_EQ(capturedCancel_.remainingQuantity_, 10);
+    EXPECT_EQ(capturedCancel_.reason_, CancelReason::Price_Out_Of_Range);
+
+    auto tob = topOfBook();
+    EXPECT_FALSE(tob.bid_.isValid());
+}
+
+TEST_F(LadderOrderBookTest, SubmitNewOrder_FarFromTheBand_BandMovesThere) {
+    // nothing resting, the band just moves
+    EXPECT_TRUE(orderBook_->submitNewOrder(limit(1, Side::Buy, 10, 50000.00)));
+    // further out than MAX_NUM_LEVELS from where the band started, but close to the order resting there
+    EXPECT_TRUE(orderBook_->submitNewOrder(limit(2, Side::Sell, 10, 51000.00)));
+    EXPECT_TRUE(orderBook_->submitNewOrder(limit(3, Side::Buy, 10, 49000.00)));
+
+    auto tob = topOfBook();
+    EXPECT_EQ(tob.bid_.price_, toPrice(50000.00, TWO_DIGITS_PRICE_SPEC));
+    EXPECT_EQ(tob.ask_.price_, toPrice(51000.00, TWO_DIGITS_PRICE_SPEC));
+
+    expectFills();
+    orderBook_->submitNewOrder(limit(4, Side::Sell, 20, 49000.00));
+    ASSERT_EQ(capturedFills_.size(), 4);
+    EXPECT_EQ(capturedFills_[0].orderId_, 1);
+    EXPECT_EQ(capturedFills_[2].orderId_, 3);
+}
+
+TEST_F(LadderOrderBookTest, SubmitNewOrder_TooFarFromTheBook_CanceledWithAReport) {
+    orderBook_->submitNewOrder(limit(1, Side::Buy, 10, 1.00));
+
+    // the band can't stretch from the 1.00 bid to here
+    const auto farOut = Price{toPrice(1.00, TWO_DIGITS_PRICE_SPEC).ticks + static_cast<int64_t>(LadderOrderBook<MockReportSink>::MAX_NUM_LEVELS)};
+    expectCancel();
+    EXPECT_FALSE(orderBook_->submitNewOrder(NewOrderEvent("user"_uid, 2, "AAPL"_sym, 15, Side::Sell, Type::Limit, farOut)));
+
+    EXPECT_EQ(capturedCancel_.orderId_, 2);
+    EXPECT_EQ(capturedCancel_.remainingQuantity_, 15);
+    EXPECT_EQ(capturedCancel_.reason_, CancelReason::Price_Out_Of_Range);
+
+    auto tob = topOfBook();
+    EXPECT_EQ(tob.bid_.orderCount_, 1u);
+    EXPECT_FALSE(tob.ask_.isValid());
+}
+
+TEST_F(LadderOrderBookTest, TopOfBook_IsTheWholeBestLevel) {
+    orderBook_->submitNewOrder(limit(1, Side::Sell, 10, 150.05));
+    orderBook_->submitNewOrder(limit(2, Side::Sell, 25, 150.05));
+    orderBook_->submitNewOrder(limit(3, Side::Sell, 40, 150.10));
+
+    EXPECT_EQ(orderBook_->topOfBook().ask_, (PriceLevel{toPrice(150.05, TWO_DIGITS_PRICE_SPEC), 35, 2}));
+
+    expectFills();
+    orderBook_->submitNewOrder(limit(4, Side::Buy, 15, 150.05));
+    EXPECT_EQ(orderBook_->topOfBook().ask_, (PriceLevel{toPrice(150.05, TWO_DIGITS_PRICE_SPEC), 20, 1}));
+
+    orderBook_->submitCancelOrder(CancelOrderEvent("user"_uid, 5, "AAPL"_sym, 2));
+    EXPECT_EQ(orderBook_->topOfBook().ask_, (PriceLevel{toPrice(150.10, TWO_DIGITS_PRICE_SPEC), 40, 1}));
+}
+
+TEST_F(LadderOrderBookTest, PublishTopOfBook_OnlyWhenTopChanges) {
+    orderBook_->setPublishTopOfBook(true);
+
+    std::vector<TopOfBookReport> published;
+    EXPECT_CALL(*mockReportSink_, submitTopOfBook(testing::_))
+        .Times(2)
+        .WillRepeatedly(testing::Invoke([&published](TopOfBookReport&& report) {
+            published.push_back(report);
+            return true;
+        }));
+
+    orderBook_->submitNewOrder(limit(1, Side::Buy, 10, 149.95));
+    orderBook_->submitNewOrder(limit(2, Side::Buy, 10, 149.90));   // behind the top
+    orderBook_->submitNewOrder(limit(3, Side::Buy, 5, 149.95));    // same price, level grows
+
+    ASSERT_EQ(published.size(), 2);
+    EXPECT_EQ(published[0].bid_, (PriceLevel{toPrice(149.95, TWO_DIGITS_PRICE_SPEC), 10, 1}));
+    EXPECT_EQ(published[1].bid_, (PriceLevel{toPrice(149.95, TWO_DIGITS_PRICE_SPEC), 15, 2}));
+}
+
+TEST_F(LadderOrderBookTest, SubmitDepth_SkipsEmptyLevels) {
+    orderBook_->submitNewOrder(limit(1, Side::Sell, 10, 150.05));
+    orderBook_->submitNewOrder(limit(2, Side::Sell, 15, 150.05));
+    orderBook_->submitNewOrder(limit(3, Side::Sell, 40, 150.50));
+    orderBook_->submitNewOrder(limit(4, Side::Sell, 5, 151.00));
+    orderBook_->submitNewOrder(limit(5, Side::Buy, 20, 149.00));
+    orderBook_->submitNewOrder(limit(6, Side::Buy, 30, 120.00));      // grows the ladder
+
+    DepthReport captured;
+    EXPECT_CALL(*mockReportSink_, submitDepth(testing::_))
+        .WillOnce(testing::Invoke([&captured](DepthReport&& report) {
+            captured = std::move(report);
+            return true;
+        }));
+    orderBook_->submitDepth(DepthEvent("user"_uid, 7, "AAPL"_sym));
+
+    ASSERT_EQ(captured.asks().size(), 3u);
+    EXPECT_EQ(captured.asks()[0], (PriceLevel{toPrice(150.05, TWO_DIGITS_PRICE_SPEC), 25, 2}));
+    EXPECT_EQ(captured.asks()[1], (PriceLevel{toPrice(150.50, TWO_DIGITS_PRICE_SPEC), 40, 1}));
+    EXPECT_EQ(captured.asks()[2], (PriceLevel{toPrice(151.00, TWO_DIGITS_PRICE_SPEC), 5, 1}));
+    ASSERT_EQ(captured.bids().size(), 2u);
+    EXPECT_EQ(captured.bids()[0], (PriceLevel{toPrice(149.00, TWO_DIGITS_PRICE_SPEC), 20, 1}));
+    EXPECT_EQ(captured.bids()[1], (PriceLevel{toPrice(120.00, TWO_DIGITS_PRICE_SPEC), 30, 1}));
+
+    EXPECT_EQ(orderBook_->depth(1).asks().size(), 1u);
+}
+
+} // namespace test
+} // namespace Exchange
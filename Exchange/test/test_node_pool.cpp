@@ -0,0 +1,114 @@
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include <list>
+#include "NodePool.h"
+#include "OrderBook.h"
+#include "UserRegistry.h"
+#include "LadderOrderBook.h"
+#include "MockReportSink.h"
+
+namespace Exchange {
+namespace test {
+
+class NodePoolTest : public ::testing::Test {
+};
+
+TEST_F(NodePoolTest, Construction_PreallocatesInitialCapacity) {
+    NodePool pool(48, NodePoolConfig{.initialCapacity = 100, .blocksPerChunk = 10});
+
+    EXPECT_EQ(pool.stats().chunks, 1);
+    EXPECT_EQ(pool.stats().capacity, 100);
+    EXPECT_EQ(pool.stats().live, 0);
+    EXPECT_GE(pool.blockSize(), 48);
+    EXPECT_EQ(pool.blockSize() % alignof(std::max_align_t), 0);
+}
+
+TEST_F(NodePoolTest, Deallocate_BlockIsReused) {
+    NodePool pool(32, NodePoolConfig{.initialCapacity = 4, .blocksPerChunk = 4});
+
+    void* a = pool.allocate();
+    void* b = pool.allocate();
+    EXPECT_NE(a, b);
+
+    pool.deallocate(a);
+    EXPECT_EQ(pool.allocate(), a);
+    EXPECT_EQ(pool.stats().chunks, 1);
+}
+
+TEST_F(NodePoolTest, Allocate_PastCapacity_GrowsByChunk) {
+    NodePool pool(32, NodePoolConfig{.initialCapacity = 2, .blocksPerChunk = 8});
+
+    std::vector<void*> blocks;
+    for (int i = 0; i < 3; ++i) {
+      blocks.push_back(pool.allocate());
+    }
+
+    EXPECT_EQ(pool.stats().chunks, 2);
+    EXPECT_EQ(pool.stats().capacity, 10);
+    EXPECT_EQ(pool.stats().live, 3);
+    EXPECT_EQ(pool.stats().peak, 3);
+
+    for (auto* block : blocks) {
+      pool.deallocate(block);
+    }
+    EXPECT_EQ(pool.stats().live, 0);
+    EXPECT_EQ(pool.stats().peak, 3);
+}
+
+TEST_F(NodePoolTest, PoolAllocator_WithStdContainer) {
+    NodeArena arena(NodePoolConfig{.initialCapacity = 16, .blocksPerChunk = 16});
+    {
+      std::list<int, PoolAllocator<int>> values{PoolAllocator<int>(&arena)};
+      for (int i = 0; i < 20; ++i) {
+        values.push_back(i);
+      }
+      EXPECT_EQ(arena.stats().live, 20);
+      EXPECT_EQ(arena.stats().chunks, 2);
+
+      values.pop_front();
+      values.push_back(20);
+      EXPECT_EQ(arena.stats().live, 20);
+      EXPECT_EQ(arena.stats().chunks, 2);
+    }
+    EXPECT_EQ(arena.stats().live, 0);
+    EXPECT_EQ(arena.stats().peak, 20);
+}
+
+TEST_F(NodePoolTest, OrderBook_RestingOrdersComeFromPool) {
+    auto sink = std::make_unique<MockReportSink>();
+    auto* mockSink = sink.get();
+    OrderBook<MockReportSink> book(Symbol{"AAPL"}, std::move(sink), NodePoolConfig{.initialCapacity = 8, .blocksPerChunk = 8});
+
+    const auto before = book.nodePoolStats().live;
+    for (int i = 0; i < 10; ++i) {
+      book.submitNewOrder(NewOrderEvent("user"_uid, i, "AAPL"_sym, 10, Side::Buy, Type::Limit, toPrice(150.00 - i * 0.01, TWO_DIGITS_PRICE_SPEC)));
+    }
+    // every order is on its own price, so one order node + one level node each
+    EXPECT_EQ(book.nodePoolStats().live, before + 20);
+
+    EXPECT_CALL(*mockSink, submitFills(testing::_)).WillOnce(testing::Return(true));
+    book.submitNewOrder(NewOrderEvent("user"_uid, 100, "AAPL"_sym, 30, Side::Sell, Type::Limit, toPrice(149.98, TWO_DIGITS_PRICE_SPEC)));
+    EXPECT_EQ(book.nodePoolStats().live, before + 14);
+}
+
+TEST_F(NodePoolTest, LadderOrderBook_RestingOrdersComeFromPool) {
+    auto sink = std::make_unique<MockReportSink>();
+    auto* mockSink = sink.get();
+    LadderOrderBook<MockReportSink> book(Symbol{"AAPL"}, std::move(sink), toPrice(150.00, TWO_DIGITS_PRICE_SPEC),
+                                         LadderOrderBook<MockReportSink>::DEFAULT_NUM_LEVELS,
+                                         NodePoolConfig{.initialCapacity = 4, .blocksPerChunk = 4});
+
+    for (int i = 0; i < 6; ++i) {
+      book.submitNewOrder(NewOrderEvent("user"_uid, i, "AAPL"_sym, 10, Side::Sell, Type::Limit, toPrice(150.00, TWO_DIGITS_PRICE_SPEC)));
+    }
+    EXPECT_EQ(book.nodePoolStats().live, 6);
+    EXPECT_EQ(book.nodePoolStats().chunks, 2);
+
+    EXPECT_CALL(*mockSink, submitCanceledOrder(testing::_)).WillOnce(testing::Return(true));
+    EXPECT_TRUE(book.submitCancelOrder(CancelOrderEvent("user"_uid, 10, "AAPL"_sym, 3)));
+    EXPECT_EQ(book.nodePoolStats().live, 5);
+    EXPECT_EQ(book.nodePoolStats().peak, 6);
+}
+
+} // namespace test
+} // namespace Exchange
@@ -0,0 +1,204 @@
+#include <gtest/gtest.h>
+#include "OrderBookManager.h"
+#include "LadderOrderBook.h"
+
+#include <chrono>
+#include <mutex>
+#include <thread>
+
+namespace Exchange {
+namespace test {
+
+namespace {
+  // remembers what it was handed, from the shard thread
+  class RecordingBook final : public IOrderBook {
+  public:
+    bool submitNewOrder(const NewOrderEvent& event) override { record(Event{std::in_place_type<NewOrderEvent>, event}); return true; }
+    bool submitCancelOrder(const CancelOrderEvent& event) override { record(Event{std::in_place_type<CancelOrderEvent>, event}); return true; }
+    void submitTopOfBook(const TopOfBookEvent& event) override { record(Event{std::in_place_type<TopOfBookEvent>, event}); }
+    void submitDepth(const DepthEvent& event) override { record(Event{std::in_place_type<DepthEvent>, event}); }
+
+    std::size_t submitBatch(std::span<const Event> events) override {
+      for (const auto& event : events) {
+        record(event);
+      }
+      return events.size();
+    }
+
+    std::vector<Event> events() const {
+      std::lock_guard lock(mutex_);
+      return events_;
+    }
+
+    std::size_t count() const {
+      std::lock_guard lock(mutex_);
+      return events_.size();
+    }
+
+  private:
+    void record(const Event& event) {
+      std::lock_guard lock(mutex_);
+      events_.push_back(event);
+    }
+
+    mutable std::mutex mutex_;
+    std::vector<Event> events_;
+  };
+
+  Event newOrder(Symbol symbol, OrderId id) {
+    return Event{std::in_place_type<NewOrderEvent>, INVALID_USER_ID, id, symbol, 10, Side::Buy, Type::Market};
+  }
+
+  // what a by-value book reported, from the shard thread
+  class RecordingSink {
+  public:
+    explicit RecordingSink(const SymbolRegistry&) {}
+
+    bool submitFills(ExecutionReportView fills) {
+      std::lock_guard lock(mutex_);
+      fills_.insert(fills_.end(), fills.begin(), fills.end());
+      return true;
+    }
+    bool submitAcceptedOrder(OrderAcceptedReport&&) { std::lock_guard lock(mutex_); ++accepted_; return true; }
+    bool submitCanceledOrder(OrderCanceledReport&&) { return true; }
+    bool submitTopOfBook(TopOfBookReport&&) { return true; }
+    bool submitDepth(DepthReport&&) { return true; }
+
+    std::vector<ExecutionReport> fills() const {
+      std::lock_guard lock(mutex_);
+      return fills_;
+    }
+
+    std::size_t accepted() const {
+      std::lock_guard lock(mutex_);
+      return accepted_;
+    }
+
+  private:
+    mutable std::mutex mutex_;
+    std::vector<ExecutionReport> fills_;
+    std::size_t accepted_ {0};
+  };
+
+  using LadderBook = LadderOrderBook<RecordingSink>;
+
+  static_assert(ManagedBook<IOrderBook>);
+  static_assert(ManagedBook<OrderBook<ReportSink>>);
+  static_assert(ManagedBook<LadderBook>);
+  // no sink the manager could build the missing books with
+  static_assert(!ManagedBook<RecordingBook>);
+}
+
+class OrderBookManagerTest : public ::testing::Test {
+  protected:
+    void SetUp() override {
+      OrderBookManager::OrderBookMap books;
+      for (auto symbol : symbols_.symbols()) {
+        auto book = std::make_unique<RecordingBook>();
+        books_[symbol] = book.get();
+        books.emplace(symbol, std::move(book));
+      }
+      manager_ = std::make_unique<OrderBookManager>(std::move(books), 2, symbols_);
+    }
+
+    void TearDown() override {
+      manager_->stop();
+    }
+
+    // shards run on their own threads, give them a moment
+    void waitFor(std::size_t expected) {
+      const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+      auto total = [this] {
+        std::size_t count {0};
+        for (const auto& [_, book] : books_) {
+          count += book->count();
+        }
+        return count;
+      };
+      while (total() < expected && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+      }
+    }
+
+    SymbolRegistry symbols_ {"AAPL", "MSFT", "NVDA"};
+    std::unordered_map<Symbol, RecordingBook*> books_;
+    std::unique_ptr<OrderBookManager> manager_;
+};
+
+TEST_F(OrderBookManagerTest, Submit_RoutesBySymbol) {
+    EXPECT_TRUE(manager_->submit(newOrder("AAPL"_sym, 1)));
+    EXPECT_TRUE(manager_->submit(newOrder("NVDA"_sym, 2)));
+    EXPECT_TRUE(manager_->submit(newOrder("AAPL"_sym, 3)));
+    waitFor(3);
+
+    const auto aapl = books_["AAPL"_sym]->events();
+    ASSERT_EQ(aapl.size(), 2u);
+    EXPECT_EQ(std::get<NewOrderEvent>(aapl[0].data_).clientOrderId(), 1);
+    EXPECT_EQ(std::get<NewOrderEvent>(aapl[1].data_).clientOrderId(), 3);
+    // resolved on the way in, the events didn't come through a parser
+    EXPECT_EQ(aapl[0].symbolId(), symbols_.find("AAPL"_sym));
+
+    ASSERT_EQ(books_["NVDA"_sym]->count(), 1u);
+    EXPECT_EQ(books_["MSFT"_sym]->count(), 0u);
+}
+
+TEST_F(OrderBookManagerTest, SubmitSpan_EveryEventReachesItsBookInOrder) {
+    std::vector<Event> burst;
+    for (OrderId id = 0; id < 30; ++id) {
+        burst.push_back(newOrder(symbols_.symbol(static_cast<SymbolId>(id % 3 + 1)), id));
+    }
+    burst.push_back(newOrder("GOOGL"_sym, 99));   // no book for it, dropped by the shard
+
+    EXPECT_EQ(manager_->submit(std::span<const Event>(burst)), burst.size());
+    waitFor(30);
+
+    for (const auto& [symbol, book] : books_) {
+        const auto events = book->events();
+        ASSERT_EQ(events.size(), 10u) << symbol;
+        for (std::size_t i = 1; i < events.size(); ++i) {
+            EXPECT_LT(std::get<NewOrderEvent>(events[i - 1].data_).clientOrderId(),
+                      std::get<NewOrderEvent>(events[i].data_).clientOrderId());
+        }
+    }
+}
+
+TEST(ConcreteOrderBookManagerTest, LadderBooksByValue_MatchOnTheShards) {
+    // the manager builds NVDA's ladder around its reference price
+    SymbolRegistry symbols {{"AAPL"}, {"MSFT"}, {"NVDA", TWO_DIGITS_PRICE_SPEC, toPrice(150.00, TWO_DIGITS_PRICE_SPEC)}};
+    BasicOrderBookManager<LadderBook>::OrderBookMap books;
+    std::unordered_map<Symbol, RecordingSink*> sinks;
+    for (auto symbol : {"AAPL"_sym, "MSFT"_sym}) {
+        auto sink = std::make_unique<RecordingSink>(symbols);
+        sinks[symbol] = sink.get();
+        books.emplace(symbol, LadderBook(symbol, std::move(sink), toPrice(150.00, TWO_DIGITS_PRICE_SPEC)));
+    }
+    BasicOrderBookManager<LadderBook> manager {std::move(books), 2, symbols};
+
+    const auto price = toPrice(150.25, TWO_DIGITS_PRICE_SPEC);
+    const std::vector<Event> burst {
+        Event{std::in_place_type<NewOrderEvent>, INVALID_USER_ID, 1, "AAPL"_sym, 10, Side::Sell, Type::Limit, price},
+        Event{std::in_place_type<NewOrderEvent>, INVALID_USER_ID, 2, "MSFT"_sym, 5, Side::Buy, Type::Limit, price},
+        Event{std::in_place_type<NewOrderEvent>, INVALID_USER_ID, 3, "NVDA"_sym, 5, Side::Buy, Type::Limit, price},
+        Event{std::in_place_type<NewOrderEvent>, INVALID_USER_ID, 4, "AAPL"_sym, 4, Side::Buy, Type::Market},
+    };
+    EXPECT_EQ(manager.submit(std::span<const Event>(burst)), burst.size());
+
+    auto& aapl = *sinks["AAPL"_sym];
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while ((aapl.fills().empty() || sinks["MSFT"_sym]->accepted() == 0) && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    manager.stop();
+
+    EXPECT_EQ(aapl.accepted(), 1u);
+    const auto fills = aapl.fills();
+    ASSERT_FALSE(fills.empty());
+    EXPECT_EQ(fills.front().filledQuantity_, 4);
+    EXPECT_EQ(fills.front().price_, price);
+    // the MSFT order rests in its own book, nothing crosses it
+    EXPECT_EQ(sinks["MSFT"_sym]->accepted(), 1u);
+    EXPECT_TRUE(sinks["MSFT"_sym]->fills().empty());
+}
+
+} // namespace test
+} // namespace Exchange
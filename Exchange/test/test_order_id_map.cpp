@@ -0,0 +1,142 @@
+#include <gtest/gtest.h>
+#include "OrderIdMap.h"
+
+#include <algorithm>
+#include <vector>
+
+namespace Exchange {
+namespace test {
+
+class OrderIdMapTest : public ::testing::Test {
+protected:
+    OrderIdMap<int> map_;
+    int values_[4] {10, 20, 30, 40};
+};
+
+TEST_F(OrderIdMapTest, Insert_IdsStartAtOne) {
+    EXPECT_EQ(map_.nextId(), 1);
+    EXPECT_EQ(map_.find(INVALID_EXCHANGE_ORDER_ID), nullptr);
+
+    map_.insert(map_.nextId(), &values_[0]);
+    map_.insert(map_.nextId(), &values_[1]);
+
+    EXPECT_EQ(map_.size(), 2);
+    EXPECT_EQ(map_.nextId(), 3);
+    EXPECT_EQ(map_.find(1), &values_[0]);
+    EXPECT_EQ(map_.find(2), &values_[1]);
+    EXPECT_EQ(map_.find(3), nullptr);
+}
+
+TEST_F(OrderIdMapTest, Erase_OnlyOnce) {
+    for (auto& value : values_) {
+      map_.insert(map_.nextId(), &value);
+    }
+
+    EXPECT_TRUE(map_.erase(2));
+    EXPECT_FALSE(map_.erase(2));
+    EXPECT_FALSE(map_.erase(99));
+    EXPECT_EQ(map_.find(2), nullptr);
+    EXPECT_EQ(map_.find(3), &values_[2]);
+    EXPECT_EQ(map_.size(), 3);
+
+    std::vector<int> seen;
+    map_.forEach([&seen](int* value) { seen.push_back(*value); });
+    std::ranges::sort(seen);
+    EXPECT_EQ(seen, (std::vector<int>{10, 30, 40}));
+}
+
+TEST_F(OrderIdMapTest, Erase_OldOrdersGone_IdsStayValid) {
+    // enough churn to wrap around the table many times
+    int value = 0;
+    ExchangeOrderId oldest = map_.nextId();
+    for (int i = 0; i < 10000; ++i) {
+      map_.insert(map_.nextId(), &value);
+      if (map_.size() > 3) {
+        EXPECT_TRUE(map_.erase(oldest++));
+      }
+    }
+
+    EXPECT_EQ(map_.size(), 3);
+    EXPECT_EQ(map_.nextId(), 10001);
+    EXPECT_EQ(map_.find(oldest - 1), nullptr);
+    EXPECT_EQ(map_.find(1), nullptr);
+    EXPECT_EQ(map_.find(9998), &value);
+    EXPECT_EQ(map_.find(10000), &value);
+    EXPECT_FALSE(map_.erase(5));
+}
+
+TEST_F(OrderIdMapTest, LongRestingOrder_TableStaysSmall) {
+    // the first order never goes, everything after it comes and goes
+    int value = 0;
+    map_.insert(map_.nextId(), &values_[0]);
+    ExchangeOrderId oldest = map_.nextId();
+    for (int i = 0; i < 100000; ++i) {
+      map_.insert(map_.nextId(), &value);
+      if (map_.size() > 10) {
+        EXPECT_TRUE(map_.erase(oldest++));
+      }
+    }
+
+    EXPECT_EQ(map_.size(), 10);
+    EXPECT_EQ(map_.capacity(), OrderIdMap<int>::MIN_CAPACITY);
+    EXPECT_EQ(map_.find(1), &values_[0]);
+    EXPECT_EQ(map_.find(map_.nextId() - 1), &value);
+}
+
+TEST_F(OrderIdMapTest, Erase_EveryOther_ProbeRunsStayIntact) {
+    std::vector<int> values(10000);
+    for (auto& value : values) {
+      map_.insert(map_.nextId(), &value);
+    }
+    EXPECT_GE(map_.capacity(), 2 * values.size());
+
+    for (ExchangeOrderId id = 1; id <= values.size(); id += 2) {
+      EXPECT_TRUE(map_.erase(id));
+    }
+    for (ExchangeOrderId id = 2; id <= values.size(); id += 2) {
+      EXPECT_EQ(map_.find(id), &values[id - 1]);
+    }
+    for (ExchangeOrderId id = 2; id < values.size(); id += 2) {
+      EXPECT_TRUE(map_.erase(id));
+    }
+
+    EXPECT_EQ(map_.size(), 1);
+    EXPECT_EQ(map_.find(values.size()), &values.back());
+    EXPECT_EQ(map_.find(values.size() - 1), nullptr);
+}
+
+TEST(OrderIdMapColdTest, ColdData_FollowsTheIdThroughRehashes) {
+    OrderIdMap<int, int64_t> map;
+    int value = 0;
+    ExchangeOrderId oldest = map.nextId();
+    for (int64_t i = 1; i <= 5000; ++i) {
+      map.insert(map.nextId(), &value, i * 10);
+      if (map.size() > 2) {
+        EXPECT_TRUE(map.erase(oldest++));
+      }
+    }
+
+    EXPECT_EQ(map.size(), 2);
+    EXPECT_EQ(map.cold(4999), 49990);
+    EXPECT_EQ(map.cold(5000), 50000);
+}
+
+TEST(OrderIdMapColdTest, ColdData_MovesWithItsSlot) {
+    // 1 and 65 share a home slot at the minimum capacity, erasing 1 shifts 65 back
+    OrderIdMap<int, int64_t> map;
+    int value = 0;
+    for (int64_t i = 1; i <= 65; ++i) {
+      map.insert(map.nextId(), &value, i * 10);
+      if (i > 1 && i < 65) {
+        EXPECT_TRUE(map.erase(static_cast<ExchangeOrderId>(i)));
+      }
+    }
+    EXPECT_EQ(map.capacity(), OrderIdMap<int>::MIN_CAPACITY);
+
+    EXPECT_TRUE(map.erase(1));
+    EXPECT_EQ(map.find(65), &value);
+    EXPECT_EQ(map.cold(65), 650);
+}
+
+} // namespace test
+} // namespace Exchange
@@ -1,5 +1,6 @@
 #include <gtest/gtest.h>
 #include "OrderUtils.h"
+#include "ReportUtils.h"
 
 namespace Exchange {
 namespace test {
@@ -99,5 +100,88 @@ TEST_F(OrderUtilsTest, ToPrice_LargeNumbers) {
     EXPECT_EQ(toPrice(1000000.00, spec).ticks, 100000000);
 }
 
+TEST_F(OrderUtilsTest, ParsePrice_ValidConversions) {
+    PriceSpec twoDigitSpec{100, 1};
+    PriceSpec fxSpec{100000, 1};        // 5 decimals
+    PriceSpec cryptoSpec{100000000, 1}; // 8 decimals
+    PriceSpec tickSpec{100, 5};         // $0.05 tick
+
+    EXPECT_EQ(parsePrice("10.50", twoDigitSpec).ticks, 1050);
+    EXPECT_EQ(parsePrice("10.5", twoDigitSpec).ticks, 1050);
+    EXPECT_EQ(parsePrice("10", twoDigitSpec).ticks, 1000);
+    EXPECT_EQ(parsePrice("0.01", twoDigitSpec).ticks, 1);
+    EXPECT_EQ(parsePrice(".99", twoDigitSpec).ticks, 99);
+    EXPECT_EQ(parsePrice("+1.2300", twoDigitSpec).ticks, 123);   // trailing zeros past the spec are fine
+    EXPECT_EQ(parsePrice("-10.50", twoDigitSpec).ticks, -1050);
+    EXPECT_EQ(parsePrice("999999.99", twoDigitSpec).ticks, 99999999);
+
+    EXPECT_EQ(parsePrice("1.08345", fxSpec).ticks, 108345);
+    EXPECT_EQ(parsePrice("64250.00000001", cryptoSpec).ticks, 6425000000001);
+    EXPECT_EQ(parsePrice("10.50", tickSpec).ticks, 210);
+}
+
+TEST_F(OrderUtilsTest, ParsePrice_Rejects) {
+    PriceSpec twoDigitSpec{100, 1};
+    PriceSpec tickSpec{100, 5};
+
+    EXPECT_THROW(parsePrice("10.505", twoDigitSpec), std::invalid_argument);   // no rounding, unlike toPrice
+    EXPECT_THROW(parsePrice("10.01", tickSpec), std::invalid_argument);        // not on the $0.05 grid
+    EXPECT_THROW(parsePrice("", twoDigitSpec), std::invalid_argument);
+    EXPECT_THROW(parsePrice("-", twoDigitSpec), std::invalid_argument);
+    EXPECT_THROW(parsePrice("abc", twoDigitSpec), std::invalid_argument);
+    EXPECT_THROW(parsePrice("1.2.3", twoDigitSpec), std::invalid_argument);
+    EXPECT_THROW(parsePrice("1e5", twoDigitSpec), std::invalid_argument);
+    EXPECT_THROW(parsePrice("1234567890123456789", twoDigitSpec), std::out_of_range);
+}
+
+TEST_F(OrderUtilsTest, TryParsePrice_ErrorCodes) {
+    PriceSpec twoDigitSpec{100, 1};
+    PriceSpec tickSpec{100, 5};
+
+    EXPECT_EQ(tryParsePrice("10.50", twoDigitSpec), Price{1050});
+    EXPECT_EQ(tryParsePrice("10.505", twoDigitSpec).error(), PriceError::TooManyDecimals);
+    EXPECT_EQ(tryParsePrice("10.01", tickSpec).error(), PriceError::OffTick);
+    EXPECT_EQ(tryParsePrice("abc", twoDigitSpec).error(), PriceError::Invalid);
+    EXPECT_EQ(tryParsePrice("", twoDigitSpec).error(), PriceError::Invalid);
+    EXPECT_EQ(tryParsePrice("1234567890123456789", twoDigitSpec).error(), PriceError::OutOfRange);
+}
+
+TEST_F(OrderUtilsTest, FormatPrice) {
+    EXPECT_EQ(toString(Price{1050}, PriceSpec{100, 1}), "10.50");
+    EXPECT_EQ(toString(Price{1}, PriceSpec{100, 1}), "0.01");
+    EXPECT_EQ(toString(Price{0}, PriceSpec{100, 1}), "0.00");
+    EXPECT_EQ(toString(Price{-1050}, PriceSpec{100, 1}), "-10.50");
+    EXPECT_EQ(toString(Price{-5}, PriceSpec{100, 1}), "-0.05");
+    EXPECT_EQ(toString(Price{210}, PriceSpec{100, 5}), "10.50");
+    EXPECT_EQ(toString(Price{108345}, PriceSpec{100000, 1}), "1.08345");
+    EXPECT_EQ(toString(Price{7}, PriceSpec{1, 1}), "7");
+    EXPECT_EQ(toString(MARKET_PRICE, PriceSpec{100, 1}), "MKT");
+
+    EXPECT_EQ(std::format("{}", Price{15025}), "150.25");
+    EXPECT_EQ(std::format("{:>8}", PriceText{Price{108345}, PriceSpec{100000, 1}}), " 1.08345");
+}
+
+TEST_F(OrderUtilsTest, FormatReport_InTheGivenSpec) {
+    // not a symbol of the global registry, the spec comes with the report
+    const PriceSpec spec{100000, 1};
+    const ExecutionReport fill{"EURUSD"_sym, 1, 2, 10, Price{108345}};
+    EXPECT_EQ(std::format("{}", ReportText{fill, spec}),
+              "ExecutionReport{symbol=EURUSD, orderId=1, otherOrderId=2, filledQuantity=10, price=1.08345}");
+
+    const OrderAcceptedReport accepted{"EURUSD"_sym, 3, 4, 100, Price{108350}};
+    EXPECT_EQ(std::format("{}", ReportText{accepted, spec}),
+              "OrderAcceptedReport{symbol=EURUSD, clientOrderId=3, exchangeOrderId=4, openQty=100, price=1.08350}");
+
+    const TopOfBookReport top{"EURUSD"_sym, PriceLevel{Price{108340}, 5, 1}, PriceLevel{}};
+    EXPECT_NE(std::format("{}", ReportText{top, spec}).find("price=1.08340"), std::string::npos);
+}
+
+TEST_F(OrderUtilsTest, ParsePrice_FormatPrice_RoundTrip) {
+    PriceSpec spec{100000, 1};
+    for (std::string_view text : {"0.00001", "1.00000", "1.23456", "-99.99999", "123456.78901"}) {
+        EXPECT_EQ(toString(parsePrice(text, spec), spec), text);
+    }
+}
+
 } // namespace test
 } // namespace Exchange 
\ No newline at end of file
@@ -2,20 +2,14 @@
 #include <gmock/gmock.h>
 #include "OrderBook.h"
 #include "Event.h"
+#include "UserRegistry.h"
 #include "OrderUtils.h"
 #include "ReportUtils.h"
+#include "MockReportSink.h"
 
 namespace Exchange {
 namespace test {
 
-// Mock ReportSink for testing using older Google Mock syntax
-class MockReportSink {
-public:
-    MOCK_METHOD1(submitFills, bool(ExecutionReportCollection&& fills));
-    MOCK_METHOD1(submitCanceledOrder, bool(OrderCanceledReport&& report));
-    MOCK_METHOD1(submitTopOfBook, bool(TopOfBookReport&& report));
-};
-
 class OrderBookTest : public ::testing::Test {
 protected:
     void SetUp() override {
@@ -62,15 +56,15 @@ TEST_F(OrderBookTest, SubmitNewOrder_BuyLimitOrder_AddsToBidBook) {
     orderBook_->submitTopOfBook(topOfBookEvent);
 
     // Assert - Verify top of book shows correct bid order
-    EXPECT_EQ(capturedTopOfBook.bid_order_.orderId_, 1001);
-    EXPECT_EQ(capturedTopOfBook.bid_order_.openQuantity_, 100);
-    EXPECT_EQ(capturedTopOfBook.bid_order_.openQuantity_, 100);  // No fills yet
-    EXPECT_EQ(capturedTopOfBook.bid_order_.price_, toPrice(150.00, TWO_DIGITS_PRICE_SPEC));
+    EXPECT_EQ(capturedTopOfBook.bid_.orderCount_, 1u);
+    EXPECT_EQ(capturedTopOfBook.bid_.quantity_, 100);
+    EXPECT_EQ(capturedTopOfBook.bid_.quantity_, 100);  // No fills yet
+    EXPECT_EQ(capturedTopOfBook.bid_.price_, toPrice(150.00, TWO_DIGITS_PRICE_SPEC));
     // Ask should be empty (default Order)
-    EXPECT_FALSE(capturedTopOfBook.ask_order_.isValid());
+    EXPECT_FALSE(capturedTopOfBook.ask_.isValid());
 
     // Now cancel the order and verify the cancellation report
-    auto cancelEvent = CancelOrderEvent("user123"_uid, 1001, "AAPL"_sym, 1001);
+    auto cancelEvent = CancelOrderEvent("user123"_uid, 1001, "AAPL"_sym, 1);  // exchange id of the first order the book accepted
     
     OrderCanceledReport capturedCancel;
     EXPECT_CALL(*mockReportSink_, submitCanceledOrder(testing::_))
@@ -116,15 +110,15 @@ TEST_F(OrderBookTest, SubmitNewOrder_SellLimitOrder_AddsToAskBook) {
     orderBook_->submitTopOfBook(topOfBookEvent);
 
     // Assert - Verify top of book shows correct ask order
-    EXPECT_EQ(capturedTopOfBook.ask_order_.orderId_, 1002);
-    EXPECT_EQ(capturedTopOfBook.ask_order_.openQuantity_, 50);
-    EXPECT_EQ(capturedTopOfBook.ask_order_.openQuantity_, 50);  // No fills yet
-    EXPECT_EQ(capturedTopOfBook.ask_order_.price_, toPrice(151.00, TWO_DIGITS_PRICE_SPEC));
+    EXPECT_EQ(capturedTopOfBook.ask_.orderCount_, 1u);
+    EXPECT_EQ(capturedTopOfBook.ask_.quantity_, 50);
+    EXPECT_EQ(capturedTopOfBook.ask_.quantity_, 50);  // No fills yet
+    EXPECT_EQ(capturedTopOfBook.ask_.price_, toPrice(151.00, TWO_DIGITS_PRICE_SPEC));
     // Bid should be empty (default Order)
-    EXPECT_FALSE(capturedTopOfBook.bid_order_.isValid());
+    EXPECT_FALSE(capturedTopOfBook.bid_.isValid());
 
     // Now cancel the order and verify the cancellation report
-    auto cancelEvent = CancelOrderEvent("user456"_uid, 1002, "AAPL"_sym, 1002);
+    auto cancelEvent = CancelOrderEvent("user456"_uid, 1002, "AAPL"_sym, 1);
     
     OrderCanceledReport capturedCancel;
     EXPECT_CALL(*mockReportSink_, submitCanceledOrder(testing::_))
@@ -200,11 +194,11 @@ TEST_F(OrderBookTest, SubmitNewOrder_AggressiveBuy_FillsWithExistingSell) {
     orderBook_->submitTopOfBook(topOfBookEvent1);
 
     // Assert - Verify top of book shows only ask order before aggressive order
-    EXPECT_EQ(capturedTopOfBook1.ask_order_.orderId_, 2001);
-    EXPECT_EQ(capturedTopOfBook1.ask_order_.openQuantity_, 100);  // No fills yet
-    EXPECT_EQ(capturedTopOfBook1.ask_order_.price_, toPrice(150.00, TWO_DIGITS_PRICE_SPEC));
+    EXPECT_EQ(capturedTopOfBook1.ask_.orderCount_, 1u);
+    EXPECT_EQ(capturedTopOfBook1.ask_.quantity_, 100);  // No fills yet
+    EXPECT_EQ(capturedTopOfBook1.ask_.price_, toPrice(150.00, TWO_DIGITS_PRICE_SPEC));
     // Bid should be empty (default Order)
-    EXPECT_FALSE(capturedTopOfBook1.bid_order_.isValid());
+    EXPECT_FALSE(capturedTopOfBook1.bid_.isValid());
 
     // Now add an aggressive buy order
     auto buyEvent = NewOrderEvent(
@@ -220,8 +214,8 @@ TEST_F(OrderBookTest, SubmitNewOrder_AggressiveBuy_FillsWithExistingSell) {
     // Capture the fills to verify them
     ExecutionReportCollection capturedFills;
     EXPECT_CALL(*mockReportSink_, submitFills(testing::_))
-        .WillOnce(testing::Invoke([&capturedFills](ExecutionReportCollection&& fills) {
-            capturedFills = std::move(fills);
+        .WillOnce(testing::Invoke([&capturedFills](ExecutionReportView fills) {
+            capturedFills.assign(fills.begin(), fills.end());
             return true;
         }));
 
@@ -250,14 +244,14 @@ TEST_F(OrderBookTest, SubmitNewOrder_AggressiveBuy_FillsWithExistingSell) {
     orderBook_->submitTopOfBook(topOfBookEvent2);
 
     // Assert - Verify top of book shows remaining ask order after partial fill
-    EXPECT_EQ(capturedTopOfBook2.ask_order_.orderId_, 2001);
-    EXPECT_EQ(capturedTopOfBook2.ask_order_.openQuantity_, 50);  // 50 shares remaining after 50 filled
-    EXPECT_EQ(capturedTopOfBook2.ask_order_.price_, toPrice(150.00, TWO_DIGITS_PRICE_SPEC));
+    EXPECT_EQ(capturedTopOfBook2.ask_.orderCount_, 1u);
+    EXPECT_EQ(capturedTopOfBook2.ask_.quantity_, 50);  // 50 shares remaining after 50 filled
+    EXPECT_EQ(capturedTopOfBook2.ask_.price_, toPrice(150.00, TWO_DIGITS_PRICE_SPEC));
     // Bid should still be empty (default Order)
-    EXPECT_FALSE(capturedTopOfBook2.bid_order_.isValid());
+    EXPECT_FALSE(capturedTopOfBook2.bid_.isValid());
 
     // Now cancel the remaining 50 shares of the sell order
-    auto cancelEvent = CancelOrderEvent("user456"_uid, 2001, "AAPL"_sym, 2001);
+    auto cancelEvent = CancelOrderEvent("user456"_uid, 2001, "AAPL"_sym, 1);
     
     OrderCanceledReport capturedCancel;
     EXPECT_CALL(*mockReportSink_, submitCanceledOrder(testing::_))
@@ -303,8 +297,8 @@ TEST_F(OrderBookTest, SubmitNewOrder_AggressiveSell_FillsWithExistingBuy) {
     // Capture the fills to verify them
     ExecutionReportCollection capturedFills;
     EXPECT_CALL(*mockReportSink_, submitFills(testing::_))
-        .WillOnce(testing::Invoke([&capturedFills](ExecutionReportCollection&& fills) {
-            capturedFills = std::move(fills);
+        .WillOnce(testing::Invoke([&capturedFills](ExecutionReportView fills) {
+            capturedFills.assign(fills.begin(), fills.end());
             return true;
         }));
 
@@ -321,7 +315,7 @@ TEST_F(OrderBookTest, SubmitNewOrder_AggressiveSell_FillsWithExistingBuy) {
     EXPECT_EQ(capturedFills[1].filledQuantity_, 75);    // 75 shares filled
 
     // Now cancel the remaining 25 shares of the buy order
-    auto cancelEvent = CancelOrderEvent("user123"_uid, 3001, "AAPL"_sym, 3001);
+    auto cancelEvent = CancelOrderEvent("user123"_uid, 3001, "AAPL"_sym, 1);
     
     OrderCanceledReport capturedCancel;
     EXPECT_CALL(*mockReportSink_, submitCanceledOrder(testing::_))
@@ -379,8 +373,8 @@ TEST_F(OrderBookTest, SubmitNewOrder_PartialFill_RemainingGoesToBook) {
     // Capture the fills to verify them
     ExecutionReportCollection capturedFills;
     EXPECT_CALL(*mockReportSink_, submitFills(testing::_))
-        .WillOnce(testing::Invoke([&capturedFills](ExecutionReportCollection&& fills) {
-            capturedFills = std::move(fills);
+        .WillOnce(testing::Invoke([&capturedFills](ExecutionReportView fills) {
+            capturedFills.assign(fills.begin(), fills.end());
             return true;
         }));
 
@@ -397,7 +391,7 @@ TEST_F(OrderBookTest, SubmitNewOrder_PartialFill_RemainingGoesToBook) {
     EXPECT_EQ(capturedFills[1].filledQuantity_, 100);   // 100 shares filled (partial fill of 150)
 
     // Now cancel the remaining 50 shares of the buy order
-    auto cancelEvent = CancelOrderEvent("user123"_uid, 4002, "AAPL"_sym, 4002);
+    auto cancelEvent = CancelOrderEvent("user123"_uid, 4002, "AAPL"_sym, 3);  // the remainder is the 3rd order the book accepted
     
     OrderCanceledReport capturedCancel;
     EXPECT_CALL(*mockReportSink_, submitCanceledOrder(testing::_))
@@ -444,8 +438,8 @@ TEST_F(OrderBookTest, SubmitNewOrder_PartialFill_ThenCancelled) {
     OrderCanceledReport capturedCancel;
     
     EXPECT_CALL(*mockReportSink_, submitFills(testing::_))
-        .WillOnce(testing::Invoke([&capturedFills](ExecutionReportCollection&& fills) {
-            capturedFills = std::move(fills);
+        .WillOnce(testing::Invoke([&capturedFills](ExecutionReportView fills) {
+            capturedFills.assign(fills.begin(), fills.end());
             return true;
         }));
     
@@ -538,8 +532,8 @@ TEST_F(OrderBookTest, SubmitNewOrder_FillsMultipleOrders_PriceTimePriority) {
     // Capture the fills to verify them
     ExecutionReportCollection capturedFills;
     EXPECT_CALL(*mockReportSink_, submitFills(testing::_))
-        .WillOnce(testing::Invoke([&capturedFills](ExecutionReportCollection&& fills) {
-            capturedFills = std::move(fills);
+        .WillOnce(testing::Invoke([&capturedFills](ExecutionReportView fills) {
+            capturedFills.assign(fills.begin(), fills.end());
             return true;
         }));
 
@@ -579,6 +573,29 @@ TEST_F(OrderBookTest, SubmitNewOrder_FillsMultipleOrders_PriceTimePriority) {
     EXPECT_EQ(capturedFills[5].filledQuantity_, 40);    // 40 shares (partial)
 }
 
+TEST_F(OrderBookTest, SubmitNewOrder_SamePrice_ArrivalOrderBeatsTimestamp) {
+    // second order carries an older timestamp (e.g. stamped by a different receiver thread),
+    // it still queues behind the first one, priority is the book's own sequence
+    auto first = NewOrderEvent("user1"_uid, 6101, "AAPL"_sym, 10, Side::Sell, Type::Limit, toPrice(150.00, TWO_DIGITS_PRICE_SPEC));
+    auto second = NewOrderEvent("user2"_uid, 6102, "AAPL"_sym, 10, Side::Sell, Type::Limit, toPrice(150.00, TWO_DIGITS_PRICE_SPEC));
+    second.timestamp_ = first.timestamp_ - std::chrono::seconds(1);
+
+    orderBook_->submitNewOrder(first);
+    orderBook_->submitNewOrder(second);
+
+    ExecutionReportCollection capturedFills;
+    EXPECT_CALL(*mockReportSink_, submitFills(testing::_))
+        .WillOnce(testing::Invoke([&capturedFills](ExecutionReportView fills) {
+            capturedFills.assign(fills.begin(), fills.end());
+            return true;
+        }));
+
+    orderBook_->submitNewOrder(NewOrderEvent("user3"_uid, 6103, "AAPL"_sym, 10, Side::Buy, Type::Limit, toPrice(150.00, TWO_DIGITS_PRICE_SPEC)));
+
+    ASSERT_EQ(capturedFills.size(), 2);
+    EXPECT_EQ(capturedFills[0].orderId_, 6101);
+}
+
 TEST_F(OrderBookTest, SubmitNewOrder_MarketOrder_FillsMultipleOrders) {
     // Arrange - Add multiple sell orders
     auto sellEvent1 = NewOrderEvent(
@@ -628,8 +645,8 @@ TEST_F(OrderBookTest, SubmitNewOrder_MarketOrder_FillsMultipleOrders) {
     // Capture the fills to verify them
     ExecutionReportCollection capturedFills;
     EXPECT_CALL(*mockReportSink_, submitFills(testing::_))
-        .WillOnce(testing::Invoke([&capturedFills](ExecutionReportCollection&& fills) {
-            capturedFills = std::move(fills);
+        .WillOnce(testing::Invoke([&capturedFills](ExecutionReportView fills) {
+            capturedFills.assign(fills.begin(), fills.end());
             return true;
         }));
 
@@ -715,8 +732,8 @@ TEST_F(OrderBookTest, SubmitNewOrder_MarketSellOrder_FillsMultipleOrders) {
     // Capture the fills to verify them
     ExecutionReportCollection capturedFills;
     EXPECT_CALL(*mockReportSink_, submitFills(testing::_))
-        .WillOnce(testing::Invoke([&capturedFills](ExecutionReportCollection&& fills) {
-            capturedFills = std::move(fills);
+        .WillOnce(testing::Invoke([&capturedFills](ExecutionReportView fills) {
+            capturedFills.assign(fills.begin(), fills.end());
             return true;
         }));
 
@@ -784,8 +801,8 @@ TEST_F(OrderBookTest, SubmitNewOrder_LargeOrder_FillsEntireBook) {
     OrderCanceledReport capturedCancel;
     
     EXPECT_CALL(*mockReportSink_, submitFills(testing::_))
-        .WillOnce(testing::Invoke([&capturedFills](ExecutionReportCollection&& fills) {
-            capturedFills = std::move(fills);
+        .WillOnce(testing::Invoke([&capturedFills](ExecutionReportView fills) {
+            capturedFills.assign(fills.begin(), fills.end());
             return true;
         }));
     
@@ -822,6 +839,30 @@ TEST_F(OrderBookTest, SubmitNewOrder_LargeOrder_FillsEntireBook) {
     EXPECT_EQ(capturedCancel.reason_, CancelReason::Fill_And_Kill); // Correct reason
 }
 
+TEST_F(OrderBookTest, SubmitNewOrder_DeepSweep_FillsReportedInChunks) {
+    constexpr int depth = 200;   // 400 reports, more than the book's fill buffer holds
+    for (int i = 0; i < depth; ++i) {
+      orderBook_->submitNewOrder(NewOrderEvent("user1"_uid, 20000 + i, "AAPL"_sym, 1, Side::Sell, Type::Limit, toPrice(150.00, TWO_DIGITS_PRICE_SPEC)));
+    }
+
+    ExecutionReportCollection capturedFills;
+    EXPECT_CALL(*mockReportSink_, submitFills(testing::_))
+        .Times(2)
+        .WillRepeatedly(testing::Invoke([&capturedFills](ExecutionReportView fills) {
+            capturedFills.insert(capturedFills.end(), fills.begin(), fills.end());
+            return true;
+        }));
+
+    orderBook_->submitNewOrder(NewOrderEvent("user2"_uid, 30000, "AAPL"_sym, depth, Side::Buy, Type::Limit, toPrice(150.00, TWO_DIGITS_PRICE_SPEC)));
+
+    ASSERT_EQ(capturedFills.size(), 2 * depth);
+    for (int i = 0; i < depth; ++i) {
+      EXPECT_EQ(capturedFills[2 * i].orderId_, 20000 + i);
+      EXPECT_EQ(capturedFills[2 * i + 1].orderId_, 30000);
+      EXPECT_EQ(capturedFills[2 * i + 1].otherOrderId_, 20000 + i);
+    }
+}
+
 TEST_F(OrderBookTest, SubmitNewOrder_ExactMatch_FillsCompletely) {
     // Arrange - Add sell orders totaling exactly 100 shares
     auto sellEvent1 = NewOrderEvent(
@@ -860,8 +901,8 @@ TEST_F(OrderBookTest, SubmitNewOrder_ExactMatch_FillsCompletely) {
     // Capture the fills to verify them
     ExecutionReportCollection capturedFills;
     EXPECT_CALL(*mockReportSink_, submitFills(testing::_))
-        .WillOnce(testing::Invoke([&capturedFills](ExecutionReportCollection&& fills) {
-            capturedFills = std::move(fills);
+        .WillOnce(testing::Invoke([&capturedFills](ExecutionReportView fills) {
+            capturedFills.assign(fills.begin(), fills.end());
             return true;
         }));
 
@@ -920,8 +961,8 @@ TEST_F(OrderBookTest, SubmitNewOrder_CrossingSpread_FillsAtBestPrice) {
     // Capture the fills to verify them
     ExecutionReportCollection capturedFills;
     EXPECT_CALL(*mockReportSink_, submitFills(testing::_))
-        .WillOnce(testing::Invoke([&capturedFills](ExecutionReportCollection&& fills) {
-            capturedFills = std::move(fills);
+        .WillOnce(testing::Invoke([&capturedFills](ExecutionReportView fills) {
+            capturedFills.assign(fills.begin(), fills.end());
             return true;
         }));
 
@@ -987,6 +1028,94 @@ TEST_F(OrderBookTest, SubmitCancelOrder_NonExistentOrder_ReturnsFalse) {
     EXPECT_FALSE(cancelResult);
 }
 
+TEST_F(OrderBookTest, SubmitNewOrder_RestingOrders_GetDenseExchangeIds) {
+    std::vector<OrderAcceptedReport> accepted;
+    EXPECT_CALL(*mockReportSink_, submitAcceptedOrder(testing::_))
+        .Times(3)
+        .WillRepeatedly(testing::Invoke([&accepted](OrderAcceptedReport&& report) {
+            accepted.push_back(report);
+            return true;
+        }));
+
+    orderBook_->submitNewOrder(NewOrderEvent("user123"_uid, 7001, "AAPL"_sym, 100, Side::Buy, Type::Limit, toPrice(150.00, TWO_DIGITS_PRICE_SPEC)));
+    orderBook_->submitNewOrder(NewOrderEvent("user456"_uid, 7001, "AAPL"_sym, 50, Side::Sell, Type::Limit, toPrice(151.00, TWO_DIGITS_PRICE_SPEC)));
+    orderBook_->submitNewOrder(NewOrderEvent("user123"_uid, 7002, "AAPL"_sym, 10, Side::Buy, Type::Limit, toPrice(149.00, TWO_DIGITS_PRICE_SPEC)));
+
+    ASSERT_EQ(accepted.size(), 3);
+    for (size_t i = 0; i < accepted.size(); ++i) {
+      EXPECT_EQ(accepted[i].exchangeOrderId_, i + 1);
+      EXPECT_EQ(accepted[i].symbol_, "AAPL"_sym);
+    }
+    EXPECT_EQ(accepted[1].clientOrderId_, 7001);
+    EXPECT_EQ(accepted[1].openQuantity_, 50);
+    EXPECT_EQ(accepted[1].price_, toPrice(151.00, TWO_DIGITS_PRICE_SPEC));
+
+    // cancels go by the exchange id, from either side, and only work once
+    OrderCanceledReport capturedCancel;
+    EXPECT_CALL(*mockReportSink_, submitCanceledOrder(testing::_))
+        .Times(2)
+        .WillRepeatedly(testing::Invoke([&capturedCancel](OrderCanceledReport&& report) {
+            capturedCancel = std::move(report);
+            return true;
+        }));
+
+    EXPECT_TRUE(orderBook_->submitCancelOrder(CancelOrderEvent("user456"_uid, 7003, "AAPL"_sym, 2)));
+    EXPECT_EQ(capturedCancel.orderId_, 7001);
+    EXPECT_EQ(capturedCancel.remainingQuantity_, 50);
+
+    EXPECT_TRUE(orderBook_->submitCancelOrder(CancelOrderEvent("user123"_uid, 7004, "AAPL"_sym, 3)));
+    EXPECT_EQ(capturedCancel.orderId_, 7002);
+
+    EXPECT_FALSE(orderBook_->submitCancelOrder(CancelOrderEvent("user123"_uid, 7005, "AAPL"_sym, 3)));
+    EXPECT_FALSE(orderBook_->submitCancelOrder(CancelOrderEvent("user123"_uid, 7006, "AAPL"_sym, 7001)));
+}
+
+TEST_F(OrderBookTest, SubmitCancelOrder_FilledOrder_ReturnsFalse) {
+    orderBook_->submitNewOrder(NewOrderEvent("user123"_uid, 8001, "AAPL"_sym, 100, Side::Sell, Type::Limit, toPrice(150.00, TWO_DIGITS_PRICE_SPEC)));
+
+    EXPECT_CALL(*mockReportSink_, submitFills(testing::_)).WillOnce(testing::Return(true));
+    orderBook_->submitNewOrder(NewOrderEvent("user456"_uid, 8002, "AAPL"_sym, 100, Side::Buy, Type::Limit, toPrice(150.00, TWO_DIGITS_PRICE_SPEC)));
+
+    EXPECT_CALL(*mockReportSink_, submitCanceledOrder(testing::_)).Times(0);
+    EXPECT_FALSE(orderBook_->submitCancelOrder(CancelOrderEvent("user123"_uid, 8003, "AAPL"_sym, 1)));
+}
+
+TEST_F(OrderBookTest, SubmitBatch_FillsHandedOffOnce_BeforeOtherReports) {
+    for (int i = 0; i < 3; ++i) {
+      orderBook_->submitNewOrder(NewOrderEvent("user1"_uid, 9001 + i, "AAPL"_sym, 10, Side::Sell, Type::Limit, toPrice(150.00 + i * 0.01, TWO_DIGITS_PRICE_SPEC)));
+    }
+
+    std::vector<Event> batch;
+    batch.emplace_back(std::in_place_type<NewOrderEvent>, "user2"_uid, 9101, "AAPL"_sym, 10, Side::Buy, Type::Limit, toPrice(150.00, TWO_DIGITS_PRICE_SPEC));
+    batch.emplace_back(std::in_place_type<NewOrderEvent>, "user2"_uid, 9102, "AAPL"_sym, 10, Side::Buy, Type::Limit, toPrice(150.01, TWO_DIGITS_PRICE_SPEC));
+    batch.emplace_back(std::in_place_type<CancelOrderEvent>, "user2"_uid, 9103, "AAPL"_sym, 99);
+    batch.emplace_back(std::in_place_type<TopOfBookEvent>, "user2"_uid, 9104, "AAPL"_sym);
+
+    ExecutionReportCollection capturedFills;
+    TopOfBookReport capturedTopOfBook;
+    {
+      testing::InSequence seq;
+      EXPECT_CALL(*mockReportSink_, submitFills(testing::_))
+          .WillOnce(testing::Invoke([&capturedFills](ExecutionReportView fills) {
+              capturedFills.assign(fills.begin(), fills.end());
+              return true;
+          }));
+      EXPECT_CALL(*mockReportSink_, submitTopOfBook(testing::_))
+          .WillOnce(testing::Invoke([&capturedTopOfBook](TopOfBookReport&& report) {
+              capturedTopOfBook = std::move(report);
+              return true;
+          }));
+    }
+
+    // the cancel is for an order that doesn't exist
+    EXPECT_EQ(orderBook_->submitBatch(batch), 3);
+
+    ASSERT_EQ(capturedFills.size(), 4);
+    EXPECT_EQ(capturedFills[0].orderId_, 9001);
+    EXPECT_EQ(capturedFills[2].orderId_, 9002);
+    EXPECT_EQ(capturedTopOfBook.ask_.orderCount_, 1u);
+}
+
 TEST_F(OrderBookTest, SubmitTopOfBook_WithBothBidAndAsk_ShowsCorrectOrders) {
     // Arrange - Add both buy and sell orders
     auto buyEvent = NewOrderEvent(
@@ -1025,16 +1154,16 @@ TEST_F(OrderBookTest, SubmitTopOfBook_WithBothBidAndAsk_ShowsCorrectOrders) {
 
     // Assert - Verify top of book shows both best bid and best ask
     // Best bid (highest buy price)
-    EXPECT_EQ(capturedTopOfBook.bid_order_.orderId_, 9001);
-    EXPECT_EQ(capturedTopOfBook.bid_order_.openQuantity_, 100);
-    EXPECT_EQ(capturedTopOfBook.bid_order_.openQuantity_, 100);  // No fills yet
-    EXPECT_EQ(capturedTopOfBook.bid_order_.price_, toPrice(150.00, TWO_DIGITS_PRICE_SPEC));
+    EXPECT_EQ(capturedTopOfBook.bid_.orderCount_, 1u);
+    EXPECT_EQ(capturedTopOfBook.bid_.quantity_, 100);
+    EXPECT_EQ(capturedTopOfBook.bid_.quantity_, 100);  // No fills yet
+    EXPECT_EQ(capturedTopOfBook.bid_.price_, toPrice(150.00, TWO_DIGITS_PRICE_SPEC));
     
     // Best ask (lowest sell price)
-    EXPECT_EQ(capturedTopOfBook.ask_order_.orderId_, 9002);
-    EXPECT_EQ(capturedTopOfBook.ask_order_.openQuantity_, 75);
-    EXPECT_EQ(capturedTopOfBook.ask_order_.openQuantity_, 75);  // No fills yet
-    EXPECT_EQ(capturedTopOfBook.ask_order_.price_, toPrice(151.00, TWO_DIGITS_PRICE_SPEC));
+    EXPECT_EQ(capturedTopOfBook.ask_.orderCount_, 1u);
+    EXPECT_EQ(capturedTopOfBook.ask_.quantity_, 75);
+    EXPECT_EQ(capturedTopOfBook.ask_.quantity_, 75);  // No fills yet
+    EXPECT_EQ(capturedTopOfBook.ask_.price_, toPrice(151.00, TWO_DIGITS_PRICE_SPEC));
 }
 
 TEST_F(OrderBookTest, SubmitTopOfBook_EmptyBook_ReturnsInvalidOrders) {
@@ -1052,8 +1181,132 @@ TEST_F(OrderBookTest, SubmitTopOfBook_EmptyBook_ReturnsInvalidOrders) {
     orderBook_->submitTopOfBook(topOfBookEvent);
 
     // Assert - Verify both bid and ask orders are invalid (default Order objects)
-    EXPECT_FALSE(capturedTopOfBook.bid_order_.isValid());
-    EXPECT_FALSE(capturedTopOfBook.ask_order_.isValid());
+    EXPECT_FALSE(capturedTopOfBook.bid_.isValid());
+    EXPECT_FALSE(capturedTopOfBook.ask_.isValid());
+}
+
+TEST_F(OrderBookTest, TopOfBook_TracksBestLevelThroughInsertFillAndCancel) {
+    auto buy = [](OrderId id, Quantity quantity, double price) {
+      return NewOrderEvent("user123"_uid, id, "AAPL"_sym, quantity, Side::Buy, Type::Limit, toPrice(price, TWO_DIGITS_PRICE_SPEC));
+    };
+    orderBook_->submitNewOrder(buy(1, 100, 150.00));   // exchange id 1
+    orderBook_->submitNewOrder(buy(2, 50, 150.00));    // exchange id 2
+    orderBook_->submitNewOrder(buy(3, 70, 149.99));    // exchange id 3
+    orderBook_->submitNewOrder(buy(4, 10, 149.99));    // exchange id 4
+
+    auto tob = orderBook_->topOfBook();
+    EXPECT_EQ(tob.bid_, (PriceLevel{toPrice(150.00, TWO_DIGITS_PRICE_SPEC), 150, 2}));
+    EXPECT_FALSE(tob.ask_.isValid());
+
+    // cancel below the top doesn't touch it
+    EXPECT_TRUE(orderBook_->submitCancelOrder(CancelOrderEvent("user123"_uid, 5, "AAPL"_sym, 4)));
+    EXPECT_EQ(orderBook_->topOfBook().bid_, (PriceLevel{toPrice(150.00, TWO_DIGITS_PRICE_SPEC), 150, 2}));
+
+    // partial fill of the first order, then the rest of the level goes
+    orderBook_->submitNewOrder(NewOrderEvent("user456"_uid, 6, "AAPL"_sym, 30, Side::Sell, Type::Market, MARKET_PRICE));
+    EXPECT_EQ(orderBook_->topOfBook().bid_, (PriceLevel{toPrice(150.00, TWO_DIGITS_PRICE_SPEC), 120, 2}));
+
+    EXPECT_TRUE(orderBook_->submitCancelOrder(CancelOrderEvent("user123"_uid, 7, "AAPL"_sym, 2)));
+    EXPECT_EQ(orderBook_->topOfBook().bid_, (PriceLevel{toPrice(150.00, TWO_DIGITS_PRICE_SPEC), 70, 1}));
+
+    orderBook_->submitNewOrder(NewOrderEvent("user456"_uid, 8, "AAPL"_sym, 80, Side::Sell, Type::Market, MARKET_PRICE));
+    EXPECT_EQ(orderBook_->topOfBook().bid_, (PriceLevel{toPrice(149.99, TWO_DIGITS_PRICE_SPEC), 60, 1}));
+}
+
+TEST_F(OrderBookTest, SubmitDepth_AggregatesLevelsBestFirst) {
+    auto order = [](OrderId id, Side side, Quantity quantity, double price) {
+      return NewOrderEvent("user123"_uid, id, "AAPL"_sym, quantity, side, Type::Limit, toPrice(price, TWO_DIGITS_PRICE_SPEC));
+    };
+    orderBook_->submitNewOrder(order(1, Side::Buy, 100, 150.00));
+    orderBook_->submitNewOrder(order(2, Side::Buy, 50, 149.00));
+    orderBook_->submitNewOrder(order(3, Side::Buy, 25, 150.00));
+    orderBook_->submitNewOrder(order(4, Side::Buy, 10, 148.00));
+    orderBook_->submitNewOrder(order(5, Side::Sell, 30, 151.00));
+    orderBook_->submitNewOrder(order(6, Side::Sell, 20, 152.00));
+    orderBook_->submitCancelOrder(CancelOrderEvent("user123"_uid, 7, "AAPL"_sym, 6));   // 152.00 level gone
+
+    DepthReport captured;
+    EXPECT_CALL(*mockReportSink_, submitDepth(testing::_))
+        .WillOnce(testing::Invoke([&captured](DepthReport&& report) {
+            captured = std::move(report);
+            return true;
+        }));
+    orderBook_->submitDepth(DepthEvent("user123"_uid, 8, "AAPL"_sym, 2));
+
+    EXPECT_EQ(captured.symbol_, "AAPL"_sym);
+    ASSERT_EQ(captured.bids().size(), 2u);
+    EXPECT_EQ(captured.bids()[0], (PriceLevel{toPrice(150.00, TWO_DIGITS_PRICE_SPEC), 125, 2}));
+    EXPECT_EQ(captured.bids()[1], (PriceLevel{toPrice(149.00, TWO_DIGITS_PRICE_SPEC), 50, 1}));
+    ASSERT_EQ(captured.asks().size(), 1u);
+    EXPECT_EQ(captured.asks()[0], (PriceLevel{toPrice(151.00, TWO_DIGITS_PRICE_SPEC), 30, 1}));
+
+    // sweep the whole top bid level and part of the next one
+    orderBook_->submitNewOrder(NewOrderEvent("user456"_uid, 9, "AAPL"_sym, 135, Side::Sell, Type::Market, MARKET_PRICE));
+    auto depth = orderBook_->depth();
+    ASSERT_EQ(depth.bids().size(), 2u);
+    EXPECT_EQ(depth.bids()[0], (PriceLevel{toPrice(149.00, TWO_DIGITS_PRICE_SPEC), 40, 1}));
+    EXPECT_EQ(depth.bids()[1], (PriceLevel{toPrice(148.00, TWO_DIGITS_PRICE_SPEC), 10, 1}));
+    EXPECT_EQ(orderBook_->topOfBook().bid_, depth.bids()[0]);
+}
+
+TEST_F(OrderBookTest, PublishTopOfBook_OnlyWhenTopChanges) {
+    orderBook_->setPublishTopOfBook(true);
+
+    std::vector<TopOfBookReport> published;
+    EXPECT_CALL(*mockReportSink_, submitTopOfBook(testing::_))
+        .Times(3)
+        .WillRepeatedly(testing::Invoke([&published](TopOfBookReport&& report) {
+            published.push_back(report);
+            return true;
+        }));
+
+    auto order = [](OrderId id, Side side, Quantity quantity, double price) {
+      return NewOrderEvent("user123"_uid, id, "AAPL"_sym, quantity, side, Type::Limit, toPrice(price, TWO_DIGITS_PRICE_SPEC));
+    };
+    orderBook_->submitNewOrder(order(1, Side::Buy, 100, 150.00));    // new best bid
+    orderBook_->submitNewOrder(order(2, Side::Buy, 100, 149.00));    // behind the top, nothing
+    orderBook_->submitNewOrder(order(3, Side::Sell, 40, 151.00));    // new best ask
+    orderBook_->submitCancelOrder(CancelOrderEvent("user123"_uid, 4, "AAPL"_sym, 2));   // behind the top, nothing
+    orderBook_->submitNewOrder(order(5, Side::Buy, 25, 148.00));     // nothing
+    orderBook_->submitCancelOrder(CancelOrderEvent("user123"_uid, 6, "AAPL"_sym, 3));   // ask side gone
+
+    ASSERT_EQ(published.size(), 3);
+    EXPECT_EQ(published[0].bid_.quantity_, 100);
+    EXPECT_FALSE(published[0].ask_.isValid());
+    EXPECT_EQ(published[1].ask_, (PriceLevel{toPrice(151.00, TWO_DIGITS_PRICE_SPEC), 40, 1}));
+    EXPECT_FALSE(published[2].ask_.isValid());
+    EXPECT_EQ(published[2].bid_.price_, toPrice(150.00, TWO_DIGITS_PRICE_SPEC));
+}
+
+// keeps everything the book publishes
+struct RecordingFeed {
+    bool submitDelta(const BookDelta& delta) { deltas.push_back(delta); return true; }
+    std::vector<BookDelta> deltas;
+};
+
+TEST(OrderBookFeedTest, EveryBookChange_PublishesADelta) {
+    auto sink = std::make_unique<testing::NiceMock<MockReportSink>>();
+    auto feed = std::make_unique<RecordingFeed>();
+    auto* deltas = &feed->deltas;
+    OrderBook<testing::NiceMock<MockReportSink>, RecordingFeed> book(Symbol{"AAPL"}, std::move(sink), std::move(feed));
+
+    const auto price = toPrice(150.00, TWO_DIGITS_PRICE_SPEC);
+    book.submitNewOrder(NewOrderEvent("maker"_uid, 1, "AAPL"_sym, 100, Side::Sell, Type::Limit, price));     // exchange id 1
+    book.submitNewOrder(NewOrderEvent("maker"_uid, 2, "AAPL"_sym, 50, Side::Sell, Type::Limit, price));      // exchange id 2
+    book.submitNewOrder(NewOrderEvent("taker"_uid, 3, "AAPL"_sym, 120, Side::Buy, Type::Market, MARKET_PRICE));
+    book.submitCancelOrder(CancelOrderEvent("maker"_uid, 4, "AAPL"_sym, 2));
+    book.submitCancelOrder(CancelOrderEvent("maker"_uid, 5, "AAPL"_sym, 2));      // already gone, nothing published
+    book.submitTopOfBook(TopOfBookEvent("maker"_uid, 6, "AAPL"_sym));             // no change, nothing published
+
+    using Action = BookDelta::Action;
+    const std::vector<BookDelta> expected {
+      {1, 1, price, "AAPL"_sym, 100, Side::Sell, Action::Add},
+      {2, 2, price, "AAPL"_sym, 50, Side::Sell, Action::Add},
+      {3, 1, price, "AAPL"_sym, 100, Side::Sell, Action::Execute},
+      {4, 2, price, "AAPL"_sym, 20, Side::Sell, Action::Execute},
+      {5, 2, price, "AAPL"_sym, 30, Side::Sell, Action::Delete},
+    };
+    EXPECT_EQ(*deltas, expected);
 }
 
 } // namespace test
@@ -0,0 +1,38 @@
+#include <gtest/gtest.h>
+#include "ReportSink.h"
+
+#include <string>
+
+namespace Exchange {
+namespace test {
+
+TEST(ReportSinkTest, DepthComesOutInOrderWithTheRest) {
+    SymbolRegistry symbols {"AAPL"};
+    DepthReport depth;
+    depth.symbol_ = "AAPL"_sym;
+    depth.bidCount_ = 1;
+    depth.bids_[0] = PriceLevel{Price{14999}, 7, 1};
+
+    testing::internal::CaptureStdout();
+    {
+      ReportSink sink {symbols};
+      sink.beginBatch();
+      EXPECT_TRUE(sink.submitAcceptedOrder(OrderAcceptedReport{"AAPL"_sym, 1, 1, 10, Price{15000}}));
+      EXPECT_TRUE(sink.submitDepth(DepthReport{depth}));
+      EXPECT_TRUE(sink.submitCanceledOrder(OrderCanceledReport{"AAPL"_sym, 1, 10, CancelReason::User_Canceled}));
+      sink.endBatch();
+    }   // drains on the way out
+    const auto output = testing::internal::GetCapturedStdout();
+
+    const auto accepted = output.find("150.00");
+    const auto bid = output.find("149.99");
+    const auto canceled = output.find("User_Canceled");
+    ASSERT_NE(accepted, std::string::npos) << output;
+    ASSERT_NE(bid, std::string::npos) << output;
+    ASSERT_NE(canceled, std::string::npos) << output;
+    EXPECT_LT(accepted, bid);
+    EXPECT_LT(bid, canceled);
+}
+
+} // namespace test
+} // namespace Exchange
@@ -0,0 +1,58 @@
+#include <gtest/gtest.h>
+#include "SymbolRegistry.h"
+
+namespace Exchange {
+namespace test {
+
+TEST(SymbolRegistryTest, IdsAreDenseInGivenOrder) {
+    SymbolRegistry symbols {"AAPL", "MSFT", "AAPL", "NVDA"};
+
+    EXPECT_EQ(symbols.size(), 3u);
+    EXPECT_EQ(symbols.find("AAPL"_sym), 1u);
+    EXPECT_EQ(symbols.find("MSFT"_sym), 2u);
+    EXPECT_EQ(symbols.find("NVDA"_sym), 3u);
+
+    for (SymbolId id = 1; id <= symbols.size(); ++id) {
+        EXPECT_EQ(symbols.find(symbols.symbol(id)), id);
+        EXPECT_EQ(symbols.symbols()[id - 1], symbols.symbol(id));
+    }
+}
+
+TEST(SymbolRegistryTest, UnknownSymbolAndHandle_AreInvalid) {
+    SymbolRegistry symbols {"AAPL"};
+
+    EXPECT_EQ(symbols.find("GOOGL"_sym), INVALID_SYMBOL_ID);
+    EXPECT_EQ(symbols.find(INVALID_SYMBOL), INVALID_SYMBOL_ID);
+    EXPECT_EQ(symbols.symbol(INVALID_SYMBOL_ID), INVALID_SYMBOL);
+    EXPECT_EQ(symbols.symbol(2), INVALID_SYMBOL);
+}
+
+TEST(SymbolRegistryTest, PriceSpecPerSymbol) {
+    SymbolRegistry symbols {{"AAPL"}, {"EURUSD", PriceSpec{100000, 1}}, {"BTCUSD", PriceSpec{100000000, 1}}};
+
+    EXPECT_EQ(symbols.priceSpec("AAPL"_sym).scale, 100);
+    EXPECT_EQ(symbols.priceSpec("EURUSD"_sym).scale, 100000);
+    EXPECT_EQ(symbols.priceSpec(symbols.find("BTCUSD"_sym)).scale, 100000000);
+    EXPECT_EQ(symbols.priceSpec(INVALID_SYMBOL_ID).scale, DEFAULT_PRICE_SPEC.scale);
+    EXPECT_EQ(symbols.priceSpec("GOOGL"_sym).scale, DEFAULT_PRICE_SPEC.scale);
+}
+
+TEST(SymbolRegistryTest, ReferencePricePerSymbol) {
+    SymbolRegistry symbols {{"AAPL", TWO_DIGITS_PRICE_SPEC, Price{15000}}, {"EURUSD", PriceSpec{100000, 1}, Price{108000}}, {"MSFT"}};
+
+    EXPECT_EQ(symbols.referencePrice(symbols.find("AAPL"_sym)), Price{15000});
+    EXPECT_EQ(symbols.referencePrice(symbols.find("EURUSD"_sym)), Price{108000});
+    EXPECT_EQ(symbols.referencePrice(symbols.find("MSFT"_sym)), Price{0});
+    EXPECT_EQ(symbols.referencePrice(INVALID_SYMBOL_ID), Price{0});
+}
+
+TEST(SymbolRegistryTest, Global_HasTheDefaultSymbols) {
+    const auto& symbols = SymbolRegistry::global();
+
+    EXPECT_EQ(symbols.size(), 6u);
+    EXPECT_NE(symbols.find("AAPL"_sym), INVALID_SYMBOL_ID);
+    EXPECT_NE(symbols.find("NVDA"_sym), INVALID_SYMBOL_ID);
+}
+
+} // namespace test
+} // namespace Exchange
@@ -0,0 +1,65 @@
+#include <gtest/gtest.h>
+#include "TokenTable.h"
+#include "Event.h"
+
+namespace Exchange {
+namespace test {
+
+namespace {
+  enum class Color { Red, Green, Blue, Invalid };
+
+  constexpr TokenTable<Color, 4> COLORS {{
+    {"RED", Color::Red}, {"GREEN", Color::Green}, {"BLUE", Color::Blue}, {"12345678", Color::Red},
+  }, Color::Invalid};
+
+  // all of it works at compile time
+  static_assert(COLORS.decode("red") == Color::Red);
+  static_assert(COLORS.decode(" Green\r\n") == Color::Green);
+  static_assert(COLORS.decode("BLU") == Color::Invalid);
+  static_assert(COLORS.decode("123456789") == Color::Invalid);
+}
+
+TEST(TokenTableTest, Decode_FoldsCaseAndTrims) {
+    EXPECT_EQ(COLORS.decode("RED"), Color::Red);
+    EXPECT_EQ(COLORS.decode("rEd"), Color::Red);
+    EXPECT_EQ(COLORS("\tblue "), Color::Blue);
+    EXPECT_EQ(COLORS.decode("12345678"), Color::Red);
+}
+
+TEST(TokenTableTest, Decode_NoPartialOrNearMatches) {
+    for (std::string_view token : {"", "   ", "R", "RE", "REDD", "RED1", "GREEN ISH", "1234567", "123456789",
+                                   "red,", "r e d", "[ED", "{ed"}) {
+        SCOPED_TRACE(token);
+        EXPECT_EQ(COLORS.decode(token), Color::Invalid);
+    }
+    // an embedded NUL isn't the end of the token
+    EXPECT_EQ(COLORS.decode(std::string_view("RED\0", 4)), Color::Invalid);
+    EXPECT_EQ(COLORS.decode(std::string_view("\0RED", 4)), Color::Invalid);
+}
+
+TEST(TokenTableTest, Pack_CaseFolded) {
+    using Table = TokenTable<Color, 4>;
+    EXPECT_EQ(Table::pack("ab"), Table::pack("AB"));
+    EXPECT_NE(Table::pack("AB"), Table::pack("BA"));
+    EXPECT_EQ(Table::pack(""), 0u);
+    EXPECT_EQ(Table::pack("123456789"), 0u);
+}
+
+TEST(TokenTableTest, EnumDecoders) {
+    for (auto [token, side] : {std::pair{"BUY", Side::Buy}, {"buy", Side::Buy}, {"1", Side::Buy}, {" Sell ", Side::Sell},
+                               {"2", Side::Sell}, {"3", Side::Invalid}, {"BU", Side::Invalid}, {"", Side::Invalid}}) {
+        EXPECT_EQ(toSide(token), side) << token;
+    }
+    for (auto [token, type] : {std::pair{"MARKET", Type::Market}, {"market", Type::Market}, {"1", Type::Market},
+                               {"Limit", Type::Limit}, {"2", Type::Limit}, {"STOP", Type::Invalid}, {"LIMITED", Type::Invalid}}) {
+        EXPECT_EQ(toType(token), type) << token;
+    }
+    for (auto [token, eventType] : {std::pair{"D", EventType::NewOrder}, {"f", EventType::CancelOrder}, {" V ", EventType::TopOfBook},
+                                    {"w", EventType::Depth}, {"q", EventType::Quit}, {"Quit", EventType::Quit},
+                                    {"QUITS", EventType::Invalid}, {"DD", EventType::Invalid}, {"X", EventType::Invalid}}) {
+        EXPECT_EQ(toEventType(token), eventType) << token;
+    }
+}
+
+} // namespace test
+} // namespace Exchange
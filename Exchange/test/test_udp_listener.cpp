@@ -0,0 +1,279 @@
+#include <gtest/gtest.h>
+#include "UDPListener.h"
+#include "SocketUtils.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace Exchange {
+namespace test {
+
+namespace {
+  // what the listener thread handed over, and in how many calls
+  class Recorder {
+  public:
+    // the views don't outlive the call, keep copies
+    void add(EventQueue::MessageBatch batch) {
+      std::lock_guard lock(mutex_);
+      messages_.insert(messages_.end(), batch.begin(), batch.end());
+      ++calls_;
+    }
+
+    void add(std::string_view message) { add(EventQueue::MessageBatch(&message, 1)); }
+
+    std::vector<std::string> messages() const {
+      std::lock_guard lock(mutex_);
+      return messages_;
+    }
+
+    std::size_t calls() const {
+      std::lock_guard lock(mutex_);
+      return calls_;
+    }
+
+    // the listener runs on its own thread, give it a moment
+    void waitFor(std::size_t expected) const {
+      const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+      while (messages().size() < expected && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+      }
+    }
+
+  private:
+    mutable std::mutex mutex_;
+    std::vector<std::string> messages_;
+    std::size_t calls_ {0};
+  };
+
+  const std::vector<std::string> MESSAGES {"ONE", "TWO", "THREE", "FOUR", "FIVE"};
+}
+
+TEST(UDPListenerTest, PortZero_PicksAFreePort) {
+    UDPListener listener(0);
+    EXPECT_GT(listener.port(), 0);
+}
+
+TEST(UDPListenerTest, SubscribeBatch_GetsEveryDatagramInOrder) {
+    UDPListener listener(0, 64, 8);
+    Recorder recorder;
+    auto subscription = listener.subscribeBatch([&recorder](EventQueue::MessageBatch batch) { recorder.add(batch); });
+
+    for (const auto& message : MESSAGES) {
+      ASSERT_TRUE(SocketUtils::sendUDPMessage(listener.port(), message));
+    }
+    recorder.waitFor(MESSAGES.size());
+
+    EXPECT_EQ(recorder.messages(), MESSAGES);
+    EXPECT_GE(recorder.calls(), 1u);
+    EXPECT_LE(recorder.calls(), MESSAGES.size());
+
+    const auto stats = listener.stats();
+    EXPECT_EQ(stats.datagrams_, MESSAGES.size());
+    EXPECT_EQ(stats.receiveCalls_, recorder.calls());
+    EXPECT_GE(stats.datagramsPerCall(), 1.0);
+}
+
+TEST(UDPListenerTest, Subscribe_GetsOneCallPerDatagram) {
+    UDPListener listener(0, 64, 8);
+    Recorder recorder;
+    auto subscription = listener.subscribe([&recorder](const std::string& message) { recorder.add(message); });
+
+    for (const auto& message : MESSAGES) {
+      ASSERT_TRUE(SocketUtils::sendUDPMessage(listener.port(), message));
+    }
+    recorder.waitFor(MESSAGES.size());
+
+    EXPECT_EQ(recorder.messages(), MESSAGES);
+    EXPECT_EQ(recorder.calls(), MESSAGES.size());
+}
+
+TEST(UDPListenerTest, SubscribeView_PointsIntoTheReceiveBuffer) {
+    UDPListener listener(0, 64, 8);
+    Recorder recorder;
+    std::mutex mutex;
+    std::vector<const char*> addresses;
+    auto subscription = listener.subscribeView([&](std::string_view message) {
+      {
+        std::lock_guard lock(mutex);
+        addresses.push_back(message.data());
+      }
+      recorder.add(message);
+    });
+
+    for (const auto& message : MESSAGES) {
+      ASSERT_TRUE(SocketUtils::sendUDPMessage(listener.port(), message));
+    }
+    recorder.waitFor(MESSAGES.size());
+
+    EXPECT_EQ(recorder.messages(), MESSAGES);
+    std::lock_guard lock(mutex);
+    ASSERT_EQ(addresses.size(), MESSAGES.size());
+    // every view starts at one of the 8 fixed 64 byte slots
+    for (auto address : addresses) {
+      EXPECT_EQ((address - addresses.front()) % 64, 0);
+      EXPECT_LT(std::abs(address - addresses.front()), 8 * 64);
+    }
+}
+
+TEST(UDPListenerTest, SubscribeWith_TakesViewsOrStrings) {
+    struct Subscriber {
+      void onView(std::string_view message) { views_.add(message); }
+      void onString(const std::string& message) { strings_.add(message); }
+      Recorder views_;
+      Recorder strings_;
+    } subscriber;
+
+    UDPListener listener(0, 64, 8);
+    auto viewSubscription = listener.subscribeWith(&Subscriber::onView, &subscriber);
+    auto stringSubscription = listener.subscribeWith(&Subscriber::onString, &subscriber);
+
+    ASSERT_TRUE(SocketUtils::sendUDPMessage(listener.port(), "ONE"));
+    subscriber.views_.waitFor(1);
+    subscriber.strings_.waitFor(1);
+
+    EXPECT_EQ(subscriber.views_.messages(), std::vector<std::string>{"ONE"});
+    EXPECT_EQ(subscriber.strings_.messages(), std::vector<std::string>{"ONE"});
+}
+
+TEST(UDPListenerTest, ReceiveBatchOfOne_OneDatagramPerCall) {
+    UDPListener listener(0, 64, 1);
+    Recorder recorder;
+    auto subscription = listener.subscribeBatch([&recorder](EventQueue::MessageBatch batch) { recorder.add(batch); });
+
+    for (const auto& message : MESSAGES) {
+      ASSERT_TRUE(SocketUtils::sendUDPMessage(listener.port(), message));
+    }
+    recorder.waitFor(MESSAGES.size());
+
+    EXPECT_EQ(recorder.messages(), MESSAGES);
+    EXPECT_EQ(recorder.calls(), MESSAGES.size());
+    EXPECT_DOUBLE_EQ(listener.stats().datagramsPerCall(), 1.0);
+}
+
+TEST(UDPListenerTest, LongDatagram_CutAtMaxSize) {
+    UDPListener listener(0, 4, 8);
+    Recorder recorder;
+    auto subscription = listener.subscribeBatch([&recorder](EventQueue::MessageBatch batch) { recorder.add(batch); });
+
+    ASSERT_TRUE(SocketUtils::sendUDPMessage(listener.port(), "ABCDEFGH"));
+    recorder.waitFor(1);
+
+    EXPECT_EQ(recorder.messages(), std::vector<std::string>{"ABCD"});
+}
+
+TEST(UDPListenerTest, Unsubscribe_StopsDelivery) {
+    UDPListener listener(0, 64, 8);
+    Recorder recorder;
+    Recorder other;
+    auto subscription = listener.subscribeBatch([&recorder](EventQueue::MessageBatch batch) { recorder.add(batch); });
+    auto otherSubscription = listener.subscribeBatch([&other](EventQueue::MessageBatch batch) { other.add(batch); });
+
+    ASSERT_TRUE(SocketUtils::sendUDPMessage(listener.port(), "ONE"));
+    recorder.waitFor(1);
+    other.waitFor(1);
+    subscription.reset();
+
+    ASSERT_TRUE(SocketUtils::sendUDPMessage(listener.port(), "TWO"));
+    other.waitFor(2);
+
+    EXPECT_EQ(recorder.messages(), std::vector<std::string>{"ONE"});
+    EXPECT_EQ(other.messages(), (std::vector<std::string>{"ONE", "TWO"}));
+}
+
+TEST(UDPListenerTest, UnsubscribeFromCallback_DoesNotDeadlock) {
+    UDPListener listener(0, 64, 8);
+    Recorder recorder;
+    std::unique_ptr<SubscriptionHandle> subscription;
+    std::mutex mutex;
+    auto once = listener.subscribeBatch([&](EventQueue::MessageBatch batch) {
+      recorder.add(batch);
+      std::lock_guard lock(mutex);
+      subscription.reset();
+    });
+    {
+      std::lock_guard lock(mutex);
+      subscription = std::move(once);
+    }
+
+    ASSERT_TRUE(SocketUtils::sendUDPMessage(listener.port(), "ONE"));
+    recorder.waitFor(1);
+    ASSERT_TRUE(SocketUtils::sendUDPMessage(listener.port(), "TWO"));
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+
+    EXPECT_EQ(recorder.messages(), std::vector<std::string>{"ONE"});
+    std::lock_guard lock(mutex);
+    EXPECT_EQ(subscription, nullptr);
+}
+
+TEST(UDPListenerTest, Unsubscribe_WhileReceiving_NoCallbackAfterItReturns) {
+    UDPListener listener(0, 64, 8);
+    std::atomic<bool> sending {true};
+    std::thread sender([&] {
+      while (sending.load()) {
+        SocketUtils::sendUDPMessage(listener.port(), "ONE");
+      }
+    });
+
+    std::atomic<int> lateCalls {0};
+    std::atomic<int> calls {0};
+    for (int i = 0; i < 200; ++i) {
+      auto alive = std::make_shared<std::atomic<bool>>(true);
+      auto subscription = listener.subscribeBatch([&, alive](EventQueue::MessageBatch) {
+        if (!alive->load()) {
+          ++lateCalls;
+        }
+        ++calls;
+      });
+      std::this_thread::yield();
+      subscription.reset();
+      alive->store(false);
+    }
+
+    sending.store(false);
+    sender.join();
+    EXPECT_EQ(lateCalls.load(), 0);
+    EXPECT_GT(calls.load(), 0);
+}
+
+TEST(UDPListenerTest, UnsubscribeWhileCallbackSubscribes_DoesNotDeadlock) {
+    UDPListener listener(0, 64, 8);
+    std::atomic<bool> sending {true};
+    std::thread sender([&] {
+      while (sending.load()) {
+        SocketUtils::sendUDPMessage(listener.port(), "ONE");
+      }
+    });
+
+    // every batch the callback adds a subscriber and drops it again, from the listener thread
+    std::atomic<int> calls {0};
+    auto churning = listener.subscribeBatch([&](EventQueue::MessageBatch) {
+      auto inner = listener.subscribeBatch([](EventQueue::MessageBatch) {});
+      inner.reset();
+      ++calls;
+    });
+
+    // while this thread does the same, each of these waits out a dispatch
+    for (int i = 0; i < 200; ++i) {
+      auto subscription = listener.subscribeBatch([](EventQueue::MessageBatch) {});
+      std::this_thread::yield();
+      subscription.reset();
+    }
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (calls.load() == 0 && std::chrono::steady_clock::now() < deadline) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    churning.reset();
+
+    sending.store(false);
+    sender.join();
+    EXPECT_GT(calls.load(), 0);
+}
+
+} // namespace test
+} // namespace Exchange
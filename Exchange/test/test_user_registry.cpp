@@ -0,0 +1,66 @@
+#include <gtest/gtest.h>
+#include "UserRegistry.h"
+
+namespace Exchange {
+namespace test {
+
+TEST(UserRegistryTest, Intern_SameNameSameHandle) {
+    UserRegistry users;
+
+    const auto alice = users.intern("alice");
+    const auto bob = users.intern("bob");
+
+    EXPECT_EQ(alice, 1u);
+    EXPECT_EQ(bob, 2u);
+    EXPECT_EQ(users.intern("alice"), alice);
+    EXPECT_EQ(users.size(), 2u);
+
+    EXPECT_EQ(users.name(alice), UserName("alice"));
+    EXPECT_EQ(users.name(bob), UserName("bob"));
+}
+
+TEST(UserRegistryTest, Name_UnknownHandle_IsInvalid) {
+    UserRegistry users;
+    users.intern("alice");
+
+    EXPECT_EQ(users.name(INVALID_USER_ID), INVALID_USER_NAME);
+    EXPECT_EQ(users.name(2), INVALID_USER_NAME);
+}
+
+TEST(UserRegistryTest, Intern_LongNamesCutToFit) {
+    UserRegistry users;
+    const std::string longName(64, 'x');
+
+    const auto id = users.intern(longName);
+    EXPECT_EQ(users.intern(longName.substr(0, UserName::capacity())), id);
+    EXPECT_EQ(users.name(id).size(), UserName::capacity());
+}
+
+TEST(UserRegistryTest, Intern_Full_RefusesNewNames) {
+    UserRegistry users {2};
+    const auto alice = users.intern("alice");
+    const auto bob = users.intern("bob");
+
+    EXPECT_EQ(users.intern("carol"), INVALID_USER_ID);
+    EXPECT_EQ(users.size(), 2u);
+    // the ones already in still resolve
+    EXPECT_EQ(users.intern("alice"), alice);
+    EXPECT_EQ(users.intern("bob"), bob);
+}
+
+TEST(UserRegistryTest, UidLiteral_PureAndNeverInterned) {
+    static_assert("alice"_uid == "alice"_uid);
+    static_assert("alice"_uid != "bob"_uid);
+    static_assert(("alice"_uid & LITERAL_USER_ID_BIT) != 0);
+
+    const auto before = UserRegistry::global().size();
+    const auto id = "somebody"_uid;
+    EXPECT_EQ(UserRegistry::global().size(), before);
+    EXPECT_EQ(UserRegistry::global().name(id), INVALID_USER_NAME);
+
+    UserRegistry users;
+    EXPECT_NE(users.intern("somebody"), id);
+}
+
+} // namespace test
+} // namespace Exchange